@@ -0,0 +1,138 @@
+// Encodes and decodes synthetic telemetry columns with GorillaCodec and
+// prints bits per value and throughput for each, next to the raw size.
+// Columns imitate what the store archives: a 1 Hz clock with occasional
+// jitter and dropouts, and channels from constant to noisy.
+//
+//   bench_gorilla [rows] [seconds per case]
+
+#include "GorillaCodec.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+#include <QtMath>
+#include <QtNumeric>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+#include <functional>
+
+namespace {
+
+QVector<qint64> clockColumn(int rows, QRandomGenerator& random)
+{
+    QVector<qint64> ts(rows);
+    qint64 t = 1780000000000LL;
+    for (int i = 0; i < rows; ++i) {
+        t += 1000;
+        if (random.bounded(100) == 0)
+            t += random.bounded(-40, 40);          // jitter
+        if (random.bounded(5000) == 0)
+            t += 1000LL * random.bounded(5, 600);  // link dropout
+        ts[i] = t;
+    }
+    return ts;
+}
+
+QVector<float> floatColumn(const char* kind, int rows, QRandomGenerator& random)
+{
+    QVector<float> v(rows);
+    double x = 0.0;
+    for (int i = 0; i < rows; ++i) {
+        if (!std::strcmp(kind, "constant")) {
+            x = 1.0;
+        } else if (!std::strcmp(kind, "slow drift")) {
+            // Temperature-like, 0.1 resolution
+            x += (random.bounded(21) - 10) * 0.001;
+            v[i] = float(qRound((350.0 + x) * 10.0) / 10.0);
+            continue;
+        } else if (!std::strcmp(kind, "steps")) {
+            // Tank level held between soundings
+            if (i % 600 == 0)
+                x = 60.0 - i / 3600.0 + random.bounded(100) * 0.01;
+        } else if (!std::strcmp(kind, "noisy")) {
+            // Fuel flow with full-precision sensor noise
+            x = 1180.0 + 25.0 * qSin(i / 900.0) + random.generateDouble() * 4.0;
+        } else if (!std::strcmp(kind, "with gaps")) {
+            x = 95.0 + random.bounded(3);
+            if ((i / 300) % 10 == 0) {
+                v[i] = std::numeric_limits<float>::quiet_NaN();
+                continue;
+            }
+        }
+        v[i] = float(x);
+    }
+    return v;
+}
+
+// Runs body for at least budgetMs and returns nanoseconds per call
+double timeLoop(const std::function<bool()>& body, qint64 budgetMs)
+{
+    body();
+    QElapsedTimer timer;
+    timer.start();
+    qint64 calls = 0;
+    while (timer.elapsed() < budgetMs) {
+        if (!body())
+            return 0;
+        ++calls;
+    }
+    return double(timer.nsecsElapsed()) / calls;
+}
+
+void report(const char* name, int rows, int rawBytes, int encodedBytes, double encodeNs, double decodeNs)
+{
+    std::printf("  %-12s %8.2f bits/value %6.1fx %9.1f M values/s encode %9.1f M values/s decode\n",
+                name, encodedBytes * 8.0 / rows, double(rawBytes) / encodedBytes,
+                encodeNs > 0 ? rows * 1000.0 / encodeNs : 0.0,
+                decodeNs > 0 ? rows * 1000.0 / decodeNs : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int rows = argc > 1 ? qMax(1, atoi(argv[1])) : 86400;
+    const qint64 budgetMs = argc > 2 ? qMax(1, atoi(argv[2])) * 1000 : 1000;
+    QRandomGenerator random(20261017);
+
+    std::printf("%d rows per column\n", rows);
+
+    const QVector<qint64> ts = clockColumn(rows, random);
+    const QByteArray encodedTs = GorillaCodec::encodeTimestamps(ts.constData(), rows);
+    QVector<qint64> decodedTs(rows);
+    if (!GorillaCodec::decodeTimestamps(encodedTs.constData(), encodedTs.size(), decodedTs.data(), rows)
+        || decodedTs != ts) {
+        std::fprintf(stderr, "timestamps: round trip mismatch\n");
+        return 1;
+    }
+    report("timestamps", rows, rows * 8, encodedTs.size(),
+           timeLoop([&]() { return !GorillaCodec::encodeTimestamps(ts.constData(), rows).isEmpty(); }, budgetMs),
+           timeLoop([&]() {
+               return GorillaCodec::decodeTimestamps(encodedTs.constData(), encodedTs.size(), decodedTs.data(), rows);
+           }, budgetMs));
+
+    const char *kinds[] = { "constant", "slow drift", "steps", "noisy", "with gaps" };
+    for (const char *kind : kinds) {
+        const QVector<float> values = floatColumn(kind, rows, random);
+        const QByteArray encoded = GorillaCodec::encodeFloats(values.constData(), rows);
+        QVector<float> decoded(rows);
+
+        // Bit-exact, NaNs included
+        if (!GorillaCodec::decodeFloats(encoded.constData(), encoded.size(), decoded.data(), rows)
+            || std::memcmp(decoded.constData(), values.constData(), size_t(rows) * 4) != 0) {
+            std::fprintf(stderr, "%s: round trip mismatch\n", kind);
+            return 1;
+        }
+
+        report(kind, rows, rows * 4, encoded.size(),
+               timeLoop([&]() { return !GorillaCodec::encodeFloats(values.constData(), rows).isEmpty(); }, budgetMs),
+               timeLoop([&]() {
+                   return GorillaCodec::decodeFloats(encoded.constData(), encoded.size(), decoded.data(), rows);
+               }, budgetMs));
+    }
+
+    return 0;
+}
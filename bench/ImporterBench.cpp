@@ -0,0 +1,125 @@
+// Writes a synthetic CSV export and imports it with TelemetryImporter into
+// an empty history, printing rows per second against the 1M rows/s target.
+// Each run imports into a fresh temporary store, so the timing includes
+// parsing, the store appends, rollups and DCS. Standard paths run in test
+// mode so the rollup and DCS files stay out of the real data directory.
+//
+//   bench_importer [rows] [runs]
+
+#include "TelemetryImporter.h"
+#include "TelemetryStore.h"
+#include "TelemetryFrame.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+const double kTargetRowsPerSecond = 1e6;
+
+// One column per vessel channel and per engine slot, like an export
+QStringList header()
+{
+    QStringList columns = { "timestamp" };
+    const TelemetryChannel vessel[] = { TelemetryChannel::Latitude, TelemetryChannel::Longitude,
+                                        TelemetryChannel::ShipSpeed, TelemetryChannel::Course,
+                                        TelemetryChannel::WindSpeed, TelemetryChannel::AirTemperature };
+    for (TelemetryChannel channel : vessel)
+        columns << telemetryChannelName(channel);
+    const TelemetryChannel engine[] = { TelemetryChannel::Rpm, TelemetryChannel::EngineLoad,
+                                        TelemetryChannel::FuelConsumptionRate };
+    for (int slot = 1; slot <= 2; ++slot) {
+        for (TelemetryChannel channel : engine)
+            columns << QString("%1_%2").arg(telemetryChannelName(channel)).arg(slot);
+    }
+    return columns;
+}
+
+bool writeCsv(const QString& path, int rows, QRandomGenerator& random)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    const QStringList columns = header();
+    file.write(columns.join(',').toUtf8());
+    file.write("\n");
+
+    QByteArray line;
+    qint64 t = 1780000000000LL;
+    for (int i = 0; i < rows; ++i) {
+        t += 1000;
+        line = QByteArray::number(t);
+        line += ',' + QByteArray::number(54.0 + i * 1e-6, 'f', 6);
+        line += ',' + QByteArray::number(10.0 + i * 2e-6, 'f', 6);
+        line += ',' + QByteArray::number(14.0 + random.bounded(100) * 0.01, 'f', 2);
+        line += ',' + QByteArray::number(180.0 + 5.0 * qSin(i / 600.0), 'f', 1);
+        line += ',' + QByteArray::number(random.bounded(250) * 0.1, 'f', 1);
+        line += ',' + QByteArray::number(12.0 + random.bounded(20) * 0.1, 'f', 1);
+        for (int slot = 0; slot < 2; ++slot) {
+            line += ',' + QByteArray::number(95.0 + random.bounded(30) * 0.1, 'f', 1);
+            line += ',' + QByteArray::number(70.0 + random.bounded(50) * 0.1, 'f', 1);
+            line += ',' + QByteArray::number(1180.0 + random.generateDouble() * 40.0, 'f', 3);
+        }
+        line += '\n';
+        if (file.write(line) != line.size())
+            return false;
+    }
+    return file.flush();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);
+    const int rows = argc > 1 ? qMax(1, atoi(argv[1])) : 2000000;
+    const int runs = argc > 2 ? qMax(1, atoi(argv[2])) : 3;
+    QRandomGenerator random(20261017);
+
+    QTemporaryDir work;
+    if (!work.isValid()) {
+        std::fprintf(stderr, "cannot create a temporary directory\n");
+        return 1;
+    }
+    const QString csv = work.filePath("import.csv");
+    if (!writeCsv(csv, rows, random)) {
+        std::fprintf(stderr, "cannot write %s\n", qPrintable(csv));
+        return 1;
+    }
+    std::printf("%d rows, %d columns, %.1f MB\n", rows, header().size(),
+                QFileInfo(csv).size() / (1024.0 * 1024.0));
+
+    double best = 0.0;
+    for (int run = 1; run <= runs; ++run) {
+        const QString history = work.filePath(QString("history-%1").arg(run));
+        if (!TelemetryStore::instance().open(history)) {
+            std::fprintf(stderr, "cannot open a store in %s\n", qPrintable(history));
+            return 1;
+        }
+
+        QString error;
+        const TelemetryImporter::Stats stats =
+            TelemetryImporter::importFiles({ csv }, nullptr, [](qint64, qint64, qint64) {}, &error);
+        if (!error.isEmpty() || stats.rowsWritten != rows) {
+            std::fprintf(stderr, "run %d: %lld of %d rows written %s\n", run,
+                         static_cast<long long>(stats.rowsWritten), rows, qPrintable(error));
+            return 1;
+        }
+
+        best = qMax(best, stats.rowsPerSecond());
+        std::printf("  run %d %9.0f ms %9.2f M rows/s %7.1f MB/s\n", run, stats.elapsedNs / 1e6,
+                    stats.rowsPerSecond() / 1e6, stats.bytes * 1e3 / stats.elapsedNs);
+    }
+
+    std::printf("best %.2f M rows/s, target %.2f M rows/s: %s\n", best / 1e6,
+                kTargetRowsPerSecond / 1e6, best >= kTargetRowsPerSecond ? "met" : "MISSED");
+    return best >= kTargetRowsPerSecond ? 0 : 2;
+}
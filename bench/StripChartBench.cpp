@@ -0,0 +1,178 @@
+// Feeds three channels at 10 Hz into a StripChart and into a QChartView
+// with three QLineSeries, each showing ten minutes, and prints the process
+// CPU time spent per second of wall time for each. Both start with a full
+// window of history so the figures are for the steady state. Runs on the
+// offscreen platform unless QT_QPA_PLATFORM says otherwise.
+//
+//   bench_strip_chart [seconds per case]
+
+#include "StripChart.h"
+#include <QApplication>
+#include <QChart>
+#include <QChartView>
+#include <QDateTime>
+#include <QDateTimeAxis>
+#include <QElapsedTimer>
+#include <QLineSeries>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QValueAxis>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+
+namespace {
+
+const int kChannels = 3;
+const int kRateHz = 10;
+const qint64 kWindowMs = 10 * 60 * 1000;
+const int kWindowRows = int(kWindowMs / 1000) * kRateHz;
+const QSize kSize(900, 260);
+
+// Exhaust gas temperatures around 350 °C, one per engine
+class Feed
+{
+public:
+    Feed() : m_random(20261017), m_step(0) {}
+
+    QVector<double> next()
+    {
+        QVector<double> values(kChannels);
+        for (int c = 0; c < kChannels; ++c)
+            values[c] = 330.0 + 15.0 * c + 8.0 * qSin((m_step + 400 * c) / 300.0) + m_random.generateDouble() * 3.0;
+        ++m_step;
+        return values;
+    }
+
+private:
+    QRandomGenerator m_random;
+    qint64 m_step;
+};
+
+double cpuMs()
+{
+    return std::clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+// Calls feed at kRateHz for seconds of wall time and returns process CPU
+// milliseconds per second, painting included
+double measure(int seconds, const std::function<void(qint64)>& feed)
+{
+    // Let the first full paint and layout settle outside the measurement
+    QElapsedTimer settle;
+    settle.start();
+    while (settle.elapsed() < 500)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+
+    QTimer timer;
+    timer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&timer, &QTimer::timeout, [&feed]() { feed(QDateTime::currentMSecsSinceEpoch()); });
+
+    QElapsedTimer wall;
+    const double cpuBefore = cpuMs();
+    wall.start();
+    timer.start(1000 / kRateHz);
+    while (wall.elapsed() < seconds * 1000LL)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    timer.stop();
+    return (cpuMs() - cpuBefore) * 1000.0 / wall.elapsed();
+}
+
+double stripChartCase(int seconds)
+{
+    Feed feed;
+    QSharedPointer<StripChartBuffer> buffer(new StripChartBuffer(kChannels, kWindowRows));
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    for (int i = kWindowRows; i > 0; --i)
+        buffer->append(nowMs - i * (1000 / kRateHz), feed.next());
+
+    StripChart chart(buffer);
+    chart.setChannel(0, "ME 1", QColor(40, 167, 69));
+    chart.setChannel(1, "ME 2", QColor(0, 120, 212));
+    chart.setChannel(2, "ME 3", QColor(255, 193, 7));
+    chart.setWindow(kWindowMs);
+    chart.setRange(250.0, 450.0);
+    chart.setUnit("°C");
+    chart.setFrameRate(kRateHz);
+    chart.resize(kSize);
+    chart.show();
+
+    return measure(seconds, [&](qint64 ms) { buffer->append(ms, feed.next()); });
+}
+
+double chartViewCase(int seconds)
+{
+    Feed feed;
+    QChart *chart = new QChart();
+    chart->legend()->hide();
+    QDateTimeAxis *axisX = new QDateTimeAxis();
+    axisX->setFormat("hh:mm:ss");
+    QValueAxis *axisY = new QValueAxis();
+    axisY->setRange(250.0, 450.0);
+    axisY->setLabelFormat("%.0f °C");
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+
+    const QColor colors[kChannels] = { QColor(40, 167, 69), QColor(0, 120, 212), QColor(255, 193, 7) };
+    QVector<QLineSeries*> series;
+    for (int c = 0; c < kChannels; ++c) {
+        QLineSeries *line = new QLineSeries();
+        line->setColor(colors[c]);
+        chart->addSeries(line);
+        line->attachAxis(axisX);
+        line->attachAxis(axisY);
+        series.append(line);
+    }
+
+    // The window as it would be after ten minutes of streaming
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    QVector<QList<QPointF>> history(kChannels);
+    for (int i = kWindowRows; i > 0; --i) {
+        const qint64 ms = nowMs - i * (1000 / kRateHz);
+        const QVector<double> values = feed.next();
+        for (int c = 0; c < kChannels; ++c)
+            history[c].append(QPointF(ms, values.at(c)));
+    }
+    for (int c = 0; c < kChannels; ++c)
+        series[c]->replace(history.at(c));
+    axisX->setRange(QDateTime::fromMSecsSinceEpoch(nowMs - kWindowMs), QDateTime::fromMSecsSinceEpoch(nowMs));
+
+    QChartView view(chart);
+    view.setRenderHint(QPainter::Antialiasing);
+    view.resize(kSize);
+    view.show();
+
+    // One point per series per sample, the oldest dropped, the axis scrolled
+    return measure(seconds, [&](qint64 ms) {
+        const QVector<double> values = feed.next();
+        for (int c = 0; c < kChannels; ++c) {
+            series[c]->append(ms, values.at(c));
+            if (series[c]->count() > kWindowRows)
+                series[c]->removePoints(0, series[c]->count() - kWindowRows);
+        }
+        axisX->setRange(QDateTime::fromMSecsSinceEpoch(ms - kWindowMs), QDateTime::fromMSecsSinceEpoch(ms));
+    });
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    const int seconds = argc > 1 ? qMax(1, atoi(argv[1])) : 10;
+
+    std::printf("%d channels at %d Hz, %lld s window, %dx%d px, %d s per case\n", kChannels, kRateHz,
+                static_cast<long long>(kWindowMs / 1000), kSize.width(), kSize.height(), seconds);
+
+    const double strip = stripChartCase(seconds);
+    std::printf("  %-12s %8.2f CPU ms/s\n", "StripChart", strip);
+    const double charts = chartViewCase(seconds);
+    std::printf("  %-12s %8.2f CPU ms/s\n", "QChartView", charts);
+    if (strip > 0)
+        std::printf("  QChartView / StripChart %.1fx\n", charts / strip);
+    return 0;
+}
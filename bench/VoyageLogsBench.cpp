@@ -0,0 +1,164 @@
+// Decodes the same logs-data payloads as JSON and as CBOR and prints the
+// size on the wire and decode time per record for each encoding. JSON is
+// timed twice: through the single-pass VoyageLogsJsonReader, and through
+// QJsonDocument plus parseVoyageLogs, the tree-building path it replaced.
+//
+//   bench_voyage_logs [seconds per case]
+
+#include "VoyageLogsDecoder.h"
+#include "VoyageLogsCbor.h"
+#include <QCoreApplication>
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+// A typical vessel fit: two main engines, three generators, four of each tank
+VoyageLogs sampleRecord(int logId)
+{
+    VoyageLogs logs;
+    logs.log_id = logId;
+    logs.voyage_id = QStringLiteral("VOY-2026-014");
+    logs.timestamp = QDateTime::fromSecsSinceEpoch(1780000000 + logId, Qt::UTC).toString(Qt::ISODate);
+    logs.latitude = -6.1 + logId * 1e-5;
+    logs.longitude = 106.8 + logId * 1e-5;
+    logs.ship_speed = 12.4 + (logId % 7) * 0.1;
+    logs.course = 45 + logId % 3;
+    logs.wind_speed = 8.2;
+    logs.sea_state = 3;
+    logs.air_temperature = QStringLiteral("29.5");
+    logs.humidity = QStringLiteral("78");
+    logs.barometric_pressure = QStringLiteral("1009.2");
+    logs.hvac_power = 120.5;
+    logs.galley_power = 35.2;
+    logs.lighting_power = 18.7;
+    logs.total_hotel_load = 174.4;
+
+    for (int i = 0; i < 2; ++i) {
+        PropulsionLog p;
+        p.propulsion_log_id = logId * 2 + i;
+        p.log_id = logId;
+        p.engine_id = QStringLiteral("ME-%1").arg(i + 1);
+        p.status = QStringLiteral("Running");
+        p.rpm = 95 + i;
+        p.engine_load = 72 + (logId % 5);
+        p.power_output = 6120.5 + i * 10;
+        p.fuel_consumption_rate = 1180.25 + (logId % 11);
+        p.exhaust_gas_temp = 345 + (logId % 9);
+        logs.propulsion_logs.append(p);
+    }
+    for (int i = 0; i < 3; ++i) {
+        ElectricalLog e;
+        e.electrical_log_id = logId * 3 + i;
+        e.log_id = logId;
+        e.generator_id = QStringLiteral("DG-%1").arg(i + 1);
+        e.status = i < 2 ? QStringLiteral("Running") : QStringLiteral("Standby");
+        e.gen_load = i < 2 ? 64 : 0;
+        e.gen_power_output = i < 2 ? 512.0 : 0.0;
+        e.gen_fuel_consumption_rate = i < 2 ? 118.4 : 0.0;
+        logs.electrical_logs.append(e);
+    }
+    for (int i = 0; i < 4; ++i) {
+        FuelTankLog f;
+        f.fuel_tank_log_id = logId * 4 + i;
+        f.log_id = logId;
+        f.tank_id = QStringLiteral("FT-%1").arg(i + 1);
+        f.fuel_type = i < 2 ? QStringLiteral("HFO") : QStringLiteral("MGO");
+        f.fuel_level = 64.2 - i;
+        f.fuel_volume = 812.5 - i * 20;
+        logs.fuel_tank_logs.append(f);
+
+        BallastTankLog b;
+        b.ballast_tank_log_id = logId * 4 + i;
+        b.log_id = logId;
+        b.tank_id = QStringLiteral("BT-%1").arg(i + 1);
+        b.tank_level = 40.0 + i;
+        b.pump_status = QStringLiteral("Stopped");
+        b.pump_power_consumption = 0.0;
+        logs.ballast_tank_logs.append(b);
+    }
+    return logs;
+}
+
+// Same content in both encodings: the JSON is rendered from the CBOR
+QByteArray toJson(const QByteArray& cbor)
+{
+    return QJsonDocument(QCborValue::fromCbor(cbor).toJsonValue().toObject()).toJson(QJsonDocument::Compact);
+}
+
+// Runs decode() for at least budgetMs and returns nanoseconds per call
+double timeDecode(const std::function<int()>& decode, qint64 budgetMs)
+{
+    // One untimed call to fault in code and allocator pools
+    decode();
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 calls = 0;
+    while (timer.elapsed() < budgetMs) {
+        if (decode() <= 0) {
+            std::fprintf(stderr, "decode failed\n");
+            return 0;
+        }
+        ++calls;
+    }
+    return double(timer.nsecsElapsed()) / calls;
+}
+
+void report(const char* name, int records, int bytes, double nsPerCall)
+{
+    std::printf("  %-22s %9d B %9.1f B/rec %10.2f us/rec %8.1f MB/s\n",
+                name, bytes, double(bytes) / records, nsPerCall / records / 1000.0,
+                nsPerCall > 0 ? bytes / nsPerCall * 1000.0 : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const qint64 budgetMs = argc > 1 ? qMax(1, atoi(argv[1])) * 1000 : 1000;
+
+    // Live frame, one poll's delta, and a gap-recovery range
+    const int batchSizes[] = { 1, 60, 3600 };
+
+    for (int records : batchSizes) {
+        QList<VoyageLogs> batch;
+        batch.reserve(records);
+        for (int i = 0; i < records; ++i)
+            batch.append(sampleRecord(1000 + i));
+
+        const QByteArray cbor = VoyageLogsCbor::encode(batch);
+        const QByteArray json = toJson(cbor);
+
+        std::printf("%d record(s)\n", records);
+
+        double ns = timeDecode([&]() {
+            return VoyageLogsDecoder::decode(json, WireFormat::Json).records.size();
+        }, budgetMs);
+        report("JSON", records, json.size(), ns);
+
+        ns = timeDecode([&]() {
+            const QJsonArray data = QJsonDocument::fromJson(json).object().value(QLatin1String("data")).toArray();
+            QList<VoyageLogs> parsed;
+            parsed.reserve(data.size());
+            for (const QJsonValue &record : data)
+                parsed.append(VoyageLogsDecoder::parseVoyageLogs(record.toObject()));
+            return parsed.size();
+        }, budgetMs);
+        report("JSON (QJsonDocument)", records, json.size(), ns);
+
+        ns = timeDecode([&]() {
+            return VoyageLogsDecoder::decode(cbor, WireFormat::Cbor).records.size();
+        }, budgetMs);
+        report("CBOR", records, cbor.size(), ns);
+    }
+
+    return 0;
+}
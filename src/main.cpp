@@ -8,6 +8,8 @@ int main(int argc, char *argv[])
     qputenv("QTWEBENGINE_REMOTE_DEBUGGING", "9222");
 
     QApplication a(argc, argv);
+    a.setOrganizationName("S-Core");
+    a.setApplicationName("SCore");
 
     a.setWindowIcon(QIcon("qrc:/icons/s-core_app_icon.png"));
 
@@ -0,0 +1,290 @@
+#include "GorillaCodec.h"
+#include <cstring>
+
+namespace {
+
+class BitWriter
+{
+public:
+    explicit BitWriter(QByteArray* out) : m_out(out), m_buffer(0), m_used(0) {}
+
+    void write(quint64 bits, int width)
+    {
+        while (width > 0) {
+            const int take = qMin(width, 8 - m_used);
+            const int shift = width - take;
+            const quint32 chunk = quint32((bits >> shift) & ((quint64(1) << take) - 1));
+            m_buffer = quint8((m_buffer << take) | chunk);
+            m_used += take;
+            width -= take;
+            if (m_used == 8) {
+                m_out->append(char(m_buffer));
+                m_buffer = 0;
+                m_used = 0;
+            }
+        }
+    }
+
+    void flush()
+    {
+        if (m_used > 0)
+            m_out->append(char(quint8(m_buffer << (8 - m_used))));
+        m_buffer = 0;
+        m_used = 0;
+    }
+
+private:
+    QByteArray* m_out;
+    quint8 m_buffer;
+    int m_used;
+};
+
+class BitReader
+{
+public:
+    BitReader(const char* data, int bytes)
+        : m_data(reinterpret_cast<const quint8*>(data)), m_bits(qint64(bytes) * 8), m_pos(0) {}
+
+    bool read(int width, quint64* bits)
+    {
+        if (m_pos + width > m_bits)
+            return false;
+        quint64 value = 0;
+        while (width > 0) {
+            const int offset = int(m_pos & 7);
+            const int take = qMin(width, 8 - offset);
+            const quint8 byte = m_data[m_pos >> 3];
+            const quint32 chunk = (byte >> (8 - offset - take)) & ((1u << take) - 1);
+            value = (value << take) | chunk;
+            m_pos += take;
+            width -= take;
+        }
+        *bits = value;
+        return true;
+    }
+
+    bool readBit(bool* bit)
+    {
+        quint64 value;
+        if (!read(1, &value))
+            return false;
+        *bit = value != 0;
+        return true;
+    }
+
+private:
+    const quint8* m_data;
+    qint64 m_bits;
+    qint64 m_pos;
+};
+
+int leadingZeros32(quint32 x)
+{
+    int n = 0;
+    for (quint32 mask = 0x80000000u; mask && !(x & mask); mask >>= 1)
+        ++n;
+    return n;
+}
+
+int trailingZeros32(quint32 x)
+{
+    int n = 0;
+    for (quint32 mask = 1u; mask && !(x & mask); mask <<= 1)
+        ++n;
+    return n;
+}
+
+quint64 signExtend(quint64 bits, int width)
+{
+    const quint64 sign = quint64(1) << (width - 1);
+    return (bits ^ sign) - sign;
+}
+
+// Delta-of-delta buckets: control prefix and payload width
+struct DodBucket {
+    quint32 prefix;
+    int prefixBits;
+    int valueBits;
+};
+
+const DodBucket kDodBuckets[] = {
+    { 0x2, 2, 7 },     // 10   + 7 bits
+    { 0x6, 3, 9 },     // 110  + 9 bits
+    { 0xE, 4, 12 },    // 1110 + 12 bits
+};
+
+} // namespace
+
+QByteArray GorillaCodec::encodeTimestamps(const qint64* values, int count)
+{
+    QByteArray out;
+    if (count <= 0)
+        return out;
+    out.reserve(8 + count / 8 + 16);
+
+    BitWriter writer(&out);
+    writer.write(quint64(values[0]), 64);
+
+    qint64 previous = values[0];
+    qint64 previousDelta = 0;
+    for (int i = 1; i < count; ++i) {
+        const qint64 delta = values[i] - previous;
+        const qint64 dod = delta - previousDelta;
+        previous = values[i];
+        previousDelta = delta;
+
+        if (dod == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+
+        bool written = false;
+        for (const DodBucket &bucket : kDodBuckets) {
+            const qint64 limit = qint64(1) << (bucket.valueBits - 1);
+            if (dod >= -limit && dod < limit) {
+                writer.write(bucket.prefix, bucket.prefixBits);
+                writer.write(quint64(dod) & ((quint64(1) << bucket.valueBits) - 1), bucket.valueBits);
+                written = true;
+                break;
+            }
+        }
+        if (!written) {
+            writer.write(0xF, 4);
+            writer.write(quint64(dod), 64);
+        }
+    }
+    writer.flush();
+    return out;
+}
+
+bool GorillaCodec::decodeTimestamps(const char* data, int bytes, qint64* out, int count)
+{
+    if (count <= 0)
+        return true;
+
+    BitReader reader(data, bytes);
+    quint64 bits;
+    if (!reader.read(64, &bits))
+        return false;
+    out[0] = qint64(bits);
+
+    qint64 previousDelta = 0;
+    for (int i = 1; i < count; ++i) {
+        // Count leading ones of the control prefix (at most four)
+        int ones = 0;
+        bool bit = true;
+        while (ones < 4) {
+            if (!reader.readBit(&bit))
+                return false;
+            if (!bit)
+                break;
+            ++ones;
+        }
+
+        qint64 dod = 0;
+        if (ones == 4) {
+            if (!reader.read(64, &bits))
+                return false;
+            dod = qint64(bits);
+        } else if (ones > 0) {
+            const int width = kDodBuckets[ones - 1].valueBits;
+            if (!reader.read(width, &bits))
+                return false;
+            dod = qint64(signExtend(bits, width));
+        }
+
+        previousDelta += dod;
+        out[i] = out[i - 1] + previousDelta;
+    }
+    return true;
+}
+
+QByteArray GorillaCodec::encodeFloats(const float* values, int count)
+{
+    QByteArray out;
+    if (count <= 0)
+        return out;
+    out.reserve(4 + count / 2 + 16);
+
+    BitWriter writer(&out);
+    quint32 previous;
+    std::memcpy(&previous, &values[0], 4);
+    writer.write(previous, 32);
+
+    int previousLeading = -1;
+    int previousTrailing = 0;
+    for (int i = 1; i < count; ++i) {
+        quint32 current;
+        std::memcpy(&current, &values[i], 4);
+        const quint32 x = current ^ previous;
+        previous = current;
+
+        if (x == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+        writer.write(1, 1);
+
+        int leading = qMin(leadingZeros32(x), 31);
+        const int trailing = trailingZeros32(x);
+
+        // Reuse the previous window when the new bits fit inside it
+        if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing) {
+            const int width = 32 - previousLeading - previousTrailing;
+            writer.write(0, 1);
+            writer.write(x >> previousTrailing, width);
+        } else {
+            const int width = 32 - leading - trailing;
+            writer.write(1, 1);
+            writer.write(quint64(leading), 5);
+            writer.write(quint64(width - 1), 5);
+            writer.write(x >> trailing, width);
+            previousLeading = leading;
+            previousTrailing = trailing;
+        }
+    }
+    writer.flush();
+    return out;
+}
+
+bool GorillaCodec::decodeFloats(const char* data, int bytes, float* out, int count)
+{
+    if (count <= 0)
+        return true;
+
+    BitReader reader(data, bytes);
+    quint64 bits;
+    if (!reader.read(32, &bits))
+        return false;
+    quint32 previous = quint32(bits);
+    std::memcpy(&out[0], &previous, 4);
+
+    int leading = 0;
+    int trailing = 0;
+    for (int i = 1; i < count; ++i) {
+        bool bit;
+        if (!reader.readBit(&bit))
+            return false;
+
+        if (bit) {
+            bool newWindow;
+            if (!reader.readBit(&newWindow))
+                return false;
+            if (newWindow) {
+                quint64 lead, width;
+                if (!reader.read(5, &lead) || !reader.read(5, &width))
+                    return false;
+                leading = int(lead);
+                trailing = 32 - leading - int(width + 1);
+                if (trailing < 0)
+                    return false;
+            }
+            const int width = 32 - leading - trailing;
+            if (!reader.read(width, &bits))
+                return false;
+            previous ^= quint32(bits) << trailing;
+        }
+        std::memcpy(&out[i], &previous, 4);
+    }
+    return true;
+}
@@ -0,0 +1,22 @@
+#ifndef GORILLACODEC_H
+#define GORILLACODEC_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Gorilla time-series compression (Pelkonen et al., VLDB 2015) for archived
+// telemetry columns. Timestamps are stored as delta-of-deltas in variable
+// bit-width buckets, so a steady 1 Hz clock costs one bit per row; float
+// samples are XORed with their predecessor and only the meaningful bits of
+// the difference are kept, so slowly moving channels cost a few bits each.
+class GorillaCodec
+{
+public:
+    static QByteArray encodeTimestamps(const qint64* values, int count);
+    static bool decodeTimestamps(const char* data, int bytes, qint64* out, int count);
+
+    static QByteArray encodeFloats(const float* values, int count);
+    static bool decodeFloats(const char* data, int bytes, float* out, int count);
+};
+
+#endif // GORILLACODEC_H
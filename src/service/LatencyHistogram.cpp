@@ -0,0 +1,81 @@
+#include "LatencyHistogram.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::reset()
+{
+    std::memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_sumMicros = 0;
+    m_minMicros = std::numeric_limits<qint64>::max();
+    m_maxMicros = 0;
+}
+
+int LatencyHistogram::bucketFor(qint64 micros)
+{
+    if (micros <= 1)
+        return 0;
+    int bucket = static_cast<int>(std::ceil(std::log2(static_cast<double>(micros)) * kSubBuckets));
+    return qBound(0, bucket, kBucketCount - 1);
+}
+
+double LatencyHistogram::bucketUpperMicros(int bucket)
+{
+    return std::exp2(static_cast<double>(bucket) / kSubBuckets);
+}
+
+void LatencyHistogram::record(qint64 micros)
+{
+    micros = qMax<qint64>(micros, 0);
+    ++m_buckets[bucketFor(micros)];
+    ++m_count;
+    m_sumMicros += micros;
+    m_minMicros = qMin(m_minMicros, micros);
+    m_maxMicros = qMax(m_maxMicros, micros);
+}
+
+double LatencyHistogram::meanMs() const
+{
+    return m_count > 0 ? static_cast<double>(m_sumMicros) / m_count / 1000.0 : 0.0;
+}
+
+double LatencyHistogram::minMs() const
+{
+    return m_count > 0 ? m_minMicros / 1000.0 : 0.0;
+}
+
+double LatencyHistogram::maxMs() const
+{
+    return m_maxMicros / 1000.0;
+}
+
+double LatencyHistogram::percentileMs(double p) const
+{
+    if (m_count == 0)
+        return 0.0;
+
+    const qint64 rank = qMax<qint64>(1, static_cast<qint64>(std::ceil(qBound(0.0, p, 100.0) / 100.0 * m_count)));
+    qint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank)
+            return qMin(bucketUpperMicros(i), static_cast<double>(m_maxMicros)) / 1000.0;
+    }
+    return maxMs();
+}
+
+QString LatencyHistogram::summary() const
+{
+    return QString("n=%1 p50=%2 p95=%3 p99=%4 max=%5 ms")
+        .arg(m_count)
+        .arg(percentileMs(50), 0, 'f', 1)
+        .arg(percentileMs(95), 0, 'f', 1)
+        .arg(percentileMs(99), 0, 'f', 1)
+        .arg(maxMs(), 0, 'f', 1);
+}
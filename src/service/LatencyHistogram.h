@@ -0,0 +1,42 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <QString>
+
+// Log-scale latency histogram with four buckets per power of two, covering
+// 1 us to ~19 h with at most ~19% relative error per reading.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 micros);
+    void reset();
+
+    qint64 count() const { return m_count; }
+    double meanMs() const;
+    double minMs() const;
+    double maxMs() const;
+
+    // p in [0, 100]; returns the upper edge of the bucket holding that rank
+    double percentileMs(double p) const;
+
+    // "n=120 p50=35.2 p95=80.1 p99=140.0 max=212.4 ms"
+    QString summary() const;
+
+private:
+    static const int kSubBuckets = 4;
+    static const int kBucketCount = 36 * kSubBuckets;
+
+    static int bucketFor(qint64 micros);
+    static double bucketUpperMicros(int bucket);
+
+    qint64 m_buckets[kBucketCount];
+    qint64 m_count;
+    qint64 m_sumMicros;
+    qint64 m_minMicros;
+    qint64 m_maxMicros;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -1,21 +1,122 @@
 #include "MockApiService.h"
-#include <QJsonDocument>
-#include <QJsonArray>
+#include "VoyageLogsDecoder.h"
+#include "VoyageLogsCbor.h"
+#include "TelemetryGapRecovery.h"
+#include "TelemetryStore.h"
+#include "TelemetryRollups.h"
+#include "TelemetryDcs.h"
+#include "TelemetryReplay.h"
+#include "TelemetryCompactor.h"
+#include <QUrlQuery>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QSettings>
+#include <QStringList>
 #include <QDebug>
 
 MockApiService* MockApiService::m_instance = nullptr;
 
+namespace {
+
+// Query parameter names understood by the logs-data endpoint
+QString subsystemFieldList(MockApiService::Subsystems fields)
+{
+    QStringList names;
+    if (fields & MockApiService::Navigation)   names << "navigation";
+    if (fields & MockApiService::Weather)      names << "weather";
+    if (fields & MockApiService::HotelLoad)    names << "hotel_load";
+    if (fields & MockApiService::Propulsion)   names << "propulsion_logs";
+    if (fields & MockApiService::Electrical)   names << "electrical_logs";
+    if (fields & MockApiService::FuelTanks)    names << "fuel_tank_logs";
+    if (fields & MockApiService::BallastTanks) names << "ballast_tank_logs";
+    return names.join(',');
+}
+
+// Live and recovered frames go into the on-disk history, the rollup
+// pyramid and the DCS totals the History page reads from; replayed
+// frames do not
+void recordFrame(const TelemetryFrame& frame)
+{
+    TelemetryStore::instance().append(frame);
+    TelemetryRollups::instance().add(frame);
+    TelemetryDcs::instance().add(frame);
+}
+
+} // namespace
+
 MockApiService::MockApiService(QObject *parent)
     : QObject(parent),
     m_manager(new QNetworkAccessManager(this)),
     m_timer(new QTimer(this)),
-    m_logId(1)
+    m_logId(1),
+    m_pollIntervalMs(0),
+    m_planFields(NoSubsystem),
+    m_streamPort(0),
+    m_stream(new TelemetryStreamClient(this)),
+    m_lastLatencyMs(-1),
+    m_hasState(false),
+    m_cursorLogId(0),
+    m_decoderPool(new QThreadPool(this)),
+    m_decodeNsOffloaded(0),
+    m_preferCbor(true),
+    m_fetchPending(false),
+    m_requestSeq(0),
+    m_appliedSeq(0),
+    m_stateTimestampMs(0),
+    m_recordedMs(0),
+    m_stateFromCache(false),
+    m_recovery(new TelemetryGapRecovery(this)),
+    m_replay(new TelemetryReplay(this)),
+    m_replaying(false),
+    m_compactor(new TelemetryCompactor(this))
 {
+    m_clock.start();
+
+    qRegisterMetaType<VoyageLogs>("VoyageLogs");
+    qRegisterMetaType<TelemetryFrame>("TelemetryFrame");
+
+    // A single decoder thread keeps replies merged in the order they arrived
+    m_decoderPool->setMaxThreadCount(1);
+
     connect(m_manager, &QNetworkAccessManager::finished,
             this, &MockApiService::onReplyFinished);
 
     connect(m_timer, &QTimer::timeout,
             this, &MockApiService::fetchVoyageLogs);
+
+    connect(m_stream, &TelemetryStreamClient::connected,
+            this, &MockApiService::onStreamConnected);
+    connect(m_stream, &TelemetryStreamClient::disconnected,
+            this, &MockApiService::onStreamDisconnected);
+    connect(m_stream, &TelemetryStreamClient::frameReceived,
+            this, &MockApiService::onStreamFrame);
+
+    TelemetryRollups::instance().catchUpFromStore();
+    TelemetryDcs::instance().rebuildLateDays();
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+        m_compactor->stop();
+        TelemetryRollups::instance().save();
+        TelemetryDcs::instance().save();
+    });
+    m_compactor->start();
+
+    // Show the last session's values until the first reply arrives
+    warmStartFromCache();
+
+    // Catch up on intervals missed while the link was down
+    connect(m_recovery, &TelemetryGapRecovery::recordRecovered,
+            this, &MockApiService::onRecordRecovered);
+    m_backfillState = m_state;
+    m_recovery->setLogId(m_logId);
+
+    connect(m_replay, &TelemetryReplay::framesReady,
+            this, &MockApiService::onReplayFrames);
+
+    // Resume the stream configured on the Settings page
+    QSettings settings;
+    QString host = settings.value("iot/server").toString();
+    if (!host.isEmpty())
+        startStreaming(host, static_cast<quint16>(settings.value("iot/port", 8883).toUInt()));
 }
 
 MockApiService* MockApiService::instance()
@@ -26,121 +127,602 @@ MockApiService* MockApiService::instance()
     return m_instance;
 }
 
-void MockApiService::startPolling(int logId, int intervalMs)
+void MockApiService::setLogId(int logId)
 {
+    if (logId == m_logId)
+        return;
+
+    // Different stream: the merged state and cursor no longer apply
     m_logId = logId;
-    if (!m_timer->isActive()) {
-        m_timer->start(intervalMs);
+    m_state = VoyageLogs();
+    m_hasState = false;
+    m_cursorTimestamp.clear();
+    m_cursorLogId = 0;
+    m_stateTimestampMs = 0;
+    m_recordedMs = 0;
+
+    // Replies for the previous log id are superseded
+    m_appliedSeq = m_requestSeq;
+    if (m_inFlight)
+        m_inFlight->abort();
+
+    warmStartFromCache();
+    m_backfillState = m_state;
+    m_recovery->setLogId(m_logId);
+
+    if (!m_streamHost.isEmpty() && !m_subscriptions.isEmpty())
+        startStreaming(m_streamHost, m_streamPort);
+    if (!m_subscriptions.isEmpty())
+        fetchVoyageLogs();
+}
+
+void MockApiService::subscribe(QObject* subscriber, Subsystems fields, int maxIntervalMs)
+{
+    if (!subscriber)
+        return;
+
+    if (!m_subscriptions.contains(subscriber)) {
+        connect(subscriber, &QObject::destroyed, this, [this](QObject *obj) {
+            unsubscribe(obj);
+        });
     }
-    fetchVoyageLogs();
+
+    Subscription subscription;
+    subscription.fields = fields;
+    subscription.intervalMs = qMax(maxIntervalMs, 100);
+    m_subscriptions.insert(subscriber, subscription);
+
+    applyFetchPlan();
+}
+
+void MockApiService::unsubscribe(QObject* subscriber)
+{
+    if (m_subscriptions.remove(subscriber) == 0)
+        return;
+
+    disconnect(subscriber, &QObject::destroyed, this, nullptr);
+    applyFetchPlan();
+}
+
+void MockApiService::applyFetchPlan()
+{
+    Subsystems fields = NoSubsystem;
+    int intervalMs = 0;
+    for (const Subscription &subscription : qAsConst(m_subscriptions)) {
+        fields |= subscription.fields;
+        intervalMs = intervalMs == 0 ? subscription.intervalMs
+                                     : qMin(intervalMs, subscription.intervalMs);
+    }
+
+    if (fields == m_planFields && intervalMs == m_pollIntervalMs)
+        return;
+
+    const Subsystems added = fields & ~m_planFields;
+    const bool wasIdle = m_pollIntervalMs == 0;
+    m_planFields = fields;
+    m_pollIntervalMs = intervalMs;
+    emit fetchPlanChanged(m_planFields, m_pollIntervalMs);
+
+    // Last subscriber gone: nothing is fetched until someone subscribes again
+    if (m_subscriptions.isEmpty()) {
+        m_timer->stop();
+        m_stream->disconnectFromBroker();
+        return;
+    }
+
+    if (wasIdle && !m_streamHost.isEmpty())
+        startStreaming(m_streamHost, m_streamPort);
+
+    if (!m_stream->isConnected()
+        && (!m_timer->isActive() || m_timer->interval() != m_pollIntervalMs))
+        m_timer->start(m_pollIntervalMs);
+
+    // Newly requested subsystems have never been fetched: take one full
+    // snapshot instead of a delta so they are populated right away
+    if (added != NoSubsystem) {
+        if (m_hasState) {
+            m_hasState = false;
+            m_cursorTimestamp.clear();
+            m_cursorLogId = 0;
+        }
+        fetchVoyageLogs();
+    }
+}
+
+void MockApiService::startStreaming(const QString& host, quint16 port)
+{
+    m_streamHost = host;
+    m_streamPort = port;
+
+    // Connects once the first subscriber arrives
+    if (m_subscriptions.isEmpty())
+        return;
+
+    m_stream->connectToBroker(host, port,
+                              QString("score/voyage/%1/telemetry").arg(m_logId));
+}
+
+void MockApiService::stopStreaming()
+{
+    m_streamHost.clear();
+
+    bool wasStreaming = m_stream->isConnected();
+    m_stream->disconnectFromBroker();
+    if (wasStreaming)
+        onStreamDisconnected();
+}
+
+void MockApiService::onStreamConnected()
+{
+    // Frames are pushed as they are produced; polling is only a fallback
+    m_timer->stop();
+    emit streamingStateChanged(true);
+
+    // One snapshot to cover anything produced while the stream was down
+    if (m_pollIntervalMs > 0)
+        fetchVoyageLogs();
+}
+
+void MockApiService::onStreamDisconnected()
+{
+    if (m_pollIntervalMs > 0 && !m_timer->isActive())
+        m_timer->start(m_pollIntervalMs);
+    emit streamingStateChanged(false);
+}
+
+void MockApiService::onStreamFrame(const QByteArray& payload)
+{
+    // A CBOR map starts with major type 5 (0xA0-0xBF); JSON starts with '{'
+    WireFormat format = (!payload.isEmpty() && (static_cast<quint8>(payload.at(0)) & 0xE0) == 0xA0)
+                            ? WireFormat::Cbor : WireFormat::Json;
+
+    m_decoderPool->start(new VoyageLogsDecoder(payload, format, this,
+                                               [this](const DecodedVoyageLogs &decoded) {
+                                                   onRecordsDecoded(decoded, 0);
+                                               }));
 }
 
 void MockApiService::fetchVoyageLogs()
 {
-    QString url = QString("https://score-api.heyrend.cloud/api/v1/logs-data/voyage/%1").arg(m_logId);
-    QNetworkRequest request((QUrl(url)));
+    // At most one request in flight: a tick that lands while the previous
+    // request is still running is folded into a single follow-up fetch
+    if (m_inFlight) {
+        m_fetchPending = true;
+        return;
+    }
+    m_fetchPending = false;
+
+    QUrl url(QString("https://score-api.heyrend.cloud/api/v1/logs-data/voyage/%1").arg(m_logId));
+
+    QUrlQuery query;
+
+    // After the first full snapshot only ask for records newer than the cursor.
+    // While a gap is open only the latest record is needed; the missed
+    // interval is fetched separately in range batches once the link is back
+    if (m_hasState && !m_recovery->hasOpenGap()) {
+        if (!m_cursorTimestamp.isEmpty())
+            query.addQueryItem("since", m_cursorTimestamp);
+        query.addQueryItem("since_log_id", QString::number(m_cursorLogId));
+    }
+
+    // Only the subsystems some subscriber asked for
+    if (m_planFields != AllSubsystems && m_planFields != NoSubsystem)
+        query.addQueryItem("fields", subsystemFieldList(m_planFields));
+
+    if (!query.isEmpty())
+        url.setQuery(query);
+
+    QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    m_manager->get(request);
+
+    // Prefer the compact binary encoding; servers without it keep sending JSON
+    if (m_preferCbor)
+        request.setRawHeader("Accept", "application/cbor, application/json;q=0.5");
+    else
+        request.setRawHeader("Accept", "application/json");
+
+    QNetworkReply *reply = m_manager->get(request);
+    reply->setProperty("requestSeq", ++m_requestSeq);
+    reply->setProperty("sentAtUs", m_clock.nsecsElapsed() / 1000);
+    m_inFlight = reply;
 }
 
 void MockApiService::onReplyFinished(QNetworkReply* reply)
+{
+    if (reply == m_inFlight)
+        m_inFlight = nullptr;
+
+    // Replies aborted by setLogId say nothing about the link
+    if (reply->error() != QNetworkReply::OperationCanceledError) {
+        const qint64 rttUs = m_clock.nsecsElapsed() / 1000 - reply->property("sentAtUs").toLongLong();
+        m_rttHistogram.record(rttUs);
+        adaptPollInterval(rttUs / 1000);
+    }
+
+    handleReply(reply);
+    reply->deleteLater();
+
+    // A tick was skipped while this request was running
+    if (m_fetchPending && !m_subscriptions.isEmpty())
+        fetchVoyageLogs();
+}
+
+void MockApiService::handleReply(QNetworkReply* reply)
 {
     if (reply->error() != QNetworkReply::NoError) {
-        qWarning() << "API error:" << reply->errorString();
-        reply->deleteLater();
+        if (reply->error() != QNetworkReply::OperationCanceledError) {
+            qWarning() << "API error:" << reply->errorString();
+            m_recovery->openGap(m_cursorTimestamp, m_cursorLogId);
+        }
         return;
     }
 
+    // 304 Not Modified / 204 No Content: nothing newer than the cursor
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 304 || status == 204)
+        return;
+
+    WireFormat format = WireFormat::Json;
+    QString contentType = reply->header(QNetworkRequest::ContentTypeHeader).toString();
+    if (contentType.startsWith(QLatin1String(VoyageLogsCbor::mimeType())))
+        format = WireFormat::Cbor;
+
+    // Decoding runs on the decoder pool; the reply body is handed over
+    // so the GUI thread only pays for readAll() and the final merge.
     QByteArray responseData = reply->readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
+    const quint64 seq = reply->property("requestSeq").toULongLong();
+
+    m_decoderPool->start(new VoyageLogsDecoder(responseData, format, this,
+                                               [this, seq](const DecodedVoyageLogs &decoded) {
+                                                   onRecordsDecoded(decoded, seq);
+                                               }));
+}
+
+void MockApiService::adaptPollInterval(qint64 rttMs)
+{
+    if (m_pollIntervalMs <= 0)
+        return;
+
+    // Stretch the period while the link is slower than it, then ease back
+    int target = m_pollIntervalMs;
+    if (rttMs > m_pollIntervalMs)
+        target = static_cast<int>(qMin<qint64>(rttMs * 3 / 2, qint64(m_pollIntervalMs) * 8));
+    else if (m_timer->interval() > m_pollIntervalMs)
+        target = qMax(m_pollIntervalMs, (m_timer->interval() + m_pollIntervalMs) / 2);
+
+    if (target != m_timer->interval())
+        m_timer->setInterval(target);
+}
+
+void MockApiService::onRecordsDecoded(const DecodedVoyageLogs &decoded, quint64 seq)
+{
+    m_decodeNsOffloaded += decoded.decodeNs;
+    m_parseHistogram.record(decoded.decodeNs / 1000);
+    m_queueDelayHistogram.record(decoded.queueDelayNs / 1000);
+
+    if (!decoded.ok)
+        return;
+
+    // Latest wins: a reply older than one already applied is dropped
+    if (seq != 0) {
+        if (seq <= m_appliedSeq)
+            return;
+        m_appliedSeq = seq;
 
-    if (!jsonDoc.isNull() && jsonDoc.isObject()) {
-        QJsonObject root = jsonDoc.object();
-        if (root.contains("data")) {
-            VoyageLogs logs = parseVoyageLogs(root["data"].toObject());
-            emit dataUpdated(logs);
+        // First live data after an outage: the state still reflects the
+        // start of the gap, which is where the recovered records apply
+        if (m_recovery->hasOpenGap() && !decoded.records.isEmpty()) {
+            m_backfillState = m_state;
+            m_recovery->closeGap(decoded.records.first().timestamp);
         }
     }
 
-    reply->deleteLater();
+    // Every record goes into the history, changed or not; widgets hear
+    // once per reply. Records sharing a timestamp are parts of one frame.
+    Subsystems changed = NoSubsystem;
+    bool unrecorded = false;
+    for (int i = 0; i < decoded.records.size(); ++i) {
+        bool applied = false;
+        changed |= mergeVoyageLogs(decoded.records.at(i), decoded.present.at(i), &applied);
+        unrecorded |= applied;
+        const bool lastPart = i + 1 == decoded.records.size()
+                              || decoded.records.at(i + 1).timestamp != decoded.records.at(i).timestamp;
+        if (unrecorded && lastPart && m_stateTimestampMs > m_recordedMs) {
+            recordFrame(TelemetryFrame::fromVoyageLogs(m_state));
+            m_recordedMs = m_stateTimestampMs;
+            unrecorded = false;
+        }
+    }
+
+    emitChanges(changed);
+
+    if (changed != NoSubsystem) {
+        m_stateFromCache = false;
+        m_cache.append(m_state);
+    }
+
+    QDateTime sampled = QDateTime::fromString(m_state.timestamp, Qt::ISODateWithMs);
+    if (changed != NoSubsystem && sampled.isValid())
+        m_lastLatencyMs = sampled.msecsTo(QDateTime::currentDateTimeUtc());
+}
+
+void MockApiService::onRecordRecovered(const VoyageLogs& delta, Subsystems present)
+{
+    // Recovered records are older than the live state; they only go to
+    // frame consumers (history, analytics), built on their own running state
+    applyDelta(m_backfillState, delta, present);
+    m_backfillState.log_id = delta.log_id;
+    m_backfillState.voyage_id = delta.voyage_id;
+    m_backfillState.timestamp = delta.timestamp;
+
+    const TelemetryFrame frame = TelemetryFrame::fromVoyageLogs(m_backfillState);
+    recordFrame(frame);
+    if (!m_replaying)
+        emit frameUpdated(frame);
+}
+
+bool MockApiService::startReplay(qint64 fromMs, qint64 toMs)
+{
+    m_replay->setTemplate(TelemetryFrame::fromVoyageLogs(m_state));
+    if (!m_replay->open(fromMs, toMs))
+        return false;
+
+    m_replayState = m_state;
+    if (!m_replaying) {
+        m_replaying = true;
+        emit replayingChanged(true);
+    }
+
+    // Show the first recorded frame until play() or step() is called
+    m_replay->seek(m_replay->startMs());
+    return true;
+}
+
+void MockApiService::stopReplay()
+{
+    if (!m_replaying)
+        return;
+
+    m_replay->close();
+    m_replaying = false;
+    m_replayState = VoyageLogs();
+    emit replayingChanged(false);
+
+    // Back to the live view; it was recorded all along, not re-recorded here
+    if (m_hasState)
+        emitChanges(AllSubsystems);
+}
+
+void MockApiService::onReplayFrames(const QVector<TelemetryFrame>& frames)
+{
+    if (!m_replaying || frames.isEmpty())
+        return;
+
+    // Analytics see every frame; widgets only the newest state per batch,
+    // so 1000x playback does not repaint a thousand times a second
+    for (const TelemetryFrame &frame : frames)
+        emit frameUpdated(frame);
+
+    const VoyageLogs latest = frames.last().toVoyageLogs();
+    Subsystems changed = applyDelta(m_replayState, latest, AllSubsystems);
+    m_replayState.log_id = latest.log_id;
+    m_replayState.voyage_id = latest.voyage_id;
+    m_replayState.timestamp = latest.timestamp;
+    emitState(m_replayState, changed);
+}
+
+void MockApiService::setPreferCbor(bool prefer)
+{
+    m_preferCbor = prefer;
+    m_recovery->setPreferCbor(prefer);
+}
+
+double MockApiService::mainThreadMsSaved() const
+{
+    return static_cast<double>(m_decodeNsOffloaded) / 1000000.0;
+}
+
+namespace {
+
+bool sameRecord(const PropulsionLog &a, const PropulsionLog &b)
+{
+    return a.status == b.status && a.rpm == b.rpm && a.engine_load == b.engine_load
+           && a.power_output == b.power_output
+           && a.fuel_consumption_rate == b.fuel_consumption_rate
+           && a.exhaust_gas_temp == b.exhaust_gas_temp;
+}
+
+bool sameRecord(const ElectricalLog &a, const ElectricalLog &b)
+{
+    return a.status == b.status && a.gen_load == b.gen_load
+           && a.gen_power_output == b.gen_power_output
+           && a.gen_fuel_consumption_rate == b.gen_fuel_consumption_rate;
+}
+
+bool sameRecord(const FuelTankLog &a, const FuelTankLog &b)
+{
+    return a.fuel_type == b.fuel_type && a.fuel_level == b.fuel_level
+           && a.fuel_volume == b.fuel_volume;
+}
+
+bool sameRecord(const BallastTankLog &a, const BallastTankLog &b)
+{
+    return a.tank_level == b.tank_level && a.pump_status == b.pump_status
+           && a.pump_power_consumption == b.pump_power_consumption;
+}
+
+const QString& recordKey(const PropulsionLog &log) { return log.engine_id; }
+const QString& recordKey(const ElectricalLog &log) { return log.generator_id; }
+const QString& recordKey(const FuelTankLog &log) { return log.tank_id; }
+const QString& recordKey(const BallastTankLog &log) { return log.tank_id; }
+
+// Upsert incoming records into the current list by equipment id.
+// Returns true when at least one record was added or had a different value.
+template <typename Log>
+bool mergeRecords(QList<Log> &current, const QList<Log> &incoming)
+{
+    bool changed = false;
+    for (const Log &log : incoming) {
+        bool found = false;
+        for (Log &existing : current) {
+            if (recordKey(existing) == recordKey(log)) {
+                if (!sameRecord(existing, log)) {
+                    existing = log;
+                    changed = true;
+                }
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            current.append(log);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+} // namespace
+
+MockApiService::Subsystems MockApiService::applyDelta(VoyageLogs& state, const VoyageLogs& delta,
+                                                      Subsystems present)
+{
+    Subsystems changed = NoSubsystem;
+
+    if (present & Navigation) {
+        if (state.latitude != delta.latitude || state.longitude != delta.longitude
+            || state.ship_speed != delta.ship_speed || state.course != delta.course) {
+            state.latitude = delta.latitude;
+            state.longitude = delta.longitude;
+            state.ship_speed = delta.ship_speed;
+            state.course = delta.course;
+            changed |= Navigation;
+        }
+    }
+
+    if (present & Weather) {
+        if (state.wind_speed != delta.wind_speed || state.sea_state != delta.sea_state
+            || state.air_temperature != delta.air_temperature
+            || state.humidity != delta.humidity
+            || state.barometric_pressure != delta.barometric_pressure) {
+            state.wind_speed = delta.wind_speed;
+            state.sea_state = delta.sea_state;
+            state.air_temperature = delta.air_temperature;
+            state.humidity = delta.humidity;
+            state.barometric_pressure = delta.barometric_pressure;
+            changed |= Weather;
+        }
+    }
+
+    if (present & HotelLoad) {
+        if (state.hvac_power != delta.hvac_power || state.galley_power != delta.galley_power
+            || state.lighting_power != delta.lighting_power
+            || state.total_hotel_load != delta.total_hotel_load) {
+            state.hvac_power = delta.hvac_power;
+            state.galley_power = delta.galley_power;
+            state.lighting_power = delta.lighting_power;
+            state.total_hotel_load = delta.total_hotel_load;
+            changed |= HotelLoad;
+        }
+    }
+
+    if ((present & Propulsion) && mergeRecords(state.propulsion_logs, delta.propulsion_logs))
+        changed |= Propulsion;
+    if ((present & Electrical) && mergeRecords(state.electrical_logs, delta.electrical_logs))
+        changed |= Electrical;
+    if ((present & FuelTanks) && mergeRecords(state.fuel_tank_logs, delta.fuel_tank_logs))
+        changed |= FuelTanks;
+    if ((present & BallastTanks) && mergeRecords(state.ballast_tank_logs, delta.ballast_tank_logs))
+        changed |= BallastTanks;
+
+    return changed;
 }
 
-VoyageLogs MockApiService::parseVoyageLogs(const QJsonObject& obj)
-{
-    VoyageLogs logs;
-    logs.log_id = obj["log_id"].toInt();
-    logs.voyage_id = obj["voyage_id"].toString();
-    logs.timestamp = obj["timestamp"].toString();
-    logs.latitude = obj["latitude"].toDouble();
-    logs.longitude = obj["longitude"].toDouble();
-    logs.ship_speed = obj["ship_speed"].toDouble();
-    logs.course = obj["course"].toInt();
-    logs.wind_speed = obj["wind_speed"].toDouble();
-    logs.sea_state = obj["sea_state"].toDouble();
-    logs.hvac_power = obj["hvac_power"].toDouble();
-    logs.galley_power = obj["galley_power"].toDouble();
-    logs.lighting_power = obj["lighting_power"].toDouble();
-    logs.total_hotel_load = obj["total_hotel_load"].toDouble();
-
-    // Propulsion Logs
-    QJsonArray propulsionArr = obj["propulsion_logs"].toArray();
-    for (auto v : propulsionArr) {
-        QJsonObject p = v.toObject();
-        PropulsionLog log;
-        log.propulsion_log_id = p["propulsion_log_id"].toInt();
-        log.log_id = p["log_id"].toInt();
-        log.engine_id = p["engine_id"].toString();
-        log.status = p["status"].toString();
-        log.rpm = p["rpm"].toInt();
-        log.engine_load = p["engine_load"].toInt();
-        log.power_output = p["power_output"].toDouble();
-        log.fuel_consumption_rate = p["fuel_consumption_rate"].toDouble();
-        log.exhaust_gas_temp = p["exhaust_gas_temp"].toInt();
-        logs.propulsion_logs.append(log);
-    }
-
-    // Electrical Logs
-    QJsonArray electricalArr = obj["electrical_logs"].toArray();
-    for (auto v : electricalArr) {
-        QJsonObject e = v.toObject();
-        ElectricalLog log;
-        log.electrical_log_id = e["electrical_log_id"].toInt();
-        log.log_id = e["log_id"].toInt();
-        log.generator_id = e["generator_id"].toString();
-        log.status = e["status"].toString();
-        log.gen_load = e["gen_load"].toInt();
-        log.gen_power_output = e["gen_power_output"].toDouble();
-        log.gen_fuel_consumption_rate = e["gen_fuel_consumption_rate"].toDouble();
-        logs.electrical_logs.append(log);
-    }
-
-    // Fuel Tank Logs
-    QJsonArray fuelArr = obj["fuel_tank_logs"].toArray();
-    for (auto v : fuelArr) {
-        QJsonObject f = v.toObject();
-        FuelTankLog log;
-        log.fuel_tank_log_id = f["fuel_tank_log_id"].toInt();
-        log.log_id = f["log_id"].toInt();
-        log.tank_id = f["tank_id"].toString();
-        log.fuel_type = f["fuel_type"].toString();
-        log.fuel_level = f["fuel_level"].toDouble();
-        log.fuel_volume = f["fuel_volume"].toDouble();
-        logs.fuel_tank_logs.append(log);
-    }
-
-    // Ballast Tank Logs
-    QJsonArray ballastArr = obj["ballast_tank_logs"].toArray();
-    for (auto v : ballastArr) {
-        QJsonObject b = v.toObject();
-        BallastTankLog log;
-        log.ballast_tank_log_id = b["ballast_tank_log_id"].toInt();
-        log.log_id = b["log_id"].toInt();
-        log.tank_id = b["tank_id"].toString();
-        log.tank_level = b["tank_level"].toDouble();
-        log.pump_status = b["pump_status"].toString();
-        log.pump_power_consumption = b["pump_power_consumption"].toDouble();
-        logs.ballast_tank_logs.append(log);
-    }
-
-    return logs;
+MockApiService::Subsystems MockApiService::mergeVoyageLogs(const VoyageLogs& delta, Subsystems present,
+                                                           bool* applied)
+{
+    Subsystems changed = NoSubsystem;
+    if (applied)
+        *applied = false;
+
+    // Records older than the merged state (e.g. a late stream frame) are stale
+    const qint64 deltaTimestampMs = TelemetryFrame::parseTimestamp(delta.timestamp);
+    if (m_hasState && deltaTimestampMs > 0 && deltaTimestampMs < m_stateTimestampMs)
+        return NoSubsystem;
+    if (applied)
+        *applied = true;
+    if (deltaTimestampMs > 0)
+        m_stateTimestampMs = deltaTimestampMs;
+
+    if (!m_hasState) {
+        m_state = delta;
+        m_hasState = true;
+        changed = present;
+    } else {
+        m_state.log_id = delta.log_id;
+        m_state.voyage_id = delta.voyage_id;
+        m_state.timestamp = delta.timestamp;
+
+        changed = applyDelta(m_state, delta, present);
+    }
+
+    // Advance the cursor past this record
+    if (!delta.timestamp.isEmpty())
+        m_cursorTimestamp = delta.timestamp;
+    if (delta.log_id > m_cursorLogId)
+        m_cursorLogId = delta.log_id;
+
+    return changed;
+}
+
+void MockApiService::warmStartFromCache()
+{
+    m_stateFromCache = false;
+    if (!m_cache.open(TelemetryCache::defaultPath(m_logId)))
+        return;
+
+    // Replaying merges the cached frames like replies; live data newer than
+    // the last frame then reconciles over them through the normal cursor
+    const QList<VoyageLogs> frames = m_cache.frames();
+    if (frames.isEmpty())
+        return;
+
+    Subsystems changed = NoSubsystem;
+    for (const VoyageLogs &frame : frames)
+        changed |= mergeVoyageLogs(frame, AllSubsystems);
+
+    // Cached frames were recorded when they first arrived
+    m_stateFromCache = m_hasState;
+    emitChanges(changed);
+}
+
+void MockApiService::emitChanges(Subsystems changed)
+{
+    if (changed == NoSubsystem)
+        return;
+
+    // A running replay owns the widgets
+    if (m_replaying)
+        return;
+
+    emitState(m_state, changed);
+    emit frameUpdated(TelemetryFrame::fromVoyageLogs(m_state));
+}
+
+void MockApiService::emitState(const VoyageLogs& state, Subsystems changed)
+{
+    if (changed == NoSubsystem)
+        return;
+
+    if (changed & Propulsion)
+        emit propulsionUpdated(state.propulsion_logs);
+    if (changed & Electrical)
+        emit electricalUpdated(state.electrical_logs);
+    if (changed & FuelTanks)
+        emit fuelTanksUpdated(state.fuel_tank_logs);
+    if (changed & BallastTanks)
+        emit ballastTanksUpdated(state.ballast_tank_logs);
+
+    emit subsystemsChanged(changed);
+    emit dataUpdated(state);
 }
@@ -5,90 +5,121 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QTimer>
-#include <QJsonObject>
+#include <QThreadPool>
+#include <QHash>
+#include <QPointer>
+#include <QElapsedTimer>
 #include <QList>
 #include <QString>
+#include "VoyageLogs.h"
+#include "TelemetryFrame.h"
+#include "TelemetryStreamClient.h"
+#include "LatencyHistogram.h"
+#include "TelemetryCache.h"
 
-// ------------------- Data Models -------------------
-struct PropulsionLog {
-    int propulsion_log_id;
-    int log_id;
-    QString engine_id;
-    QString status;
-    int rpm;
-    int engine_load;
-    double power_output;
-    double fuel_consumption_rate;
-    int exhaust_gas_temp;
-};
-
-struct ElectricalLog {
-    int electrical_log_id;
-    int log_id;
-    QString generator_id;
-    QString status;
-    int gen_load;
-    double gen_power_output;
-    double gen_fuel_consumption_rate;
-};
-
-struct FuelTankLog {
-    int fuel_tank_log_id;
-    int log_id;
-    QString tank_id;
-    QString fuel_type;
-    double fuel_level;
-    double fuel_volume;
-};
-
-struct BallastTankLog {
-    int ballast_tank_log_id;
-    int log_id;
-    QString tank_id;
-    double tank_level;
-    QString pump_status;
-    double pump_power_consumption;
-};
-
-struct VoyageLogs {
-    int log_id;
-    QString voyage_id;
-    QString timestamp;
-    double latitude;
-    double longitude;
-    double ship_speed;
-    int course;
-    double wind_speed;
-    double sea_state;
-    double hvac_power;
-    double galley_power;
-    double lighting_power;
-    double total_hotel_load;
-
-    QString air_temperature;
-    QString humidity;
-    QString barometric_pressure;
-
-    QList<PropulsionLog> propulsion_logs;
-    QList<ElectricalLog> electrical_logs;
-    QList<FuelTankLog> fuel_tank_logs;
-    QList<BallastTankLog> ballast_tank_logs;
-};
+struct DecodedVoyageLogs;
+class TelemetryGapRecovery;
+class TelemetryReplay;
+class TelemetryCompactor;
 
 // ------------------- Service -------------------
 class MockApiService : public QObject
 {
     Q_OBJECT
 public:
+    // Groups of VoyageLogs fields that change independently of each other.
+    enum Subsystem {
+        NoSubsystem   = 0x00,
+        Navigation    = 0x01, // position, speed, course
+        Weather       = 0x02, // wind, sea state, air temperature, humidity, pressure
+        HotelLoad     = 0x04, // hvac, galley, lighting, total hotel load
+        Propulsion    = 0x08,
+        Electrical    = 0x10,
+        FuelTanks     = 0x20,
+        BallastTanks  = 0x40,
+        AllSubsystems = 0x7F
+    };
+    Q_DECLARE_FLAGS(Subsystems, Subsystem)
+    Q_FLAG(Subsystems)
+
     static MockApiService* instance();
-    void startPolling(int logId, int intervalMs = 5000);
+    void setLogId(int logId);
+
+    // Reference-counted subscriptions. Each subscriber declares the subsystems
+    // it displays and the slowest refresh it can live with; the service fetches
+    // the union of fields at the fastest requested rate, and stops fetching when
+    // the last subscriber unsubscribes or is destroyed.
+    void subscribe(QObject* subscriber, Subsystems fields, int maxIntervalMs = 5000);
+    void unsubscribe(QObject* subscriber);
+    int subscriberCount() const { return m_subscriptions.size(); }
+    Subsystems plannedFields() const { return m_planFields; }
+    int plannedIntervalMs() const { return m_pollIntervalMs; }
+
+    // Push-based telemetry over MQTT; HTTPS polling resumes while the stream is down
+    void startStreaming(const QString& host, quint16 port);
+    void stopStreaming();
+    bool isStreaming() const { return m_stream->isConnected(); }
+
+    // Sensor timestamp to dataUpdated emission for the most recent frame
+    qint64 lastLatencyMs() const { return m_lastLatencyMs; }
+
+    // Merged view of every record received so far for the current log id,
+    // or of the replayed frames while a replay is running
+    const VoyageLogs& currentState() const { return m_replaying ? m_replayState : m_state; }
+    bool hasState() const { return m_hasState; }
+
+    // True while the state still comes from the warm-start cache only
+    bool stateIsCached() const { return m_stateFromCache; }
+
+    // Store-and-forward catch-up after link loss
+    TelemetryGapRecovery* gapRecovery() const { return m_recovery; }
+
+    // Recorded history played back in place of the live feed. Widgets and
+    // frame consumers see the replayed frames; live data keeps being
+    // recorded in the background and is shown again when the replay stops.
+    bool startReplay(qint64 fromMs, qint64 toMs);
+    void stopReplay();
+    bool isReplaying() const { return m_replaying; }
+    TelemetryReplay* replay() const { return m_replay; }
+
+    // Total JSON decoding time moved off the GUI thread since start-up
+    double mainThreadMsSaved() const;
+
+    // Content negotiation: ask for CBOR first, falling back to JSON
+    void setPreferCbor(bool prefer);
+    bool preferCbor() const { return m_preferCbor; }
+
+    // Request round trip, worker decode time and decoder queue wait
+    const LatencyHistogram& rttHistogram() const { return m_rttHistogram; }
+    const LatencyHistogram& parseHistogram() const { return m_parseHistogram; }
+    const LatencyHistogram& queueDelayHistogram() const { return m_queueDelayHistogram; }
+
+    // Poll period after stretching for a slow link (>= plannedIntervalMs)
+    int effectiveIntervalMs() const { return m_timer->interval(); }
 
 signals:
     void dataUpdated(const VoyageLogs& data);
 
+    // Same sample in columnar form with interned ids, for history and analytics
+    void frameUpdated(const TelemetryFrame& frame);
+
+    // Emitted only for subsystems whose values actually changed in the last poll
+    void subsystemsChanged(MockApiService::Subsystems changed);
+    void propulsionUpdated(const QList<PropulsionLog>& logs);
+    void electricalUpdated(const QList<ElectricalLog>& logs);
+    void fuelTanksUpdated(const QList<FuelTankLog>& logs);
+    void ballastTanksUpdated(const QList<BallastTankLog>& logs);
+
+    void streamingStateChanged(bool streaming);
+    void replayingChanged(bool replaying);
+    void fetchPlanChanged(MockApiService::Subsystems fields, int intervalMs);
+
 private slots:
     void fetchVoyageLogs();
     void onReplyFinished(QNetworkReply* reply);
+    void onStreamConnected();
+    void onStreamDisconnected();
+    void onStreamFrame(const QByteArray& payload);
 
 private:
     explicit MockApiService(QObject *parent = nullptr);
@@ -97,8 +128,75 @@ private:
     QNetworkAccessManager* m_manager;
     QTimer* m_timer;
     int m_logId;
+    int m_pollIntervalMs;
+
+    // Subscription registry and the merged fetch plan derived from it
+    struct Subscription {
+        Subsystems fields;
+        int intervalMs;
+    };
+    QHash<QObject*, Subscription> m_subscriptions;
+    Subsystems m_planFields;
+    QString m_streamHost;
+    quint16 m_streamPort;
+
+    TelemetryStreamClient* m_stream;
+    qint64 m_lastLatencyMs;
+
+    // Delta polling: only records newer than the cursor are requested
+    VoyageLogs m_state;
+    bool m_hasState;
+    QString m_cursorTimestamp;
+    int m_cursorLogId;
 
-    VoyageLogs parseVoyageLogs(const QJsonObject& obj);
+    // Off-GUI-thread decoding
+    QThreadPool* m_decoderPool;
+    qint64 m_decodeNsOffloaded;
+
+    bool m_preferCbor;
+
+    // One request in flight, latest reply wins
+    QPointer<QNetworkReply> m_inFlight;
+    bool m_fetchPending;
+    quint64 m_requestSeq;
+    quint64 m_appliedSeq;
+    qint64 m_stateTimestampMs;
+    qint64 m_recordedMs;        // newest frame put into the history
+    QElapsedTimer m_clock;
+
+    LatencyHistogram m_rttHistogram;
+    LatencyHistogram m_parseHistogram;
+    LatencyHistogram m_queueDelayHistogram;
+
+    // Last frames of the current stream, replayed on start-up
+    TelemetryCache m_cache;
+    bool m_stateFromCache;
+
+    // Missed intervals, replayed into frameUpdated from their own running state
+    TelemetryGapRecovery* m_recovery;
+    VoyageLogs m_backfillState;
+
+    TelemetryReplay* m_replay;
+    bool m_replaying;
+    VoyageLogs m_replayState;
+
+    // Archives, merges and ages out the local history in the background
+    TelemetryCompactor* m_compactor;
+
+    void applyFetchPlan();
+    void handleReply(QNetworkReply* reply);
+    void adaptPollInterval(qint64 rttMs);
+    void onRecordsDecoded(const DecodedVoyageLogs& decoded, quint64 seq);
+    // applied is false for a stale record, which leaves the state alone
+    Subsystems mergeVoyageLogs(const VoyageLogs& delta, Subsystems present, bool* applied = nullptr);
+    static Subsystems applyDelta(VoyageLogs& state, const VoyageLogs& delta, Subsystems present);
+    void onRecordRecovered(const VoyageLogs& delta, Subsystems present);
+    void onReplayFrames(const QVector<TelemetryFrame>& frames);
+    void emitChanges(Subsystems changed);
+    void emitState(const VoyageLogs& state, Subsystems changed);
+    void warmStartFromCache();
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(MockApiService::Subsystems)
+
 #endif // MOCKAPISERVICE_H
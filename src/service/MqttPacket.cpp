@@ -0,0 +1,124 @@
+#include "MqttPacket.h"
+
+namespace {
+
+void appendUInt16(QByteArray& out, quint16 value)
+{
+    out.append(static_cast<char>((value >> 8) & 0xFF));
+    out.append(static_cast<char>(value & 0xFF));
+}
+
+void appendString(QByteArray& out, const QString& text)
+{
+    QByteArray utf8 = text.toUtf8();
+    appendUInt16(out, static_cast<quint16>(utf8.size()));
+    out.append(utf8);
+}
+
+QByteArray frame(quint8 header, const QByteArray& body)
+{
+    QByteArray out;
+    out.reserve(body.size() + 5);
+    out.append(static_cast<char>(header));
+
+    // Remaining length: 7 bits per byte, high bit means "more bytes follow"
+    int length = body.size();
+    do {
+        quint8 digit = length % 128;
+        length /= 128;
+        if (length > 0)
+            digit |= 0x80;
+        out.append(static_cast<char>(digit));
+    } while (length > 0);
+
+    out.append(body);
+    return out;
+}
+
+} // namespace
+
+namespace Mqtt {
+
+QByteArray connectPacket(const QString& clientId, quint16 keepAliveSecs)
+{
+    QByteArray body;
+    appendString(body, QStringLiteral("MQTT"));
+    body.append(static_cast<char>(4));      // protocol level 3.1.1
+    body.append(static_cast<char>(0x02));   // clean session
+    appendUInt16(body, keepAliveSecs);
+    appendString(body, clientId);
+    return frame(Connect, body);
+}
+
+QByteArray subscribePacket(quint16 packetId, const QString& topicFilter)
+{
+    QByteArray body;
+    appendUInt16(body, packetId);
+    appendString(body, topicFilter);
+    body.append(static_cast<char>(0));      // requested QoS 0
+    return frame(Subscribe | 0x02, body);
+}
+
+QByteArray pingReqPacket()
+{
+    return frame(PingReq, QByteArray());
+}
+
+QByteArray disconnectPacket()
+{
+    return frame(Disconnect, QByteArray());
+}
+
+bool takePacket(QByteArray& buffer, quint8* header, QByteArray* body)
+{
+    if (buffer.size() < 2)
+        return false;
+
+    int length = 0;
+    int multiplier = 1;
+    int pos = 1;
+    while (true) {
+        if (pos >= buffer.size())
+            return false;
+        quint8 digit = static_cast<quint8>(buffer.at(pos++));
+        length += (digit & 0x7F) * multiplier;
+        if (!(digit & 0x80))
+            break;
+        multiplier *= 128;
+        if (pos > 4) {
+            // Malformed length; drop what we have so the stream can resync
+            buffer.clear();
+            return false;
+        }
+    }
+
+    if (buffer.size() < pos + length)
+        return false;
+
+    *header = static_cast<quint8>(buffer.at(0));
+    *body = buffer.mid(pos, length);
+    buffer.remove(0, pos + length);
+    return true;
+}
+
+quint16 readUInt16(const QByteArray& body, int* offset)
+{
+    if (*offset + 2 > body.size())
+        return 0;
+    quint16 value = (static_cast<quint8>(body.at(*offset)) << 8)
+                    | static_cast<quint8>(body.at(*offset + 1));
+    *offset += 2;
+    return value;
+}
+
+QString readString(const QByteArray& body, int* offset)
+{
+    int length = readUInt16(body, offset);
+    if (*offset + length > body.size())
+        return QString();
+    QString text = QString::fromUtf8(body.constData() + *offset, length);
+    *offset += length;
+    return text;
+}
+
+} // namespace Mqtt
@@ -0,0 +1,37 @@
+#ifndef MQTTPACKET_H
+#define MQTTPACKET_H
+
+#include <QByteArray>
+#include <QString>
+
+// Minimal MQTT 3.1.1 client framing for TelemetryStreamClient.
+// Only QoS 0 subscriptions are supported.
+namespace Mqtt {
+
+enum PacketType : quint8 {
+    Connect     = 0x10,
+    ConnAck     = 0x20,
+    Publish     = 0x30,
+    Subscribe   = 0x80,
+    SubAck      = 0x90,
+    PingReq     = 0xC0,
+    PingResp    = 0xD0,
+    Disconnect  = 0xE0
+};
+
+QByteArray connectPacket(const QString& clientId, quint16 keepAliveSecs);
+QByteArray subscribePacket(quint16 packetId, const QString& topicFilter);
+QByteArray pingReqPacket();
+QByteArray disconnectPacket();
+
+// Removes one complete packet from the front of buffer.
+// Returns false if the buffer does not hold a full packet yet.
+bool takePacket(QByteArray& buffer, quint8* header, QByteArray* body);
+
+// Reads a length-prefixed UTF-8 string at offset and advances it
+QString readString(const QByteArray& body, int* offset);
+quint16 readUInt16(const QByteArray& body, int* offset);
+
+} // namespace Mqtt
+
+#endif // MQTTPACKET_H
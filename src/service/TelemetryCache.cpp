@@ -0,0 +1,194 @@
+#include "TelemetryCache.h"
+#include "VoyageLogsCbor.h"
+#include "VoyageLogsDecoder.h"
+#include <QCborStreamWriter>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+const quint32 kMagic = 0x43544353;   // "SCTC"
+const quint32 kVersion = 1;
+
+} // namespace
+
+struct TelemetryCache::Header {
+    quint32 magic;
+    quint32 version;
+    quint32 capacity;
+    quint32 slotSize;
+    quint32 next;       // slot the next frame is written to
+    quint32 count;
+    quint64 sequence;   // frames written over the file's lifetime
+};
+
+struct TelemetryCache::SlotHeader {
+    quint64 sequence;
+    quint32 length;
+    quint16 checksum;
+    quint16 reserved;
+};
+
+TelemetryCache::TelemetryCache(int capacity, int slotSize)
+    : m_capacity(qMax(1, capacity)),
+    m_slotSize(qMax(static_cast<int>(sizeof(SlotHeader)) + 256, slotSize)),
+    m_map(nullptr)
+{
+}
+
+TelemetryCache::~TelemetryCache()
+{
+    close();
+}
+
+QString TelemetryCache::defaultPath(int logId)
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(dir).filePath(QString("telemetry-cache-%1.bin").arg(logId));
+}
+
+bool TelemetryCache::open(const QString& path)
+{
+    close();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Telemetry cache: cannot open" << path << m_file.errorString();
+        return false;
+    }
+
+    const qint64 size = qint64(sizeof(Header)) + qint64(m_capacity) * m_slotSize;
+    bool fresh = m_file.size() != size;
+    if (fresh && !m_file.resize(size)) {
+        m_file.close();
+        return false;
+    }
+
+    m_map = m_file.map(0, size);
+    if (!m_map) {
+        qWarning() << "Telemetry cache: cannot map" << path;
+        m_file.close();
+        return false;
+    }
+
+    // A file written with another layout, or whose ring position is out of
+    // range (torn or corrupted header), is discarded rather than migrated
+    const Header* h = header();
+    if (fresh || h->magic != kMagic || h->version != kVersion
+        || h->capacity != quint32(m_capacity) || h->slotSize != quint32(m_slotSize)
+        || h->next >= h->capacity || h->count > h->capacity)
+        return initialise();
+
+    return true;
+}
+
+void TelemetryCache::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool TelemetryCache::initialise()
+{
+    std::memset(m_map, 0, sizeof(Header) + size_t(m_capacity) * m_slotSize);
+
+    Header* h = header();
+    h->magic = kMagic;
+    h->version = kVersion;
+    h->capacity = quint32(m_capacity);
+    h->slotSize = quint32(m_slotSize);
+    return true;
+}
+
+TelemetryCache::Header* TelemetryCache::header() const
+{
+    return reinterpret_cast<Header*>(m_map);
+}
+
+uchar* TelemetryCache::slot(int index) const
+{
+    return m_map + sizeof(Header) + size_t(index) * m_slotSize;
+}
+
+int TelemetryCache::count() const
+{
+    return isOpen() ? int(header()->count) : 0;
+}
+
+QList<VoyageLogs> TelemetryCache::frames() const
+{
+    QList<VoyageLogs> result;
+    if (!isOpen())
+        return result;
+
+    const Header* h = header();
+    const int n = int(qMin(h->count, h->capacity));
+    const int first = (int(h->next) - n + m_capacity) % m_capacity;
+    result.reserve(n);
+
+    quint64 lastSequence = 0;
+    for (int i = 0; i < n; ++i) {
+        const uchar* s = slot((first + i) % m_capacity);
+        SlotHeader sh;
+        std::memcpy(&sh, s, sizeof(sh));
+        if (sh.length == 0 || sh.length > quint32(m_slotSize) - sizeof(SlotHeader)
+            || sh.sequence <= lastSequence)
+            continue;
+
+        // fromRawData: the decoder reads straight out of the mapping
+        const char* payload = reinterpret_cast<const char*>(s + sizeof(SlotHeader));
+        if (qChecksum(QByteArrayView(payload, sh.length)) != sh.checksum)
+            continue;
+
+        DecodedVoyageLogs decoded;
+        if (!VoyageLogsCbor::decode(QByteArray::fromRawData(payload, int(sh.length)), &decoded))
+            continue;
+        result += decoded.records;
+        lastSequence = sh.sequence;
+    }
+    return result;
+}
+
+bool TelemetryCache::append(const VoyageLogs& logs)
+{
+    if (!isOpen())
+        return false;
+
+    QByteArray payload;
+    {
+        QCborStreamWriter writer(&payload);
+        VoyageLogsCbor::encodeRecord(writer, logs);
+    }
+    if (payload.size() > m_slotSize - int(sizeof(SlotHeader))) {
+        qWarning() << "Telemetry cache: frame of" << payload.size() << "bytes exceeds slot size";
+        return false;
+    }
+
+    Header* h = header();
+
+    // Payload first, slot header second, ring header last: a crash part-way
+    // leaves either the previous frame or a slot that fails its checksum
+    uchar* s = slot(int(h->next));
+    std::memcpy(s + sizeof(SlotHeader), payload.constData(), size_t(payload.size()));
+
+    SlotHeader sh;
+    sh.sequence = h->sequence + 1;
+    sh.length = quint32(payload.size());
+    sh.checksum = qChecksum(QByteArrayView(payload));
+    sh.reserved = 0;
+    std::memcpy(s, &sh, sizeof(sh));
+
+    h->sequence = sh.sequence;
+    h->next = (h->next + 1) % quint32(m_capacity);
+    if (h->count < quint32(m_capacity))
+        h->count += 1;
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef TELEMETRYCACHE_H
+#define TELEMETRYCACHE_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include "VoyageLogs.h"
+
+// Ring of the last N merged VoyageLogs frames in a memory-mapped file, so
+// the dashboard can show the previous session's values before the first
+// reply arrives. Each frame is CBOR-encoded into a fixed-size slot; a slot
+// whose checksum does not match (torn write) is skipped on load.
+class TelemetryCache
+{
+public:
+    explicit TelemetryCache(int capacity = 64, int slotSize = 8192);
+    ~TelemetryCache();
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+
+    // Cached frames, oldest first
+    QList<VoyageLogs> frames() const;
+    int count() const;
+
+    // Overwrites the oldest slot; false if the encoded frame does not fit
+    bool append(const VoyageLogs& logs);
+
+    // Per-stream file under the application data directory
+    static QString defaultPath(int logId);
+
+private:
+    struct Header;
+    struct SlotHeader;
+
+    Header* header() const;
+    uchar* slot(int index) const;
+    bool initialise();
+
+    int m_capacity;
+    int m_slotSize;
+    QFile m_file;
+    uchar* m_map;
+};
+
+#endif // TELEMETRYCACHE_H
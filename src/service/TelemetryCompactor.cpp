@@ -0,0 +1,134 @@
+#include "TelemetryCompactor.h"
+#include "TelemetryStore.h"
+#include "TelemetryRollups.h"
+#include <QSettings>
+#include <QThread>
+#include <QPointer>
+#include <QMetaObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+
+const qint64 kDayMs = 86400000;
+
+} // namespace
+
+TelemetryCompactor::Policy TelemetryCompactor::Policy::fromSettings()
+{
+    Policy policy;
+    QSettings settings;
+    policy.rawRetentionDays = settings.value("history/rawRetentionDays", policy.rawRetentionDays).toInt();
+    policy.maxBytes = settings.value("history/maxSizeMB", policy.maxBytes >> 20).toLongLong() << 20;
+    policy.ioBytesPerSecond = settings.value("history/compactionMBps", policy.ioBytesPerSecond >> 20).toLongLong() << 20;
+    return policy;
+}
+
+TelemetryCompactor::TelemetryCompactor(QObject *parent)
+    : QObject(parent),
+    m_pool(new QThreadPool(this)),
+    m_timer(new QTimer(this)),
+    m_running(false)
+{
+    m_pool->setMaxThreadCount(1);
+    connect(m_timer, &QTimer::timeout, this, &TelemetryCompactor::runNow);
+}
+
+TelemetryCompactor::~TelemetryCompactor()
+{
+    stop();
+}
+
+void TelemetryCompactor::start(int delayMs, int intervalMs)
+{
+    m_timer->start(intervalMs);
+    QTimer::singleShot(delayMs, this, &TelemetryCompactor::runNow);
+}
+
+void TelemetryCompactor::stop()
+{
+    m_timer->stop();
+    if (m_cancelled)
+        m_cancelled->storeRelaxed(1);
+    m_pool->waitForDone();
+}
+
+void TelemetryCompactor::runNow()
+{
+    if (m_running)
+        return;
+
+    m_running = true;
+    m_cancelled = QSharedPointer<QAtomicInt>::create(0);
+
+    const Policy policy = Policy::fromSettings();
+    QPointer<TelemetryCompactor> receiver(this);
+    QSharedPointer<QAtomicInt> cancelled = m_cancelled;
+    m_pool->start([=]() {
+        // Only runs when nothing else wants the CPU
+        QThread::currentThread()->setPriority(QThread::IdlePriority);
+        const Stats stats = compact(policy, cancelled.data());
+
+        if (!receiver)
+            return;
+        QMetaObject::invokeMethod(receiver.data(), [receiver, stats]() {
+            if (!receiver)
+                return;
+            receiver->m_running = false;
+            receiver->m_stats = stats;
+            emit receiver->finished(stats);
+        }, Qt::QueuedConnection);
+    });
+}
+
+TelemetryCompactor::Stats TelemetryCompactor::compact(const Policy& policy, const QAtomicInt* cancelled)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    TelemetryStore &store = TelemetryStore::instance();
+    TelemetryRollups &rollups = TelemetryRollups::instance();
+    Stats stats;
+    stats.bytesBefore = store.diskBytes();
+
+    // Sleeps after each file until the pass is back under its I/O budget
+    qint64 ioBytes = 0;
+    const TelemetryStore::Pace pace = [&](qint64 bytes) {
+        ioBytes += bytes;
+        if (policy.ioBytesPerSecond > 0) {
+            const qint64 dueMs = ioBytes * 1000 / policy.ioBytesPerSecond;
+            while (!cancelled->loadRelaxed() && timer.elapsed() < dueMs)
+                QThread::msleep(ulong(qMin<qint64>(100, dueMs - timer.elapsed())));
+        }
+        return cancelled->loadRelaxed() == 0;
+    };
+
+    stats.archived = store.archiveSealedSegments(pace);
+    if (!cancelled->loadRelaxed())
+        stats.merged = store.mergeSealedDays(pace);
+
+    // Raw rows may only go once the rollups holding their aggregates are
+    // safely on disk
+    const qint64 coveredMs = rollups.coveredUntilMs();
+    const bool retention = policy.rawRetentionDays > 0;
+    const bool cap = policy.maxBytes > 0 && store.diskBytes() > policy.maxBytes;
+    if (!cancelled->loadRelaxed() && (retention || cap) && rollups.save()) {
+        if (retention) {
+            const qint64 cutoffMs = QDateTime::currentMSecsSinceEpoch() - policy.rawRetentionDays * kDayMs;
+            stats.dropped += store.dropSealedBefore(qMin(cutoffMs, coveredMs + 1));
+        }
+        if (cap)
+            stats.dropped += store.trimToSize(policy.maxBytes, coveredMs);
+    }
+
+    stats.bytesAfter = store.diskBytes();
+    stats.elapsedNs = timer.nsecsElapsed();
+    if (stats.archived || stats.merged || stats.dropped) {
+        qInfo().nospace() << "TelemetryCompactor: archived " << stats.archived << ", merged "
+                          << stats.merged << " days, dropped " << stats.dropped << " segments, "
+                          << stats.bytesBefore << " -> " << stats.bytesAfter << " bytes in "
+                          << stats.elapsedNs / 1000000 << " ms";
+    }
+    return stats;
+}
@@ -0,0 +1,74 @@
+#ifndef TELEMETRYCOMPACTOR_H
+#define TELEMETRYCOMPACTOR_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QTimer>
+
+// ------------------- Compaction and retention -------------------
+// Keeps the local history small without getting in the way of the live
+// feed. Each pass, on a single idle-priority thread with its disk traffic
+// capped at a few MB/s:
+//   1. archives sealed raw segments (past UTC days),
+//   2. merges the segments of each past day (restarts, gap-recovery heads
+//      and imports leave several) into one archive, which also compresses
+//      better than the pieces,
+//   3. drops raw rows older than the retention age; the rollup pyramid
+//      keeps their hour and day aggregates,
+//   4. drops the oldest sealed segments while the history is over its
+//      size cap.
+// Raw rows the rollups have not seen yet are never dropped.
+//
+// Settings (QSettings): history/rawRetentionDays (0 keeps everything),
+// history/maxSizeMB (0 for no cap) and history/compactionMBps.
+class TelemetryCompactor : public QObject
+{
+    Q_OBJECT
+public:
+    struct Policy {
+        int rawRetentionDays = 365;
+        qint64 maxBytes = qint64(4096) << 20;
+        qint64 ioBytesPerSecond = qint64(8) << 20;
+
+        static Policy fromSettings();
+    };
+
+    struct Stats {
+        int archived = 0;
+        int merged = 0;
+        int dropped = 0;
+        qint64 bytesBefore = 0;
+        qint64 bytesAfter = 0;
+        qint64 elapsedNs = 0;
+    };
+
+    explicit TelemetryCompactor(QObject *parent = nullptr);
+    ~TelemetryCompactor();
+
+    // First pass after delayMs, then every intervalMs
+    void start(int delayMs = 2 * 60 * 1000, int intervalMs = 60 * 60 * 1000);
+    void stop();
+    bool isRunning() const { return m_running; }
+    Stats lastStats() const { return m_stats; }
+
+    // Synchronous form; returns early once cancelled is set
+    static Stats compact(const Policy& policy, const QAtomicInt* cancelled);
+
+public slots:
+    // Ignored while a pass is running
+    void runNow();
+
+signals:
+    void finished(const TelemetryCompactor::Stats& stats);
+
+private:
+    QThreadPool* m_pool;
+    QTimer* m_timer;
+    bool m_running;
+    Stats m_stats;
+    QSharedPointer<QAtomicInt> m_cancelled;
+};
+
+#endif // TELEMETRYCOMPACTOR_H
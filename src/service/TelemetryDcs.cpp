@@ -0,0 +1,652 @@
+#include "TelemetryDcs.h"
+#include "TelemetryStore.h"
+#include <QDir>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QSet>
+#include <QDebug>
+#include <QtNumeric>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+const quint32 kMagic = 0x53434443;   // "SCDC"
+const quint32 kVersion = 3;
+const qint64 kHourMs = 3600 * 1000;
+const qint64 kDayMs = 24 * kHourMs;
+const qint64 kLongLegMs = 6 * kHourMs;      // logged as a gap in the data
+const double kUnderwayKnots = 1.0;
+// A net rise in a fuel type's tanks beyond this, or one not used up within
+// this long, is bunkering rather than sounding noise
+const double kBunkeringM3 = 2.0;
+const qint64 kBunkeringMs = 2 * kHourMs;
+const double kEarthRadiusNm = 3440.065;
+
+qint64 floorTo(qint64 timestampMs, qint64 bucketMs)
+{
+    qint64 q = timestampMs / bucketMs;
+    if (timestampMs < 0 && q * bucketMs != timestampMs)
+        --q;
+    return q * bucketMs;
+}
+
+double greatCircleNm(double lat1, double lon1, double lat2, double lon2)
+{
+    const double dLat = qDegreesToRadians(lat2 - lat1);
+    const double dLon = qDegreesToRadians(lon2 - lon1);
+    const double a = qSin(dLat / 2) * qSin(dLat / 2)
+                     + qCos(qDegreesToRadians(lat1)) * qCos(qDegreesToRadians(lat2))
+                       * qSin(dLon / 2) * qSin(dLon / 2);
+    return 2.0 * kEarthRadiusNm * qAtan2(qSqrt(a), qSqrt(1.0 - a));
+}
+
+void writeFigures(QDataStream& out, const DcsFigures& figures)
+{
+    out << figures.firstMs << figures.lastMs << figures.distanceNm << figures.hoursUnderway
+        << figures.fuelTonnes;
+}
+
+void readFigures(QDataStream& in, DcsFigures* figures)
+{
+    in >> figures->firstMs >> figures->lastMs >> figures->distanceNm >> figures->hoursUnderway
+       >> figures->fuelTonnes;
+}
+
+void merge(DcsFigures* into, const DcsFigures& part)
+{
+    if (part.isEmpty())
+        return;
+    if (into->firstMs == 0 || part.firstMs < into->firstMs)
+        into->firstMs = part.firstMs;
+    into->lastMs = qMax(into->lastMs, part.lastMs);
+    into->distanceNm += part.distanceNm;
+    into->hoursUnderway += part.hoursUnderway;
+    for (auto it = part.fuelTonnes.constBegin(); it != part.fuelTonnes.constEnd(); ++it)
+        into->fuelTonnes[it.key()] += it.value();
+}
+
+int utcYear(qint64 timestampMs)
+{
+    return QDateTime::fromMSecsSinceEpoch(timestampMs, Qt::UTC).date().year();
+}
+
+// Voyages by first frame, for giving rebuilt frames a voyage
+struct VoyageSpan {
+    qint64 lastMs;
+    QString name;
+};
+
+QString voyageAt(const QMap<qint64, VoyageSpan>& spans, qint64 timestampMs)
+{
+    auto it = spans.upperBound(timestampMs);
+    if (it == spans.constBegin())
+        return QString();
+    --it;
+    return timestampMs <= it.value().lastMs ? it.value().name : QString();
+}
+
+} // namespace
+
+// ------------------- DcsFigures -------------------
+
+double DcsFigures::totalFuelTonnes() const
+{
+    double total = 0.0;
+    for (double tonnes : fuelTonnes)
+        total += tonnes;
+    return total;
+}
+
+double DcsFigures::co2Tonnes() const
+{
+    double total = 0.0;
+    for (auto it = fuelTonnes.constBegin(); it != fuelTonnes.constEnd(); ++it)
+        total += it.value() * TelemetryDcs::carbonFactor(it.key());
+    return total;
+}
+
+// ------------------- TelemetryDcs -------------------
+
+TelemetryDcs::TelemetryDcs()
+    : m_path(QDir(TelemetryStore::defaultDirectory()).filePath("dcs.dat")),
+    m_lateFromMs(0),
+    m_lateToMs(0),
+    m_dayStartMs(-1),
+    m_year(0),
+    m_lastSavedHour(0),
+    m_version(0)
+{
+    load();
+}
+
+TelemetryDcs::~TelemetryDcs()
+{
+}
+
+TelemetryDcs& TelemetryDcs::instance()
+{
+    static TelemetryDcs dcs;
+    return dcs;
+}
+
+double TelemetryDcs::carbonFactor(const QString& fuelType)
+{
+    // MEPC.308(73) Cf values
+    const QString type = fuelType.toUpper();
+    if (type.contains("LNG"))
+        return 2.750;
+    if (type.contains("METHANOL"))
+        return 1.375;
+    if (type.contains("ETHANOL"))
+        return 1.913;
+    if (type.contains("BUTANE"))
+        return 3.030;
+    if (type.contains("LPG") || type.contains("PROPANE"))
+        return 3.000;
+    if (type.contains("LFO") || type.contains("LSFO"))
+        return 3.151;
+    if (type.contains("HFO") || type.contains("HSFO"))
+        return 3.114;
+    return 3.206;      // MDO/MGO, and anything unrecognised
+}
+
+double TelemetryDcs::density(const QString& fuelType)
+{
+    // Typical bunker densities at 15 °C
+    const QString type = fuelType.toUpper();
+    if (type.contains("LNG"))
+        return 0.450;
+    if (type.contains("METHANOL") || type.contains("ETHANOL"))
+        return 0.790;
+    if (type.contains("LPG") || type.contains("PROPANE") || type.contains("BUTANE"))
+        return 0.550;
+    if (type.contains("LFO") || type.contains("LSFO"))
+        return 0.960;
+    if (type.contains("HFO") || type.contains("HSFO"))
+        return 0.991;
+    return 0.890;
+}
+
+DcsFigures TelemetryDcs::advance(Cursor* cursor, const Reading& reading, const QVector<Tank>& tanks)
+{
+    DcsFigures leg;
+    leg.firstMs = reading.timestampMs;
+    leg.lastMs = reading.timestampMs;
+
+    // Leg from the previous reading
+    const bool hasFix = reading.latitude != 0.0 || reading.longitude != 0.0;
+    const bool hadFix = cursor->lastLatitude != 0.0 || cursor->lastLongitude != 0.0;
+    const bool underway = reading.shipSpeed >= kUnderwayKnots;
+    if (cursor->lastMs > 0) {
+        const qint64 legMs = reading.timestampMs - cursor->lastMs;
+        // Position jitter alongside is not distance sailed
+        if (hasFix && hadFix && (underway || cursor->lastUnderway))
+            leg.distanceNm = greatCircleNm(cursor->lastLatitude, cursor->lastLongitude,
+                                           reading.latitude, reading.longitude);
+        if (underway && cursor->lastUnderway)
+            leg.hoursUnderway = legMs / double(kHourMs);
+
+        if (legMs > kLongLegMs) {
+            qInfo().noquote() << QString("TelemetryDcs: no data from %1 to %2 (%3 h); counted as %4 nm")
+                                     .arg(QDateTime::fromMSecsSinceEpoch(cursor->lastMs, Qt::UTC).toString(Qt::ISODate))
+                                     .arg(QDateTime::fromMSecsSinceEpoch(reading.timestampMs, Qt::UTC).toString(Qt::ISODate))
+                                     .arg(legMs / double(kHourMs), 0, 'f', 1)
+                                     .arg(leg.distanceNm, 0, 'f', 1);
+        }
+    }
+
+    // Change per fuel type since each tank's last sounding: a transfer is
+    // a drop in one tank and an equal rise in another
+    QHash<QString, double> dropped;
+    for (int i = 0; i < reading.tankVolume.size(); ++i) {
+        const double volume = reading.tankVolume.at(i);
+        if (qIsNaN(volume))
+            continue;
+        const Tank tank = i < tanks.size() ? tanks.at(i) : Tank{QString("FT-%1").arg(i + 1), QString()};
+        auto it = cursor->tankVolume.find(tank.name);
+        if (it == cursor->tankVolume.end()) {
+            cursor->tankVolume.insert(tank.name, volume);
+            continue;
+        }
+        dropped[tank.fuelType] += it.value() - volume;
+        it.value() = volume;
+    }
+
+    // Noise rises are carried and cancel later drops instead of being
+    // thrown away, which would count every downward wobble as fuel
+    for (auto it = dropped.constBegin(); it != dropped.constEnd(); ++it) {
+        double &balance = cursor->fuelBalance[it.key()];
+        balance += it.value();
+        if (balance > 0.0) {
+            leg.fuelTonnes.insert(it.key(), balance * density(it.key()));
+            balance = 0.0;
+            cursor->risingSinceMs.remove(it.key());
+        } else if (balance < 0.0) {
+            const qint64 since = cursor->risingSinceMs.value(it.key(), reading.timestampMs);
+            cursor->risingSinceMs.insert(it.key(), since);
+            if (-balance > kBunkeringM3 || reading.timestampMs - since > kBunkeringMs) {
+                balance = 0.0;
+                cursor->risingSinceMs.remove(it.key());
+            }
+        }
+    }
+
+    if (hasFix) {
+        cursor->lastLatitude = reading.latitude;
+        cursor->lastLongitude = reading.longitude;
+    }
+    cursor->lastUnderway = underway;
+    cursor->lastMs = reading.timestampMs;
+    return leg;
+}
+
+void TelemetryDcs::add(const TelemetryFrame& frame)
+{
+    if (frame.timestampMs <= 0)
+        return;
+
+    const TelemetryIdTable &ids = TelemetryIdTable::instance();
+    bool saveNow = false;
+    {
+        QWriteLocker locker(&m_lock);
+        // Late (gap recovery): its day is refolded by rebuildLateDays()
+        if (frame.timestampMs <= m_cursor.lastMs) {
+            m_lateFromMs = m_lateFromMs > 0 ? qMin(m_lateFromMs, frame.timestampMs) : frame.timestampMs;
+            m_lateToMs = qMax(m_lateToMs, frame.timestampMs + 1);
+            return;
+        }
+
+        const TelemetryFrame::FuelTanks &tanks = frame.fuelTanks;
+        if (m_tanks.size() < tanks.size())
+            m_tanks.resize(tanks.size());
+        for (int i = 0; i < tanks.size(); ++i) {
+            m_tanks[i].name = ids.name(tanks.tankId.at(i));
+            m_tanks[i].fuelType = ids.name(tanks.fuelType.at(i));
+        }
+
+        Reading reading;
+        reading.timestampMs = frame.timestampMs;
+        reading.latitude = frame.latitude;
+        reading.longitude = frame.longitude;
+        reading.shipSpeed = frame.shipSpeed;
+        reading.tankVolume = tanks.fuelVolume;
+        const DcsFigures leg = advance(&m_cursor, reading, m_tanks);
+
+        const qint64 dayStart = floorTo(frame.timestampMs, kDayMs);
+        if (dayStart != m_dayStartMs) {
+            m_dayStartMs = dayStart;
+            m_year = utcYear(dayStart);
+        }
+        merge(&m_years[m_year], leg);
+        merge(&m_days[dayStart], leg);
+        const QString voyage = frame.voyageId ? ids.name(frame.voyageId) : QString();
+        if (!voyage.isEmpty()) {
+            merge(&m_voyages[voyage], leg);
+            merge(&m_dayVoyages[dayStart][voyage], leg);
+        }
+        ++m_version;
+
+        const qint64 hour = floorTo(frame.timestampMs, kHourMs);
+        if (hour > m_lastSavedHour) {
+            m_lastSavedHour = hour;
+            saveNow = true;
+        }
+    }
+
+    if (saveNow)
+        QThreadPool::globalInstance()->start([this]() { save(); });
+}
+
+QVector<TelemetryDcs::Reading> TelemetryDcs::readHistory(qint64 fromMs, qint64 toMs)
+{
+    const TelemetryStore &store = TelemetryStore::instance();
+    QVector<Reading> readings;
+    if (toMs <= fromMs || !store.isOpen())
+        return readings;
+
+    // One read per column, then rows regrouped by timestamp
+    QMap<qint64, Reading> rows;
+    const QList<quint32> keys = store.columnKeys();
+    for (quint32 key : keys) {
+        const TelemetryChannel channel = static_cast<TelemetryChannel>(key >> 16);
+        const int slot = int(key & 0xFFFF);
+        if (channel != TelemetryChannel::Latitude && channel != TelemetryChannel::Longitude
+            && channel != TelemetryChannel::ShipSpeed && channel != TelemetryChannel::FuelVolume)
+            continue;
+        QVector<qint64> timestamps;
+        QVector<float> values;
+        if (store.read(channel, slot, fromMs, toMs, &timestamps, &values) == 0)
+            continue;
+
+        for (int i = 0; i < timestamps.size(); ++i) {
+            const double value = values.at(i);
+            Reading &row = rows[timestamps.at(i)];
+            switch (channel) {
+            case TelemetryChannel::Latitude:
+                row.latitude = qIsNaN(value) ? 0.0 : value;
+                break;
+            case TelemetryChannel::Longitude:
+                row.longitude = qIsNaN(value) ? 0.0 : value;
+                break;
+            case TelemetryChannel::ShipSpeed:
+                row.shipSpeed = qIsNaN(value) ? 0.0 : value;
+                break;
+            default:
+                while (row.tankVolume.size() <= slot)
+                    row.tankVolume.append(qQNaN());
+                row.tankVolume[slot] = value;
+                break;
+            }
+        }
+    }
+
+    readings.reserve(rows.size());
+    for (auto it = rows.begin(); it != rows.end(); ++it) {
+        it.value().timestampMs = it.key();
+        readings.append(it.value());
+    }
+    return readings;
+}
+void TelemetryDcs::rebuild(qint64 fromMs, qint64 toMs)
+{
+    if (toMs <= fromMs || !TelemetryStore::instance().isOpen())
+        return;
+    QMutexLocker rebuilding(&m_rebuildMutex);
+
+    // Called with m_lock held
+    auto voyageSpans = [this]() {
+        QMap<qint64, VoyageSpan> spans;
+        for (auto it = m_voyages.constBegin(); it != m_voyages.constEnd(); ++it)
+            spans.insert(it.value().firstMs, VoyageSpan{it.value().lastMs, it.key()});
+        return spans;
+    };
+
+    QVector<Tank> tanks;
+    QMap<qint64, VoyageSpan> spans;
+    {
+        QReadLocker locker(&m_lock);
+        tanks = m_tanks;
+        spans = voyageSpans();
+    }
+
+    // The first leg starts from the last reading of the day before
+    const qint64 firstDay = floorTo(fromMs, kDayMs);
+    Cursor cursor;
+    const QVector<Reading> before = readHistory(firstDay - kDayMs, firstDay);
+    if (!before.isEmpty())
+        advance(&cursor, before.last(), tanks);
+
+    for (qint64 day = firstDay; day < toMs; day += kDayMs) {
+        const qint64 dayEnd = day + kDayMs;
+        DcsFigures figures;
+        QHash<QString, DcsFigures> shares;
+        int folded = 0;
+        auto fold = [&](const QVector<Reading>& readings) {
+            folded += readings.size();
+            for (const Reading &reading : readings) {
+                const DcsFigures leg = advance(&cursor, reading, tanks);
+                merge(&figures, leg);
+                const QString voyage = voyageAt(spans, reading.timestampMs);
+                if (!voyage.isEmpty())
+                    merge(&shares[voyage], leg);
+            }
+        };
+        fold(readHistory(day, dayEnd));
+
+        QWriteLocker locker(&m_lock);
+
+        // Frames add() has taken since the day was read
+        const qint64 readUntil = qMax(day, cursor.lastMs + 1);
+        const qint64 liveUntil = qMin(m_cursor.lastMs + 1, dayEnd);
+        if (liveUntil > readUntil) {
+            spans = voyageSpans();
+            fold(readHistory(readUntil, liveUntil));
+        }
+        // Figures of a day the history no longer holds are kept as they are
+        if (folded == 0)
+            continue;
+
+        QSet<QString> voyages;
+        const QHash<QString, DcsFigures> previous = m_dayVoyages.value(day);
+        for (auto it = previous.constBegin(); it != previous.constEnd(); ++it)
+            voyages.insert(it.key());
+        for (auto it = shares.constBegin(); it != shares.constEnd(); ++it)
+            voyages.insert(it.key());
+
+        if (figures.isEmpty())
+            m_days.remove(day);
+        else
+            m_days.insert(day, figures);
+        if (shares.isEmpty())
+            m_dayVoyages.remove(day);
+        else
+            m_dayVoyages.insert(day, shares);
+        recomputeYear(utcYear(day));
+        for (const QString &voyage : voyages)
+            recomputeVoyage(voyage);
+
+        // Rows newer than any frame add() has seen (an import) move the
+        // live legs on to the end of them
+        if (cursor.lastMs >= m_cursor.lastMs)
+            m_cursor = cursor;
+        ++m_version;
+    }
+}
+
+void TelemetryDcs::rebuildLateDays()
+{
+    qint64 fromMs;
+    qint64 toMs;
+    {
+        QReadLocker locker(&m_lock);
+        fromMs = m_lateFromMs;
+        toMs = m_lateToMs;
+    }
+    if (toMs <= fromMs)
+        return;
+
+    QThreadPool::globalInstance()->start([this, fromMs, toMs]() {
+        rebuild(fromMs, toMs);
+
+        // Kept, and saved, until rebuilt; late frames since then are left
+        // for the next call
+        QWriteLocker locker(&m_lock);
+        if (m_lateFromMs == fromMs && m_lateToMs == toMs) {
+            m_lateFromMs = 0;
+            m_lateToMs = 0;
+        }
+    });
+}
+
+void TelemetryDcs::recomputeYear(int year)
+{
+    const qint64 fromMs = QDateTime(QDate(year, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    const qint64 toMs = QDateTime(QDate(year + 1, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    DcsFigures figures;
+    for (auto it = m_days.lowerBound(fromMs); it != m_days.constEnd() && it.key() < toMs; ++it)
+        merge(&figures, it.value());
+
+    if (figures.isEmpty())
+        m_years.remove(year);
+    else
+        m_years.insert(year, figures);
+}
+
+void TelemetryDcs::recomputeVoyage(const QString& voyage)
+{
+    DcsFigures figures;
+    for (auto day = m_dayVoyages.constBegin(); day != m_dayVoyages.constEnd(); ++day) {
+        auto it = day.value().constFind(voyage);
+        if (it != day.value().constEnd())
+            merge(&figures, it.value());
+    }
+
+    if (figures.isEmpty())
+        m_voyages.remove(voyage);
+    else
+        m_voyages.insert(voyage, figures);
+}
+
+QList<int> TelemetryDcs::years() const
+{
+    QReadLocker locker(&m_lock);
+    return m_years.keys();
+}
+
+QStringList TelemetryDcs::voyages() const
+{
+    QReadLocker locker(&m_lock);
+    QStringList names = m_voyages.keys();
+    std::sort(names.begin(), names.end(), [this](const QString &a, const QString &b) {
+        return m_voyages.value(a).firstMs < m_voyages.value(b).firstMs;
+    });
+    return names;
+}
+
+DcsFigures TelemetryDcs::year(int year) const
+{
+    QReadLocker locker(&m_lock);
+    return m_years.value(year);
+}
+
+DcsFigures TelemetryDcs::voyage(const QString& voyage) const
+{
+    QReadLocker locker(&m_lock);
+    return m_voyages.value(voyage);
+}
+
+QMap<qint64, DcsFigures> TelemetryDcs::days(qint64 fromMs, qint64 toMs) const
+{
+    QReadLocker locker(&m_lock);
+    QMap<qint64, DcsFigures> result;
+    for (auto it = m_days.lowerBound(floorTo(fromMs, kDayMs)); it != m_days.constEnd() && it.key() < toMs; ++it)
+        result.insert(it.key(), it.value());
+    return result;
+}
+
+quint64 TelemetryDcs::version() const
+{
+    QReadLocker locker(&m_lock);
+    return m_version;
+}
+
+bool TelemetryDcs::save() const
+{
+    QMutexLocker saving(&m_saveMutex);
+
+    // Implicitly shared copies; add() detaches whatever it touches next.
+    // Years and voyages are sums of the days and are not written.
+    Cursor cursor;
+    QVector<Tank> tanks;
+    qint64 lateFromMs;
+    qint64 lateToMs;
+    QMap<qint64, DcsFigures> days;
+    QMap<qint64, QHash<QString, DcsFigures>> dayVoyages;
+    {
+        QReadLocker locker(&m_lock);
+        cursor = m_cursor;
+        tanks = m_tanks;
+        lateFromMs = m_lateFromMs;
+        lateToMs = m_lateToMs;
+        days = m_days;
+        dayVoyages = m_dayVoyages;
+    }
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out << kMagic << kVersion << cursor.lastMs << cursor.lastLatitude << cursor.lastLongitude
+        << cursor.lastUnderway << cursor.tankVolume << cursor.fuelBalance << cursor.risingSinceMs;
+    out << qint32(tanks.size());
+    for (const Tank &tank : tanks)
+        out << tank.name << tank.fuelType;
+    out << lateFromMs << lateToMs;
+
+    out << qint32(days.size());
+    for (auto it = days.constBegin(); it != days.constEnd(); ++it) {
+        out << it.key();
+        writeFigures(out, it.value());
+        const QHash<QString, DcsFigures> shares = dayVoyages.value(it.key());
+        out << qint32(shares.size());
+        for (auto share = shares.constBegin(); share != shares.constEnd(); ++share) {
+            out << share.key();
+            writeFigures(out, share.value());
+        }
+    }
+    return file.commit();
+}
+
+bool TelemetryDcs::load()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion)
+        return false;
+
+    Cursor cursor;
+    in >> cursor.lastMs >> cursor.lastLatitude >> cursor.lastLongitude >> cursor.lastUnderway
+       >> cursor.tankVolume >> cursor.fuelBalance >> cursor.risingSinceMs;
+
+    QVector<Tank> tanks;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Tank tank;
+        in >> tank.name >> tank.fuelType;
+        tanks.append(tank);
+    }
+    qint64 lateFromMs = 0, lateToMs = 0;
+    in >> lateFromMs >> lateToMs;
+
+    QMap<qint64, DcsFigures> days;
+    QMap<qint64, QHash<QString, DcsFigures>> dayVoyages;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        qint64 day = 0;
+        in >> day;
+        readFigures(in, &days[day]);
+        qint32 shares = 0;
+        in >> shares;
+        for (qint32 j = 0; j < shares && in.status() == QDataStream::Ok; ++j) {
+            QString voyage;
+            in >> voyage;
+            readFigures(in, &dayVoyages[day][voyage]);
+        }
+    }
+
+    // A truncated file starts the totals afresh rather than half-filled
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    m_cursor = cursor;
+    m_tanks.swap(tanks);
+    m_lateFromMs = lateFromMs;
+    m_lateToMs = lateToMs;
+    m_days.swap(days);
+    m_dayVoyages.swap(dayVoyages);
+    for (auto it = m_days.constBegin(); it != m_days.constEnd(); ++it)
+        merge(&m_years[utcYear(it.key())], it.value());
+    for (auto day = m_dayVoyages.constBegin(); day != m_dayVoyages.constEnd(); ++day) {
+        for (auto it = day.value().constBegin(); it != day.value().constEnd(); ++it)
+            merge(&m_voyages[it.key()], it.value());
+    }
+    m_lastSavedHour = floorTo(cursor.lastMs, kHourMs);
+    return true;
+}
@@ -0,0 +1,141 @@
+#ifndef TELEMETRYDCS_H
+#define TELEMETRYDCS_H
+
+#include <QHash>
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QReadWriteLock>
+#include <QMutex>
+#include <QVector>
+#include "TelemetryFrame.h"
+
+// Figures IMO DCS (MARPOL Annex VI reg. 22A) asks for over a period
+struct DcsFigures
+{
+    qint64 firstMs = 0;
+    qint64 lastMs = 0;
+    double distanceNm = 0.0;
+    double hoursUnderway = 0.0;
+    QMap<QString, double> fuelTonnes;   // by fuel type
+
+    double totalFuelTonnes() const;
+    // Fuel times its MEPC.308(73) carbon factor
+    double co2Tonnes() const;
+    bool isEmpty() const { return firstMs == 0; }
+};
+
+// ------------------- IMO DCS -------------------
+// Running DCS totals per calendar year, per voyage and per UTC day, kept
+// up to date as each frame arrives. A frame costs a handful of hash
+// lookups however long the history is.
+//
+// Fuel consumed is the drop in fuel_volume (m³) between consecutive
+// frames, summed over the tanks of each fuel type so a transfer between
+// tanks cancels out, and converted to tonnes with the fuel type's density.
+// Soundings wobble with slosh and sensor noise, so each fuel type keeps a
+// running net change: drops are counted once they outweigh the rises
+// before them, and a rise is written off as bunkering only when it grows
+// past kBunkeringM3 or has not been used up after kBunkeringMs. Distance
+// is the great-circle leg between consecutive positions, and time counts
+// as underway while the ship makes way at both ends of the leg. A leg
+// across a long gap still counts, as the straight line between its ends.
+//
+// Frames older than the last one folded in (gap recovery) would split a
+// leg already counted, so add() only notes their days; those days, and
+// days an import wrote to, are folded afresh from the history by
+// rebuild(). The store keeps no voyage, so rebuilt frames are given the
+// voyage whose span they fall in. The totals are saved next to the
+// history so they survive restarts.
+class TelemetryDcs
+{
+public:
+    static TelemetryDcs& instance();
+
+    void add(const TelemetryFrame& frame);
+
+    // Folds the UTC days overlapping [fromMs, toMs) afresh from the
+    // history, on the calling thread; add() carries on meanwhile
+    void rebuild(qint64 fromMs, qint64 toMs);
+    // Rebuilds the days late frames have reached, on the global thread pool
+    void rebuildLateDays();
+
+    QList<int> years() const;
+    QStringList voyages() const;        // oldest first
+    DcsFigures year(int year) const;
+    DcsFigures voyage(const QString& voyage) const;
+    // Day figures keyed by the day's first millisecond (UTC), in [fromMs, toMs)
+    QMap<qint64, DcsFigures> days(qint64 fromMs, qint64 toMs) const;
+
+    // Bumped whenever a figure changes, for cache invalidation
+    quint64 version() const;
+
+    // Writes a snapshot, so add() is only blocked while it is taken. Also
+    // run on the thread pool on every hour boundary; the application saves
+    // on quit.
+    bool save() const;
+
+    static double carbonFactor(const QString& fuelType);   // t CO2 per t fuel
+    static double density(const QString& fuelType);        // t per m³
+
+private:
+    TelemetryDcs();
+    ~TelemetryDcs();
+    Q_DISABLE_COPY(TelemetryDcs)
+
+    // What the totals need from one frame
+    struct Reading {
+        qint64 timestampMs = 0;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        double shipSpeed = 0.0;
+        QVector<double> tankVolume;     // m³ by fuel tank slot, NaN if not sounded
+    };
+
+    // The previous reading, which the next leg starts from
+    struct Cursor {
+        qint64 lastMs = 0;
+        double lastLatitude = 0.0;
+        double lastLongitude = 0.0;
+        bool lastUnderway = false;
+        QHash<QString, double> tankVolume;  // m³ by tank
+        // m³ by fuel type risen and not yet used up again (negative), and
+        // since when
+        QHash<QString, double> fuelBalance;
+        QHash<QString, qint64> risingSinceMs;
+    };
+
+    struct Tank {
+        QString name;
+        QString fuelType;
+    };
+
+    // Figures of the leg from cursor to reading; moves the cursor on
+    static DcsFigures advance(Cursor* cursor, const Reading& reading, const QVector<Tank>& tanks);
+    static QVector<Reading> readHistory(qint64 fromMs, qint64 toMs);
+    void recomputeYear(int year);
+    void recomputeVoyage(const QString& voyage);
+    bool load();
+
+    mutable QReadWriteLock m_lock;
+    mutable QMutex m_saveMutex;             // one save() at a time
+    QMutex m_rebuildMutex;                  // one rebuild() at a time
+    QString m_path;
+    QMap<int, DcsFigures> m_years;
+    QHash<QString, DcsFigures> m_voyages;
+    QMap<qint64, DcsFigures> m_days;
+    QMap<qint64, QHash<QString, DcsFigures>> m_dayVoyages;  // each voyage's share of a day
+
+    Cursor m_cursor;
+    QVector<Tank> m_tanks;                  // by fuel tank slot, as last seen live
+    qint64 m_lateFromMs;                    // late frames not yet rebuilt, 0 if none
+    qint64 m_lateToMs;
+
+    qint64 m_dayStartMs;                    // cached calendar year of the current day
+    int m_year;
+    qint64 m_lastSavedHour;
+    quint64 m_version;
+};
+
+#endif // TELEMETRYDCS_H
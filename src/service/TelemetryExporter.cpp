@@ -0,0 +1,215 @@
+#include "TelemetryExporter.h"
+#include "TelemetryStore.h"
+#include "GorillaCodec.h"
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QPointer>
+#include <QMetaObject>
+#include <QThreadPool>
+#include <QVector>
+#include <QtNumeric>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace {
+
+const quint32 kColumnarMagic = 0x53435458;   // "SCTX"
+const quint32 kColumnarVersion = 1;
+const qint64 kChunkMs = 60 * 60 * 1000;
+
+QString columnName(quint32 key)
+{
+    const TelemetryChannel channel = static_cast<TelemetryChannel>(key >> 16);
+    const QString name = telemetryChannelName(channel);
+    return isPerEquipmentChannel(channel) ? QString("%1_%2").arg(name).arg((key & 0xFFFF) + 1) : name;
+}
+
+void writeBytes(QDataStream& out, const QByteArray& bytes)
+{
+    out << quint32(bytes.size());
+    out.writeRawData(bytes.constData(), bytes.size());
+}
+
+// Returns an error message, empty on success
+QString exportRange(const QString& path, TelemetryExporter::Format format,
+                    qint64 fromMs, qint64 toMs, QList<quint32> keys,
+                    const QAtomicInt* cancelled,
+                    const std::function<void(int, qint64)>& progress)
+{
+    const TelemetryStore &store = TelemetryStore::instance();
+    if (keys.isEmpty())
+        keys = store.columnKeys();
+    std::sort(keys.begin(), keys.end());
+    if (keys.isEmpty())
+        return QStringLiteral("No telemetry has been recorded yet.");
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return file.errorString();
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    const int columns = keys.size();
+
+    if (format == TelemetryExporter::Csv) {
+        QByteArray header("timestamp");
+        for (quint32 key : keys)
+            header += ',' + columnName(key).toUtf8();
+        header += '\n';
+        file.write(header);
+    } else {
+        out << kColumnarMagic << kColumnarVersion << quint32(columns);
+        for (quint32 key : keys) {
+            out << key;
+            writeBytes(out, columnName(key).toUtf8());
+        }
+    }
+
+    // Buffers reused for every chunk: an hour of rows at most
+    QVector<QVector<qint64>> columnTs(columns);
+    QVector<QVector<float>> columnValues(columns);
+    QVector<qint64> rows;
+    QVector<float> grid;
+    QVector<float> columnBuffer;
+    QByteArray text;
+    qint64 written = 0;
+
+    for (qint64 chunkFrom = fromMs; chunkFrom < toMs; chunkFrom += kChunkMs) {
+        if (cancelled->loadRelaxed()) {
+            file.cancelWriting();
+            return QStringLiteral("Export cancelled.");
+        }
+
+        const qint64 chunkTo = qMin(chunkFrom + kChunkMs, toMs);
+        rows.clear();
+        for (int c = 0; c < columns; ++c) {
+            const TelemetryChannel channel = static_cast<TelemetryChannel>(keys.at(c) >> 16);
+            columnTs[c].clear();
+            columnValues[c].clear();
+            store.read(channel, int(keys.at(c) & 0xFFFF), chunkFrom, chunkTo, &columnTs[c], &columnValues[c]);
+            rows += columnTs.at(c);
+        }
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+        if (!rows.isEmpty()) {
+            // Row-major grid of the chunk, NaN where a column has no sample
+            const int rowCount = rows.size();
+            grid.fill(std::numeric_limits<float>::quiet_NaN(), rowCount * columns);
+            for (int c = 0; c < columns; ++c) {
+                const QVector<qint64> &ts = columnTs.at(c);
+                for (int i = 0; i < ts.size(); ++i) {
+                    const int row = int(std::lower_bound(rows.constBegin(), rows.constEnd(), ts.at(i)) - rows.constBegin());
+                    grid[row * columns + c] = columnValues.at(c).at(i);
+                }
+            }
+
+            if (format == TelemetryExporter::Csv) {
+                text.clear();
+                for (int r = 0; r < rowCount; ++r) {
+                    text += QDateTime::fromMSecsSinceEpoch(rows.at(r), Qt::UTC).toString(Qt::ISODateWithMs).toLatin1();
+                    for (int c = 0; c < columns; ++c) {
+                        text += ',';
+                        const float value = grid.at(r * columns + c);
+                        if (!qIsNaN(value))
+                            text += QByteArray::number(value, 'g', 7);
+                    }
+                    text += '\n';
+                }
+                file.write(text);
+            } else {
+                out << quint32(rowCount);
+                writeBytes(out, GorillaCodec::encodeTimestamps(rows.constData(), rowCount));
+                columnBuffer.resize(rowCount);
+                for (int c = 0; c < columns; ++c) {
+                    for (int r = 0; r < rowCount; ++r)
+                        columnBuffer[r] = grid.at(r * columns + c);
+                    writeBytes(out, GorillaCodec::encodeFloats(columnBuffer.constData(), rowCount));
+                }
+            }
+            written += rowCount;
+        }
+
+        if (file.error() != QFileDevice::NoError) {
+            const QString error = file.errorString();
+            file.cancelWriting();
+            return error;
+        }
+        progress(int((chunkTo - fromMs) * 100 / (toMs - fromMs)), written);
+    }
+
+    if (format == TelemetryExporter::Columnar)
+        out << quint32(0) << quint64(written);
+
+    if (!file.commit())
+        return file.errorString();
+    return QString();
+}
+
+} // namespace
+
+TelemetryExporter::TelemetryExporter(QObject *parent)
+    : QObject(parent),
+    m_running(false)
+{
+}
+
+TelemetryExporter::~TelemetryExporter()
+{
+    cancel();
+}
+
+TelemetryExporter::Format TelemetryExporter::formatForPath(const QString& path)
+{
+    return QFileInfo(path).suffix().compare("csv", Qt::CaseInsensitive) == 0 ? Csv : Columnar;
+}
+
+bool TelemetryExporter::start(const QString& path, Format format, qint64 fromMs, qint64 toMs,
+                              const QList<quint32>& keys)
+{
+    if (m_running || toMs <= fromMs)
+        return false;
+
+    m_running = true;
+    m_cancelled = QSharedPointer<QAtomicInt>::create(0);
+
+    QPointer<TelemetryExporter> receiver(this);
+    QSharedPointer<QAtomicInt> cancelled = m_cancelled;
+    QThreadPool::globalInstance()->start([=]() {
+        // Progress is coalesced to whole percent steps
+        int lastPercent = -1;
+        auto report = [&](int percent, qint64 rows) {
+            if (percent == lastPercent || !receiver)
+                return;
+            lastPercent = percent;
+            QMetaObject::invokeMethod(receiver.data(), [receiver, percent, rows]() {
+                if (receiver && receiver->m_running)
+                    emit receiver->progress(percent, rows);
+            }, Qt::QueuedConnection);
+        };
+
+        const QString error = exportRange(path, format, fromMs, toMs, keys, cancelled.data(), report);
+        if (!error.isEmpty())
+            qWarning() << "TelemetryExporter:" << path << error;
+
+        if (!receiver)
+            return;
+        QMetaObject::invokeMethod(receiver.data(), [receiver, error, path]() {
+            if (!receiver)
+                return;
+            receiver->m_running = false;
+            emit receiver->finished(error.isEmpty(), error.isEmpty() ? path : error);
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void TelemetryExporter::cancel()
+{
+    if (m_cancelled)
+        m_cancelled->storeRelaxed(1);
+}
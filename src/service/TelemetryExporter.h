@@ -0,0 +1,53 @@
+#ifndef TELEMETRYEXPORTER_H
+#define TELEMETRYEXPORTER_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QList>
+#include <QString>
+
+// ------------------- Export -------------------
+// Streams a range of the history to a file on the global thread pool, one
+// hour of rows at a time, so memory stays flat however long the range is.
+//
+// Csv: one row per timestamp (ISO 8601 UTC), one column per channel and
+// equipment slot, empty cells where a value is missing.
+//
+// Columnar (.sctx): little-endian, for bulk hand-over to other tools.
+//   header  "SCTX", version, columnCount, then per column its channel key
+//           and UTF-8 name (quint32 length + bytes)
+//   blocks  rowCount, Gorilla timestamps (quint32 bytes + data), then per
+//           column Gorilla float32 values (quint32 bytes + data)
+//   end     a block with rowCount 0, followed by the total row count
+class TelemetryExporter : public QObject
+{
+    Q_OBJECT
+public:
+    enum Format {
+        Csv,
+        Columnar
+    };
+
+    explicit TelemetryExporter(QObject *parent = nullptr);
+    ~TelemetryExporter();
+
+    // False if an export is already running. keys empty means every column.
+    bool start(const QString& path, Format format, qint64 fromMs, qint64 toMs,
+               const QList<quint32>& keys = QList<quint32>());
+    void cancel();
+    bool isRunning() const { return m_running; }
+
+    static Format formatForPath(const QString& path);
+
+signals:
+    void progress(int percent, qint64 rowsWritten);
+    // ok is false on error or cancellation; the target file is left untouched then
+    void finished(bool ok, const QString& message);
+
+private:
+    bool m_running;
+    QSharedPointer<QAtomicInt> m_cancelled;
+};
+
+#endif // TELEMETRYEXPORTER_H
@@ -0,0 +1,441 @@
+#include "TelemetryFrame.h"
+#include <QDateTime>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <limits>
+
+// ------------------- TelemetryIdTable -------------------
+
+TelemetryIdTable::TelemetryIdTable()
+{
+    // Id 0 is reserved for "no name"
+    m_names.append(QString());
+    m_ids.insert(QString(), 0);
+}
+
+TelemetryIdTable& TelemetryIdTable::instance()
+{
+    static TelemetryIdTable table;
+    return table;
+}
+
+quint16 TelemetryIdTable::intern(const QString& name)
+{
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_ids.constFind(name);
+        if (it != m_ids.constEnd())
+            return it.value();
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto it = m_ids.constFind(name);
+    if (it != m_ids.constEnd())
+        return it.value();
+
+    quint16 id = static_cast<quint16>(m_names.size());
+    m_names.append(name);
+    m_ids.insert(name, id);
+    return id;
+}
+
+QString TelemetryIdTable::name(quint16 id) const
+{
+    QReadLocker locker(&m_lock);
+    return id < m_names.size() ? m_names.at(id) : QString();
+}
+
+int TelemetryIdTable::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_names.size();
+}
+
+EquipmentStatus equipmentStatusFromString(const QString& status)
+{
+    if (status.compare(QLatin1String("running"), Qt::CaseInsensitive) == 0
+        || status.compare(QLatin1String("on"), Qt::CaseInsensitive) == 0
+        || status.compare(QLatin1String("active"), Qt::CaseInsensitive) == 0)
+        return EquipmentStatus::Running;
+    if (status.compare(QLatin1String("standby"), Qt::CaseInsensitive) == 0
+        || status.compare(QLatin1String("idle"), Qt::CaseInsensitive) == 0)
+        return EquipmentStatus::Standby;
+    if (status.compare(QLatin1String("stopped"), Qt::CaseInsensitive) == 0
+        || status.compare(QLatin1String("off"), Qt::CaseInsensitive) == 0)
+        return EquipmentStatus::Stopped;
+    if (status.compare(QLatin1String("fault"), Qt::CaseInsensitive) == 0
+        || status.compare(QLatin1String("alarm"), Qt::CaseInsensitive) == 0)
+        return EquipmentStatus::Fault;
+    return EquipmentStatus::Unknown;
+}
+
+QString equipmentStatusToString(EquipmentStatus status)
+{
+    switch (status) {
+    case EquipmentStatus::Running: return QStringLiteral("running");
+    case EquipmentStatus::Standby: return QStringLiteral("standby");
+    case EquipmentStatus::Stopped: return QStringLiteral("stopped");
+    case EquipmentStatus::Fault:   return QStringLiteral("fault");
+    case EquipmentStatus::Unknown:
+    default:                       return QStringLiteral("unknown");
+    }
+}
+
+// ------------------- Channels -------------------
+
+QString telemetryChannelName(TelemetryChannel channel)
+{
+    switch (channel) {
+    case TelemetryChannel::Latitude:               return QStringLiteral("latitude");
+    case TelemetryChannel::Longitude:              return QStringLiteral("longitude");
+    case TelemetryChannel::ShipSpeed:              return QStringLiteral("ship_speed");
+    case TelemetryChannel::Course:                 return QStringLiteral("course");
+    case TelemetryChannel::WindSpeed:              return QStringLiteral("wind_speed");
+    case TelemetryChannel::SeaState:               return QStringLiteral("sea_state");
+    case TelemetryChannel::AirTemperature:         return QStringLiteral("air_temperature");
+    case TelemetryChannel::Humidity:               return QStringLiteral("humidity");
+    case TelemetryChannel::BarometricPressure:     return QStringLiteral("barometric_pressure");
+    case TelemetryChannel::HvacPower:              return QStringLiteral("hvac_power");
+    case TelemetryChannel::GalleyPower:            return QStringLiteral("galley_power");
+    case TelemetryChannel::LightingPower:          return QStringLiteral("lighting_power");
+    case TelemetryChannel::TotalHotelLoad:         return QStringLiteral("total_hotel_load");
+    case TelemetryChannel::Rpm:                    return QStringLiteral("rpm");
+    case TelemetryChannel::EngineLoad:             return QStringLiteral("engine_load");
+    case TelemetryChannel::PowerOutput:            return QStringLiteral("power_output");
+    case TelemetryChannel::FuelConsumptionRate:    return QStringLiteral("fuel_consumption_rate");
+    case TelemetryChannel::ExhaustGasTemp:         return QStringLiteral("exhaust_gas_temp");
+    case TelemetryChannel::GenLoad:                return QStringLiteral("gen_load");
+    case TelemetryChannel::GenPowerOutput:         return QStringLiteral("gen_power_output");
+    case TelemetryChannel::GenFuelConsumptionRate: return QStringLiteral("gen_fuel_consumption_rate");
+    case TelemetryChannel::FuelLevel:              return QStringLiteral("fuel_level");
+    case TelemetryChannel::FuelVolume:             return QStringLiteral("fuel_volume");
+    case TelemetryChannel::TankLevel:              return QStringLiteral("tank_level");
+    case TelemetryChannel::PumpPowerConsumption:   return QStringLiteral("pump_power_consumption");
+    case TelemetryChannel::ChannelCount:
+    default:                                       return QString();
+    }
+}
+
+bool isPerEquipmentChannel(TelemetryChannel channel)
+{
+    return channel >= TelemetryChannel::Rpm && channel < TelemetryChannel::ChannelCount;
+}
+
+// ------------------- TelemetryFrame -------------------
+
+namespace {
+
+inline double at(const QVector<double>& column, int slot)
+{
+    return slot >= 0 && slot < column.size() ? column.at(slot)
+                                              : std::numeric_limits<double>::quiet_NaN();
+}
+
+// Weather fields arrive as free text; anything unparsable is missing, not 0
+double weatherValue(const QString& text)
+{
+    bool ok = false;
+    double value = text.toDouble(&ok);
+    return ok ? value : std::numeric_limits<double>::quiet_NaN();
+}
+
+} // namespace
+
+double TelemetryFrame::value(TelemetryChannel channel, int slot) const
+{
+    switch (channel) {
+    case TelemetryChannel::Latitude:               return latitude;
+    case TelemetryChannel::Longitude:              return longitude;
+    case TelemetryChannel::ShipSpeed:              return shipSpeed;
+    case TelemetryChannel::Course:                 return course;
+    case TelemetryChannel::WindSpeed:              return windSpeed;
+    case TelemetryChannel::SeaState:               return seaState;
+    case TelemetryChannel::AirTemperature:         return airTemperature;
+    case TelemetryChannel::Humidity:               return humidity;
+    case TelemetryChannel::BarometricPressure:     return barometricPressure;
+    case TelemetryChannel::HvacPower:              return hvacPower;
+    case TelemetryChannel::GalleyPower:            return galleyPower;
+    case TelemetryChannel::LightingPower:          return lightingPower;
+    case TelemetryChannel::TotalHotelLoad:         return totalHotelLoad;
+    case TelemetryChannel::Rpm:                    return at(propulsion.rpm, slot);
+    case TelemetryChannel::EngineLoad:             return at(propulsion.engineLoad, slot);
+    case TelemetryChannel::PowerOutput:            return at(propulsion.powerOutput, slot);
+    case TelemetryChannel::FuelConsumptionRate:    return at(propulsion.fuelConsumptionRate, slot);
+    case TelemetryChannel::ExhaustGasTemp:         return at(propulsion.exhaustGasTemp, slot);
+    case TelemetryChannel::GenLoad:                return at(electrical.genLoad, slot);
+    case TelemetryChannel::GenPowerOutput:         return at(electrical.genPowerOutput, slot);
+    case TelemetryChannel::GenFuelConsumptionRate: return at(electrical.genFuelConsumptionRate, slot);
+    case TelemetryChannel::FuelLevel:              return at(fuelTanks.fuelLevel, slot);
+    case TelemetryChannel::FuelVolume:             return at(fuelTanks.fuelVolume, slot);
+    case TelemetryChannel::TankLevel:              return at(ballastTanks.tankLevel, slot);
+    case TelemetryChannel::PumpPowerConsumption:   return at(ballastTanks.pumpPowerConsumption, slot);
+    case TelemetryChannel::ChannelCount:
+    default:                                       return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+int TelemetryFrame::slotCount(TelemetryChannel channel) const
+{
+    if (channel < TelemetryChannel::Rpm)
+        return 1;
+    if (channel < TelemetryChannel::GenLoad)
+        return propulsion.size();
+    if (channel < TelemetryChannel::FuelLevel)
+        return electrical.size();
+    if (channel < TelemetryChannel::TankLevel)
+        return fuelTanks.size();
+    if (channel < TelemetryChannel::ChannelCount)
+        return ballastTanks.size();
+    return 0;
+}
+
+void TelemetryFrame::setValue(TelemetryChannel channel, int slot, double value)
+{
+    if (slot < 0)
+        return;
+
+    const int n = slot + 1;
+    if (channel >= TelemetryChannel::Rpm && channel < TelemetryChannel::GenLoad && propulsion.size() < n) {
+        propulsion.recordId.resize(n);
+        propulsion.engineId.resize(n);
+        propulsion.status.resize(n);
+        propulsion.rpm.resize(n);
+        propulsion.engineLoad.resize(n);
+        propulsion.powerOutput.resize(n);
+        propulsion.fuelConsumptionRate.resize(n);
+        propulsion.exhaustGasTemp.resize(n);
+    } else if (channel >= TelemetryChannel::GenLoad && channel < TelemetryChannel::FuelLevel && electrical.size() < n) {
+        electrical.recordId.resize(n);
+        electrical.generatorId.resize(n);
+        electrical.status.resize(n);
+        electrical.genLoad.resize(n);
+        electrical.genPowerOutput.resize(n);
+        electrical.genFuelConsumptionRate.resize(n);
+    } else if (channel >= TelemetryChannel::FuelLevel && channel < TelemetryChannel::TankLevel && fuelTanks.size() < n) {
+        fuelTanks.recordId.resize(n);
+        fuelTanks.tankId.resize(n);
+        fuelTanks.fuelType.resize(n);
+        fuelTanks.fuelLevel.resize(n);
+        fuelTanks.fuelVolume.resize(n);
+    } else if (channel >= TelemetryChannel::TankLevel && channel < TelemetryChannel::ChannelCount && ballastTanks.size() < n) {
+        ballastTanks.recordId.resize(n);
+        ballastTanks.tankId.resize(n);
+        ballastTanks.pumpStatus.resize(n);
+        ballastTanks.tankLevel.resize(n);
+        ballastTanks.pumpPowerConsumption.resize(n);
+    }
+
+    switch (channel) {
+    case TelemetryChannel::Latitude:               latitude = value; break;
+    case TelemetryChannel::Longitude:              longitude = value; break;
+    case TelemetryChannel::ShipSpeed:              shipSpeed = value; break;
+    case TelemetryChannel::Course:                 course = value; break;
+    case TelemetryChannel::WindSpeed:              windSpeed = value; break;
+    case TelemetryChannel::SeaState:               seaState = value; break;
+    case TelemetryChannel::AirTemperature:         airTemperature = value; break;
+    case TelemetryChannel::Humidity:               humidity = value; break;
+    case TelemetryChannel::BarometricPressure:     barometricPressure = value; break;
+    case TelemetryChannel::HvacPower:              hvacPower = value; break;
+    case TelemetryChannel::GalleyPower:            galleyPower = value; break;
+    case TelemetryChannel::LightingPower:          lightingPower = value; break;
+    case TelemetryChannel::TotalHotelLoad:         totalHotelLoad = value; break;
+    case TelemetryChannel::Rpm:                    propulsion.rpm[slot] = value; break;
+    case TelemetryChannel::EngineLoad:             propulsion.engineLoad[slot] = value; break;
+    case TelemetryChannel::PowerOutput:            propulsion.powerOutput[slot] = value; break;
+    case TelemetryChannel::FuelConsumptionRate:    propulsion.fuelConsumptionRate[slot] = value; break;
+    case TelemetryChannel::ExhaustGasTemp:         propulsion.exhaustGasTemp[slot] = value; break;
+    case TelemetryChannel::GenLoad:                electrical.genLoad[slot] = value; break;
+    case TelemetryChannel::GenPowerOutput:         electrical.genPowerOutput[slot] = value; break;
+    case TelemetryChannel::GenFuelConsumptionRate: electrical.genFuelConsumptionRate[slot] = value; break;
+    case TelemetryChannel::FuelLevel:              fuelTanks.fuelLevel[slot] = value; break;
+    case TelemetryChannel::FuelVolume:             fuelTanks.fuelVolume[slot] = value; break;
+    case TelemetryChannel::TankLevel:              ballastTanks.tankLevel[slot] = value; break;
+    case TelemetryChannel::PumpPowerConsumption:   ballastTanks.pumpPowerConsumption[slot] = value; break;
+    case TelemetryChannel::ChannelCount:
+    default:                                       break;
+    }
+}
+
+qint64 TelemetryFrame::parseTimestamp(const QString& timestamp)
+{
+    QDateTime dt = QDateTime::fromString(timestamp, Qt::ISODateWithMs);
+    if (!dt.isValid())
+        dt = QDateTime::fromString(timestamp, "yyyy-MM-dd HH:mm:ss");
+    if (!dt.isValid())
+        return 0;
+    if (dt.timeSpec() == Qt::LocalTime)
+        dt.setTimeSpec(Qt::UTC);
+    return dt.toMSecsSinceEpoch();
+}
+
+TelemetryFrame TelemetryFrame::fromVoyageLogs(const VoyageLogs& logs)
+{
+    TelemetryIdTable& ids = TelemetryIdTable::instance();
+
+    TelemetryFrame frame;
+    frame.timestampMs = parseTimestamp(logs.timestamp);
+    frame.logId = logs.log_id;
+    frame.voyageId = ids.intern(logs.voyage_id);
+    frame.latitude = logs.latitude;
+    frame.longitude = logs.longitude;
+    frame.shipSpeed = logs.ship_speed;
+    frame.course = logs.course;
+    frame.windSpeed = logs.wind_speed;
+    frame.seaState = logs.sea_state;
+    frame.airTemperature = weatherValue(logs.air_temperature);
+    frame.humidity = weatherValue(logs.humidity);
+    frame.barometricPressure = weatherValue(logs.barometric_pressure);
+    frame.hvacPower = logs.hvac_power;
+    frame.galleyPower = logs.galley_power;
+    frame.lightingPower = logs.lighting_power;
+    frame.totalHotelLoad = logs.total_hotel_load;
+
+    const int nProp = logs.propulsion_logs.size();
+    Propulsion &p = frame.propulsion;
+    p.recordId.reserve(nProp);
+    p.engineId.reserve(nProp);
+    p.status.reserve(nProp);
+    p.rpm.reserve(nProp);
+    p.engineLoad.reserve(nProp);
+    p.powerOutput.reserve(nProp);
+    p.fuelConsumptionRate.reserve(nProp);
+    p.exhaustGasTemp.reserve(nProp);
+    for (const PropulsionLog &log : logs.propulsion_logs) {
+        p.recordId.append(log.propulsion_log_id);
+        p.engineId.append(ids.intern(log.engine_id));
+        p.status.append(equipmentStatusFromString(log.status));
+        p.rpm.append(log.rpm);
+        p.engineLoad.append(log.engine_load);
+        p.powerOutput.append(log.power_output);
+        p.fuelConsumptionRate.append(log.fuel_consumption_rate);
+        p.exhaustGasTemp.append(log.exhaust_gas_temp);
+    }
+
+    const int nElec = logs.electrical_logs.size();
+    Electrical &e = frame.electrical;
+    e.recordId.reserve(nElec);
+    e.generatorId.reserve(nElec);
+    e.status.reserve(nElec);
+    e.genLoad.reserve(nElec);
+    e.genPowerOutput.reserve(nElec);
+    e.genFuelConsumptionRate.reserve(nElec);
+    for (const ElectricalLog &log : logs.electrical_logs) {
+        e.recordId.append(log.electrical_log_id);
+        e.generatorId.append(ids.intern(log.generator_id));
+        e.status.append(equipmentStatusFromString(log.status));
+        e.genLoad.append(log.gen_load);
+        e.genPowerOutput.append(log.gen_power_output);
+        e.genFuelConsumptionRate.append(log.gen_fuel_consumption_rate);
+    }
+
+    const int nFuel = logs.fuel_tank_logs.size();
+    FuelTanks &f = frame.fuelTanks;
+    f.recordId.reserve(nFuel);
+    f.tankId.reserve(nFuel);
+    f.fuelType.reserve(nFuel);
+    f.fuelLevel.reserve(nFuel);
+    f.fuelVolume.reserve(nFuel);
+    for (const FuelTankLog &log : logs.fuel_tank_logs) {
+        f.recordId.append(log.fuel_tank_log_id);
+        f.tankId.append(ids.intern(log.tank_id));
+        f.fuelType.append(ids.intern(log.fuel_type));
+        f.fuelLevel.append(log.fuel_level);
+        f.fuelVolume.append(log.fuel_volume);
+    }
+
+    const int nBallast = logs.ballast_tank_logs.size();
+    BallastTanks &b = frame.ballastTanks;
+    b.recordId.reserve(nBallast);
+    b.tankId.reserve(nBallast);
+    b.pumpStatus.reserve(nBallast);
+    b.tankLevel.reserve(nBallast);
+    b.pumpPowerConsumption.reserve(nBallast);
+    for (const BallastTankLog &log : logs.ballast_tank_logs) {
+        b.recordId.append(log.ballast_tank_log_id);
+        b.tankId.append(ids.intern(log.tank_id));
+        b.pumpStatus.append(equipmentStatusFromString(log.pump_status));
+        b.tankLevel.append(log.tank_level);
+        b.pumpPowerConsumption.append(log.pump_power_consumption);
+    }
+
+    return frame;
+}
+
+VoyageLogs TelemetryFrame::toVoyageLogs() const
+{
+    const TelemetryIdTable& ids = TelemetryIdTable::instance();
+
+    VoyageLogs logs;
+    logs.log_id = logId;
+    logs.voyage_id = ids.name(voyageId);
+    logs.timestamp = timestampMs > 0
+                         ? QDateTime::fromMSecsSinceEpoch(timestampMs, Qt::UTC).toString(Qt::ISODateWithMs)
+                         : QString();
+    logs.latitude = latitude;
+    logs.longitude = longitude;
+    logs.ship_speed = shipSpeed;
+    logs.course = static_cast<int>(course);
+    logs.wind_speed = windSpeed;
+    logs.sea_state = seaState;
+    logs.hvac_power = hvacPower;
+    logs.galley_power = galleyPower;
+    logs.lighting_power = lightingPower;
+    logs.total_hotel_load = totalHotelLoad;
+    logs.air_temperature = qIsNaN(airTemperature) ? QString() : QString::number(airTemperature);
+    logs.humidity = qIsNaN(humidity) ? QString() : QString::number(humidity);
+    logs.barometric_pressure = qIsNaN(barometricPressure) ? QString() : QString::number(barometricPressure);
+
+    logs.propulsion_logs.reserve(propulsion.size());
+    for (int i = 0; i < propulsion.size(); ++i) {
+        PropulsionLog log;
+        log.propulsion_log_id = propulsion.recordId.at(i);
+        log.log_id = logId;
+        log.engine_id = ids.name(propulsion.engineId.at(i));
+        log.status = equipmentStatusToString(propulsion.status.at(i));
+        log.rpm = static_cast<int>(propulsion.rpm.at(i));
+        log.engine_load = static_cast<int>(propulsion.engineLoad.at(i));
+        log.power_output = propulsion.powerOutput.at(i);
+        log.fuel_consumption_rate = propulsion.fuelConsumptionRate.at(i);
+        log.exhaust_gas_temp = static_cast<int>(propulsion.exhaustGasTemp.at(i));
+        logs.propulsion_logs.append(log);
+    }
+
+    logs.electrical_logs.reserve(electrical.size());
+    for (int i = 0; i < electrical.size(); ++i) {
+        ElectricalLog log;
+        log.electrical_log_id = electrical.recordId.at(i);
+        log.log_id = logId;
+        log.generator_id = ids.name(electrical.generatorId.at(i));
+        log.status = equipmentStatusToString(electrical.status.at(i));
+        log.gen_load = static_cast<int>(electrical.genLoad.at(i));
+        log.gen_power_output = electrical.genPowerOutput.at(i);
+        log.gen_fuel_consumption_rate = electrical.genFuelConsumptionRate.at(i);
+        logs.electrical_logs.append(log);
+    }
+
+    logs.fuel_tank_logs.reserve(fuelTanks.size());
+    for (int i = 0; i < fuelTanks.size(); ++i) {
+        FuelTankLog log;
+        log.fuel_tank_log_id = fuelTanks.recordId.at(i);
+        log.log_id = logId;
+        log.tank_id = ids.name(fuelTanks.tankId.at(i));
+        log.fuel_type = ids.name(fuelTanks.fuelType.at(i));
+        log.fuel_level = fuelTanks.fuelLevel.at(i);
+        log.fuel_volume = fuelTanks.fuelVolume.at(i);
+        logs.fuel_tank_logs.append(log);
+    }
+
+    logs.ballast_tank_logs.reserve(ballastTanks.size());
+    for (int i = 0; i < ballastTanks.size(); ++i) {
+        BallastTankLog log;
+        log.ballast_tank_log_id = ballastTanks.recordId.at(i);
+        log.log_id = logId;
+        log.tank_id = ids.name(ballastTanks.tankId.at(i));
+        log.tank_level = ballastTanks.tankLevel.at(i);
+        log.pump_status = equipmentStatusToString(ballastTanks.pumpStatus.at(i));
+        log.pump_power_consumption = ballastTanks.pumpPowerConsumption.at(i);
+        logs.ballast_tank_logs.append(log);
+    }
+
+    return logs;
+}
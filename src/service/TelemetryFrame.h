@@ -0,0 +1,170 @@
+#ifndef TELEMETRYFRAME_H
+#define TELEMETRYFRAME_H
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QReadWriteLock>
+#include "VoyageLogs.h"
+
+// ------------------- Interned identifiers -------------------
+// Engine, generator, tank, voyage and fuel type names are stored once and
+// referred to by a 16-bit id everywhere else.
+class TelemetryIdTable
+{
+public:
+    static TelemetryIdTable& instance();
+
+    quint16 intern(const QString& name);
+    QString name(quint16 id) const;
+    int size() const;
+
+private:
+    TelemetryIdTable();
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, quint16> m_ids;
+    QVector<QString> m_names;
+};
+
+enum class EquipmentStatus : quint8 {
+    Unknown = 0,
+    Running,
+    Standby,
+    Stopped,
+    Fault
+};
+
+EquipmentStatus equipmentStatusFromString(const QString& status);
+QString equipmentStatusToString(EquipmentStatus status);
+
+// ------------------- Channels -------------------
+// Every numeric quantity in a frame. Per-equipment channels are addressed
+// together with a slot (the equipment's position in its sub-log list).
+enum class TelemetryChannel : quint16 {
+    // Vessel
+    Latitude = 0,
+    Longitude,
+    ShipSpeed,
+    Course,
+    WindSpeed,
+    SeaState,
+    AirTemperature,
+    Humidity,
+    BarometricPressure,
+    HvacPower,
+    GalleyPower,
+    LightingPower,
+    TotalHotelLoad,
+    // Propulsion (per main engine)
+    Rpm,
+    EngineLoad,
+    PowerOutput,
+    FuelConsumptionRate,
+    ExhaustGasTemp,
+    // Electrical (per generator)
+    GenLoad,
+    GenPowerOutput,
+    GenFuelConsumptionRate,
+    // Fuel tanks
+    FuelLevel,
+    FuelVolume,
+    // Ballast tanks
+    TankLevel,
+    PumpPowerConsumption,
+
+    ChannelCount
+};
+
+QString telemetryChannelName(TelemetryChannel channel);
+bool isPerEquipmentChannel(TelemetryChannel channel);
+
+// Packs (channel, slot) into one key for hashing and file naming
+inline quint32 telemetryChannelKey(TelemetryChannel channel, int slot = 0)
+{
+    return (static_cast<quint32>(channel) << 16) | static_cast<quint16>(slot);
+}
+
+// ------------------- Frame -------------------
+// Struct-of-arrays form of one VoyageLogs sample. Sub-log lists become
+// parallel numeric columns, names become interned ids.
+struct TelemetryFrame
+{
+    qint64 timestampMs = 0;         // UTC, ms since epoch
+    int logId = 0;
+    quint16 voyageId = 0;
+
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double shipSpeed = 0.0;
+    double course = 0.0;
+    double windSpeed = 0.0;
+    double seaState = 0.0;
+    double airTemperature = 0.0;
+    double humidity = 0.0;
+    double barometricPressure = 0.0;
+    double hvacPower = 0.0;
+    double galleyPower = 0.0;
+    double lightingPower = 0.0;
+    double totalHotelLoad = 0.0;
+
+    struct Propulsion {
+        QVector<int> recordId;
+        QVector<quint16> engineId;
+        QVector<EquipmentStatus> status;
+        QVector<double> rpm;
+        QVector<double> engineLoad;
+        QVector<double> powerOutput;
+        QVector<double> fuelConsumptionRate;
+        QVector<double> exhaustGasTemp;
+        int size() const { return engineId.size(); }
+    } propulsion;
+
+    struct Electrical {
+        QVector<int> recordId;
+        QVector<quint16> generatorId;
+        QVector<EquipmentStatus> status;
+        QVector<double> genLoad;
+        QVector<double> genPowerOutput;
+        QVector<double> genFuelConsumptionRate;
+        int size() const { return generatorId.size(); }
+    } electrical;
+
+    struct FuelTanks {
+        QVector<int> recordId;
+        QVector<quint16> tankId;
+        QVector<quint16> fuelType;
+        QVector<double> fuelLevel;
+        QVector<double> fuelVolume;
+        int size() const { return tankId.size(); }
+    } fuelTanks;
+
+    struct BallastTanks {
+        QVector<int> recordId;
+        QVector<quint16> tankId;
+        QVector<EquipmentStatus> pumpStatus;
+        QVector<double> tankLevel;
+        QVector<double> pumpPowerConsumption;
+        int size() const { return tankId.size(); }
+    } ballastTanks;
+
+    // Value of a channel for the given equipment slot, NaN if absent
+    double value(TelemetryChannel channel, int slot = 0) const;
+
+    // Number of equipment slots carrying this channel in this frame
+    int slotCount(TelemetryChannel channel) const;
+
+    // Inverse of value(). Grows the equipment group to slot + 1 if needed;
+    // new slots get id 0, Unknown status and zero readings.
+    void setValue(TelemetryChannel channel, int slot, double value);
+
+    // Adapters for widgets that still consume VoyageLogs
+    static TelemetryFrame fromVoyageLogs(const VoyageLogs& logs);
+    VoyageLogs toVoyageLogs() const;
+
+    static qint64 parseTimestamp(const QString& timestamp);
+};
+
+Q_DECLARE_METATYPE(TelemetryFrame)
+
+#endif // TELEMETRYFRAME_H
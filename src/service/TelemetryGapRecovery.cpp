@@ -0,0 +1,317 @@
+#include "TelemetryGapRecovery.h"
+#include "VoyageLogsDecoder.h"
+#include "VoyageLogsCbor.h"
+#include "TelemetryDcs.h"
+#include <QThreadPool>
+#include <QCoreApplication>
+#include <QUrlQuery>
+#include <QSaveFile>
+#include <QFile>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+
+namespace {
+
+const int kDrainIntervalMs = 50;
+const int kRetryIntervalMs = 5000;
+// Progress inside a gap is saved at most this often; a crash replays at
+// most this much, and merging a record twice is harmless
+const int kJournalSaveIntervalMs = 5000;
+const quint32 kJournalMagic = 0x53434744;   // "SCGD"
+
+} // namespace
+
+TelemetryGapRecovery::TelemetryGapRecovery(QObject *parent)
+    : QObject(parent),
+    m_manager(new QNetworkAccessManager(this)),
+    m_drainTimer(new QTimer(this)),
+    m_retryTimer(new QTimer(this)),
+    m_journalTimer(new QTimer(this)),
+    m_journalDirty(false),
+    m_logId(0),
+    m_generation(0),
+    m_preferCbor(true),
+    m_batchSize(500),
+    m_maxRecordsPerSecond(200)
+{
+    m_drainTimer->setInterval(kDrainIntervalMs);
+    m_retryTimer->setInterval(kRetryIntervalMs);
+    m_retryTimer->setSingleShot(true);
+    m_journalTimer->setInterval(kJournalSaveIntervalMs);
+    m_journalTimer->setSingleShot(true);
+
+    connect(m_manager, &QNetworkAccessManager::finished,
+            this, &TelemetryGapRecovery::onReplyFinished);
+    connect(m_drainTimer, &QTimer::timeout,
+            this, &TelemetryGapRecovery::drainQueue);
+    connect(m_retryTimer, &QTimer::timeout,
+            this, &TelemetryGapRecovery::fetchNextBatch);
+    connect(m_journalTimer, &QTimer::timeout,
+            this, &TelemetryGapRecovery::flushJournal);
+    connect(qApp, &QCoreApplication::aboutToQuit,
+            this, &TelemetryGapRecovery::flushJournal);
+}
+
+void TelemetryGapRecovery::setLogId(int logId)
+{
+    if (logId == m_logId)
+        return;
+
+    // Whatever was not released yet stays in the old stream's journal.
+    // Replies and decodes still under way belong to the old stream too.
+    flushJournal();
+    ++m_generation;
+    if (m_inFlight)
+        m_inFlight->abort();
+    m_retryTimer->stop();
+    m_drainTimer->stop();
+    m_queue.clear();
+
+    m_logId = logId;
+    loadJournal();
+    fetchNextBatch();
+}
+
+bool TelemetryGapRecovery::hasOpenGap() const
+{
+    return !m_gaps.isEmpty() && m_gaps.last().toTimestamp.isEmpty();
+}
+
+void TelemetryGapRecovery::openGap(const QString& fromTimestamp, int fromLogId)
+{
+    if (hasOpenGap() || fromTimestamp.isEmpty())
+        return;
+
+    Gap gap;
+    gap.fromTimestamp = fromTimestamp;
+    gap.fromLogId = fromLogId;
+    m_gaps.append(gap);
+    saveJournal();
+
+    qWarning() << "Telemetry link lost after" << fromTimestamp << "- buffering gap";
+}
+
+void TelemetryGapRecovery::closeGap(const QString& toTimestamp)
+{
+    if (!hasOpenGap())
+        return;
+
+    m_gaps.last().toTimestamp = toTimestamp;
+    saveJournal();
+
+    emit recoveryProgress(m_gaps.size(), m_queue.size());
+    fetchNextBatch();
+}
+
+void TelemetryGapRecovery::fetchNextBatch()
+{
+    if (m_inFlight || m_gaps.isEmpty() || m_logId <= 0)
+        return;
+
+    // Only closed gaps are fetched, one batch at a time, and only while the
+    // release queue has room for another batch
+    Gap &gap = m_gaps.first();
+    if (gap.toTimestamp.isEmpty() || m_queue.size() >= m_batchSize)
+        return;
+    if (!m_queue.isEmpty() && m_queue.last().endOfGap)
+        return;   // fully fetched, waiting for the queue to drain
+
+    // The fetch position runs ahead of the released position in the queue
+    QString since = gap.fromTimestamp;
+    int sinceLogId = gap.fromLogId;
+    if (!m_queue.isEmpty()) {
+        since = m_queue.last().delta.timestamp;
+        sinceLogId = m_queue.last().delta.log_id;
+    }
+
+    QUrl url(QString("https://score-api.heyrend.cloud/api/v1/logs-data/voyage/%1").arg(m_logId));
+    QUrlQuery query;
+    query.addQueryItem("since", since);
+    query.addQueryItem("since_log_id", QString::number(sinceLogId));
+    query.addQueryItem("until", gap.toTimestamp);
+    query.addQueryItem("limit", QString::number(m_batchSize));
+    url.setQuery(query);
+
+    QNetworkRequest request(url);
+    if (m_preferCbor)
+        request.setRawHeader("Accept", "application/cbor, application/json;q=0.5");
+    else
+        request.setRawHeader("Accept", "application/json");
+
+    m_inFlight = m_manager->get(request);
+    m_inFlight->setProperty("generation", m_generation);
+}
+
+void TelemetryGapRecovery::onReplyFinished(QNetworkReply* reply)
+{
+    reply->deleteLater();
+    if (reply == m_inFlight)
+        m_inFlight = nullptr;
+
+    if (reply->error() != QNetworkReply::NoError) {
+        if (reply->error() != QNetworkReply::OperationCanceledError) {
+            qWarning() << "Gap recovery error:" << reply->errorString();
+            m_retryTimer->start();
+        }
+        return;
+    }
+
+    const quint64 generation = reply->property("generation").toULongLong();
+    if (generation != m_generation)
+        return;
+
+    WireFormat format = WireFormat::Json;
+    QString contentType = reply->header(QNetworkRequest::ContentTypeHeader).toString();
+    if (contentType.startsWith(VoyageLogsCbor::mimeType()))
+        format = WireFormat::Cbor;
+
+    // Batches are large; decode them off the GUI thread like live replies
+    QThreadPool::globalInstance()->start(
+        new VoyageLogsDecoder(reply->readAll(), format, this,
+                              [this, generation](const DecodedVoyageLogs &decoded) {
+                                  onBatchDecoded(decoded, generation);
+                              }));
+}
+
+void TelemetryGapRecovery::onBatchDecoded(const DecodedVoyageLogs& decoded, quint64 generation)
+{
+    // Decoded after setLogId switched streams: not this queue's records
+    if (generation != m_generation || m_gaps.isEmpty())
+        return;
+
+    if (!decoded.ok) {
+        m_retryTimer->start();
+        return;
+    }
+
+    for (int i = 0; i < decoded.records.size(); ++i) {
+        Pending pending;
+        pending.endOfGap = false;
+        pending.delta = decoded.records.at(i);
+        pending.present = decoded.present.at(i);
+        m_queue.append(pending);
+    }
+
+    // A short batch means the server has nothing more before the gap's end
+    if (decoded.records.size() < m_batchSize) {
+        Pending end;
+        end.endOfGap = true;
+        m_queue.append(end);
+    }
+
+    if (!m_drainTimer->isActive())
+        m_drainTimer->start();
+
+    emit recoveryProgress(m_gaps.size(), m_queue.size());
+    fetchNextBatch();
+}
+
+void TelemetryGapRecovery::drainQueue()
+{
+    int quota = qMax(1, m_maxRecordsPerSecond * kDrainIntervalMs / 1000);
+
+    bool gapCompleted = false;
+    while (quota > 0 && !m_queue.isEmpty() && !m_gaps.isEmpty()) {
+        const Pending pending = m_queue.takeFirst();
+
+        // End-of-gap marker: everything up to the live data is recovered
+        if (pending.endOfGap) {
+            m_gaps.removeFirst();
+            m_journalDirty = true;
+            gapCompleted = true;
+            continue;
+        }
+
+        emit recordRecovered(pending.delta, pending.present);
+        m_gaps.first().fromTimestamp = pending.delta.timestamp;
+        m_gaps.first().fromLogId = pending.delta.log_id;
+        m_journalDirty = true;
+        --quota;
+    }
+
+    // A finished range is saved at once, progress within one on a timer.
+    // Its frames reached the DCS totals late, so its days are refolded.
+    if (gapCompleted) {
+        flushJournal();
+        TelemetryDcs::instance().rebuildLateDays();
+    } else if (m_journalDirty && !m_journalTimer->isActive()) {
+        m_journalTimer->start();
+    }
+
+    if (m_queue.isEmpty())
+        m_drainTimer->stop();
+
+    emit recoveryProgress(m_gaps.size(), m_queue.size());
+    if (!isRecovering())
+        emit recoveryFinished();
+
+    fetchNextBatch();
+}
+
+void TelemetryGapRecovery::flushJournal()
+{
+    m_journalTimer->stop();
+    if (!m_journalDirty)
+        return;
+    m_journalDirty = false;
+    saveJournal();
+}
+
+QString TelemetryGapRecovery::journalPath() const
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(dir).filePath(QString("telemetry-gaps-%1.dat").arg(m_logId));
+}
+
+void TelemetryGapRecovery::loadJournal()
+{
+    m_gaps.clear();
+
+    QFile file(journalPath());
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    qint32 count = 0;
+    in >> magic >> count;
+    if (magic != kJournalMagic)
+        return;
+
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Gap gap;
+        qint32 fromLogId = 0;
+        in >> gap.fromTimestamp >> fromLogId >> gap.toTimestamp;
+        gap.fromLogId = fromLogId;
+        m_gaps.append(gap);
+    }
+
+    // A gap left open by the last session ends wherever live data resumes;
+    // closeGap() fills it in on the first good reply
+}
+
+void TelemetryGapRecovery::saveJournal() const
+{
+    if (m_logId <= 0)
+        return;
+
+    const QString path = journalPath();
+    if (m_gaps.isEmpty()) {
+        QFile::remove(path);
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out << kJournalMagic << qint32(m_gaps.size());
+    for (const Gap &gap : m_gaps)
+        out << gap.fromTimestamp << qint32(gap.fromLogId) << gap.toTimestamp;
+    file.commit();
+}
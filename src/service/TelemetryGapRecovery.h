@@ -0,0 +1,89 @@
+#ifndef TELEMETRYGAPRECOVERY_H
+#define TELEMETRYGAPRECOVERY_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QTimer>
+#include <QList>
+#include <QString>
+#include "MockApiService.h"
+
+struct DecodedVoyageLogs;
+
+// Store-and-forward for the logs-data poll. Intervals the poll could not
+// fetch are journalled to disk as gaps; once the link is back they are
+// fetched oldest first in large range requests, and the recovered records
+// are released in order at a bounded rate so the GUI thread never has to
+// digest an outage in one go. The journal survives restarts.
+class TelemetryGapRecovery : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TelemetryGapRecovery(QObject *parent = nullptr);
+
+    // Switches to the journal of another stream
+    void setLogId(int logId);
+    void setPreferCbor(bool prefer) { m_preferCbor = prefer; }
+
+    // Link lost: records after (timestamp, logId) were not received
+    void openGap(const QString& fromTimestamp, int fromLogId);
+    // Link back: live data resumes at timestamp, recovery can start
+    void closeGap(const QString& toTimestamp);
+    bool hasOpenGap() const;
+
+    int pendingGaps() const { return m_gaps.size(); }
+    int queuedRecords() const { return m_queue.size(); }
+    bool isRecovering() const { return !m_gaps.isEmpty() || !m_queue.isEmpty(); }
+
+    // Records per range request and records released per second
+    void setBatchSize(int records) { m_batchSize = qMax(1, records); }
+    void setMaxRecordsPerSecond(int records) { m_maxRecordsPerSecond = qMax(1, records); }
+
+signals:
+    void recordRecovered(const VoyageLogs& delta, MockApiService::Subsystems present);
+    void recoveryProgress(int pendingGaps, int queuedRecords);
+    void recoveryFinished();
+
+private slots:
+    void onReplyFinished(QNetworkReply* reply);
+    void drainQueue();
+    void flushJournal();
+
+private:
+    struct Gap {
+        QString fromTimestamp;   // exclusive
+        int fromLogId = 0;
+        QString toTimestamp;     // exclusive; empty while the link is down
+    };
+
+    void fetchNextBatch();
+    void onBatchDecoded(const DecodedVoyageLogs& decoded, quint64 generation);
+    void loadJournal();
+    void saveJournal() const;
+    QString journalPath() const;
+
+    QNetworkAccessManager* m_manager;
+    QPointer<QNetworkReply> m_inFlight;
+    QTimer* m_drainTimer;
+    QTimer* m_retryTimer;
+    QTimer* m_journalTimer;     // coalesces progress saves while draining
+    bool m_journalDirty;
+
+    int m_logId;
+    quint64 m_generation;       // bumped by setLogId; older replies are stale
+    bool m_preferCbor;
+    int m_batchSize;
+    int m_maxRecordsPerSecond;
+
+    QList<Gap> m_gaps;                    // oldest first
+    struct Pending {
+        VoyageLogs delta;
+        MockApiService::Subsystems present;
+        bool endOfGap = false;   // marker queued after a gap's last batch
+    };
+    QList<Pending> m_queue;
+};
+
+#endif // TELEMETRYGAPRECOVERY_H
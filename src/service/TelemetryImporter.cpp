@@ -0,0 +1,534 @@
+#include "TelemetryImporter.h"
+#include "TelemetryStore.h"
+#include "TelemetryRollups.h"
+#include "TelemetryDcs.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QVector>
+#include <QPointer>
+#include <QMetaObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const qint64 kWindowBytes = 32 * 1024 * 1024;
+const int kChunksPerThread = 4;
+const int kTimestampField = -2;
+const int kIgnoredField = -1;
+
+const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Strips blanks and one pair of double quotes
+inline void trimField(const char*& p, const char*& end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+        --end;
+    if (end - p >= 2 && *p == '"' && end[-1] == '"') {
+        ++p;
+        --end;
+    }
+}
+
+// Plain decimal with optional sign, fraction and exponent; NaN otherwise.
+// Locale-free and allocation-free, unlike QByteArray::toDouble().
+float parseNumber(const char* p, const char* end)
+{
+    trimField(p, end);
+    if (p == end)
+        return std::numeric_limits<float>::quiet_NaN();
+
+    bool negative = false;
+    if (*p == '-' || *p == '+')
+        negative = *p++ == '-';
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int scale = 0;
+    bool any = false;
+    for (; p < end && isDigit(*p); ++p, any = true) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + quint64(*p - '0');
+            if (mantissa)
+                ++digits;
+        } else {
+            ++scale;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && isDigit(*p); ++p, any = true) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + quint64(*p - '0');
+                if (mantissa)
+                    ++digits;
+                --scale;
+            }
+        }
+    }
+    if (!any)
+        return std::numeric_limits<float>::quiet_NaN();
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExp = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negativeExp = *p++ == '-';
+        int exponent = 0;
+        if (p == end || !isDigit(*p))
+            return std::numeric_limits<float>::quiet_NaN();
+        for (; p < end && isDigit(*p); ++p)
+            exponent = qMin(exponent * 10 + (*p - '0'), 1000);
+        scale += negativeExp ? -exponent : exponent;
+    }
+    if (p != end)
+        return std::numeric_limits<float>::quiet_NaN();
+
+    double value = double(mantissa);
+    if (scale > 0)
+        value *= scale <= 22 ? kPow10[scale] : std::pow(10.0, scale);
+    else if (scale < 0)
+        value /= -scale <= 22 ? kPow10[-scale] : std::pow(10.0, -scale);
+    return float(negative ? -value : value);
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant)
+qint64 daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    const qint64 era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = int(y - era * 400);
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+inline bool readDigits(const char*& p, const char* end, int count, int* value)
+{
+    int v = 0;
+    for (int i = 0; i < count; ++i, ++p) {
+        if (p >= end || !isDigit(*p))
+            return false;
+        v = v * 10 + (*p - '0');
+    }
+    *value = v;
+    return true;
+}
+
+// UTC ms since epoch; 0 if the field is not a timestamp. Accepts epoch
+// seconds or milliseconds, and "YYYY-MM-DD[T ]hh:mm[:ss[.fff]][Z|+hh:mm]"
+// (no zone means UTC, as for frames from the API).
+qint64 parseTimestampMs(const char* p, const char* end)
+{
+    trimField(p, end);
+    if (p == end)
+        return 0;
+
+    const char *q = p;
+    while (q < end && isDigit(*q))
+        ++q;
+    if (q == end) {
+        qint64 value = 0;
+        for (; p < end; ++p)
+            value = value * 10 + (*p - '0');
+        return value < 100000000000LL ? value * 1000 : value;
+    }
+
+    int year, month, day, hour = 0, minute = 0, second = 0, ms = 0;
+    if (!readDigits(p, end, 4, &year) || p >= end || *p++ != '-'
+        || !readDigits(p, end, 2, &month) || p >= end || *p++ != '-'
+        || !readDigits(p, end, 2, &day))
+        return 0;
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return 0;
+
+    if (p < end && (*p == 'T' || *p == ' ')) {
+        ++p;
+        if (!readDigits(p, end, 2, &hour) || p >= end || *p++ != ':' || !readDigits(p, end, 2, &minute))
+            return 0;
+        if (p < end && *p == ':') {
+            ++p;
+            if (!readDigits(p, end, 2, &second))
+                return 0;
+            if (p < end && (*p == '.' || *p == ',')) {
+                ++p;
+                int scale = 100;
+                for (; p < end && isDigit(*p); ++p, scale /= 10)
+                    ms += (*p - '0') * scale;
+            }
+        }
+    }
+
+    qint64 offsetMs = 0;
+    if (p < end && *p == 'Z') {
+        ++p;
+    } else if (p < end && (*p == '+' || *p == '-')) {
+        const int sign = *p++ == '-' ? -1 : 1;
+        int oh = 0, om = 0;
+        if (!readDigits(p, end, 2, &oh))
+            return 0;
+        if (p < end && *p == ':')
+            ++p;
+        if (p < end && !readDigits(p, end, 2, &om))
+            return 0;
+        offsetMs = sign * (oh * 60 + om) * 60000LL;
+    }
+    if (p != end)
+        return 0;
+
+    const qint64 seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return seconds * 1000 + ms - offsetMs;
+}
+
+// Column name to channel key; -2 for the timestamp, -1 if unknown
+qint64 fieldFor(QString name)
+{
+    name = name.trimmed().toLower();
+    if (name.size() >= 2 && name.startsWith('"') && name.endsWith('"'))
+        name = name.mid(1, name.size() - 2).trimmed();
+    name.replace(' ', '_').replace('-', '_');
+
+    static const QStringList timestampNames = { "timestamp", "time", "datetime", "date_time",
+                                                "time_utc", "utc" };
+    if (timestampNames.contains(name))
+        return kTimestampField;
+
+    static const QHash<QString, TelemetryChannel> channels = []() {
+        QHash<QString, TelemetryChannel> names;
+        for (int c = 0; c < int(TelemetryChannel::ChannelCount); ++c) {
+            const TelemetryChannel channel = static_cast<TelemetryChannel>(c);
+            names.insert(telemetryChannelName(channel), channel);
+        }
+        names.insert("lat", TelemetryChannel::Latitude);
+        names.insert("lon", TelemetryChannel::Longitude);
+        names.insert("lng", TelemetryChannel::Longitude);
+        names.insert("speed", TelemetryChannel::ShipSpeed);
+        names.insert("sog", TelemetryChannel::ShipSpeed);
+        names.insert("heading", TelemetryChannel::Course);
+        names.insert("cog", TelemetryChannel::Course);
+        return names;
+    }();
+
+    auto it = channels.constFind(name);
+    if (it != channels.constEnd())
+        return telemetryChannelKey(it.value(), 0);
+
+    // Per-equipment channels carry a 1-based slot suffix
+    const int underscore = name.lastIndexOf('_');
+    if (underscore > 0) {
+        bool ok = false;
+        const int slot = name.mid(underscore + 1).toInt(&ok) - 1;
+        it = channels.constFind(name.left(underscore));
+        if (ok && slot >= 0 && slot < 0xFFFF && it != channels.constEnd() && isPerEquipmentChannel(it.value()))
+            return telemetryChannelKey(it.value(), slot);
+    }
+    return kIgnoredField;
+}
+
+struct ParsedChunk {
+    QVector<qint64> timestamps;
+    QVector<float> values;      // row-major, one row per timestamp
+    qint64 rejected = 0;
+};
+
+void parseChunk(const char* begin, const char* end, char delimiter,
+                const QVector<int>& fields, int columns, ParsedChunk* out)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    out->timestamps.reserve(int((end - begin) / 64));
+    out->values.reserve(out->timestamps.capacity() * columns);
+
+    const char *line = begin;
+    while (line < end) {
+        const char *lineEnd = static_cast<const char*>(memchr(line, '\n', size_t(end - line)));
+        if (!lineEnd)
+            lineEnd = end;
+
+        if (lineEnd > line && !(lineEnd - line == 1 && *line == '\r')) {
+            const int row = out->timestamps.size();
+            out->values.resize((row + 1) * columns);
+            float *values = out->values.data() + qint64(row) * columns;
+            std::fill(values, values + columns, nan);
+
+            qint64 ts = 0;
+            const char *field = line;
+            for (int f = 0; field <= lineEnd; ++f) {
+                const char *fieldEnd = field;
+                while (fieldEnd < lineEnd && *fieldEnd != delimiter)
+                    ++fieldEnd;
+                const int target = f < fields.size() ? fields.at(f) : kIgnoredField;
+                if (target == kTimestampField)
+                    ts = parseTimestampMs(field, fieldEnd);
+                else if (target >= 0)
+                    values[target] = parseNumber(field, fieldEnd);
+                field = fieldEnd + 1;
+            }
+
+            if (ts > 0) {
+                out->timestamps.append(ts);
+            } else {
+                out->values.resize(row * columns);
+                ++out->rejected;
+            }
+        }
+        line = lineEnd + 1;
+    }
+}
+
+} // namespace
+
+TelemetryImporter::TelemetryImporter(QObject *parent)
+    : QObject(parent),
+    m_running(false)
+{
+}
+
+TelemetryImporter::~TelemetryImporter()
+{
+    cancel();
+}
+
+bool TelemetryImporter::start(const QStringList& paths)
+{
+    if (m_running || paths.isEmpty())
+        return false;
+
+    m_running = true;
+    m_cancelled = QSharedPointer<QAtomicInt>::create(0);
+
+    QPointer<TelemetryImporter> receiver(this);
+    QSharedPointer<QAtomicInt> cancelled = m_cancelled;
+    QThreadPool::globalInstance()->start([=]() {
+        int lastPercent = -1;
+        auto report = [&](qint64 done, qint64 total, qint64 rows) {
+            const int percent = total > 0 ? int(done * 100 / total) : 0;
+            if (percent == lastPercent || !receiver)
+                return;
+            lastPercent = percent;
+            QMetaObject::invokeMethod(receiver.data(), [receiver, percent, rows]() {
+                if (receiver && receiver->m_running)
+                    emit receiver->progress(percent, rows);
+            }, Qt::QueuedConnection);
+        };
+
+        QString error;
+        const Stats stats = importFiles(paths, cancelled.data(), report, &error);
+        if (!receiver)
+            return;
+        QMetaObject::invokeMethod(receiver.data(), [receiver, stats, error]() {
+            if (!receiver)
+                return;
+            receiver->m_running = false;
+            receiver->m_stats = stats;
+            const QString message = error.isEmpty()
+                ? QString("Imported %1 of %2 rows from %3 file(s).")
+                      .arg(stats.rowsWritten).arg(stats.rowsParsed).arg(stats.files)
+                : error;
+            emit receiver->finished(error.isEmpty(), message);
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void TelemetryImporter::cancel()
+{
+    if (m_cancelled)
+        m_cancelled->storeRelaxed(1);
+}
+
+TelemetryImporter::Stats TelemetryImporter::importFiles(const QStringList& paths, const QAtomicInt* cancelled,
+                                                        const std::function<void(qint64, qint64, qint64)>& progress,
+                                                        QString* error)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Stats stats;
+    qint64 totalBytes = 0;
+    for (const QString &path : paths)
+        totalBytes += QFileInfo(path).size();
+
+    TelemetryStore &store = TelemetryStore::instance();
+    TelemetryRollups &rollups = TelemetryRollups::instance();
+    TelemetryDcs &dcs = TelemetryDcs::instance();
+    if (!store.isOpen()) {
+        if (error)
+            *error = QStringLiteral("The telemetry history is not open.");
+        return stats;
+    }
+
+    // Parsing uses every core; this thread only waits and appends
+    QThreadPool parsers;
+    parsers.setMaxThreadCount(QThread::idealThreadCount());
+    const int chunkCount = qMax(1, parsers.maxThreadCount() * kChunksPerThread);
+
+    // Days written to; their DCS figures are folded afresh at the end
+    qint64 writtenFromMs = 0;
+    qint64 writtenToMs = 0;
+
+    qint64 bytesBefore = 0;
+    for (const QString &path : paths) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "TelemetryImporter: cannot open" << path << file.errorString();
+            bytesBefore += QFileInfo(path).size();
+            continue;
+        }
+        const qint64 size = file.size();
+        const char *data = size > 0 ? reinterpret_cast<const char*>(file.map(0, size)) : nullptr;
+        if (!data) {
+            qWarning() << "TelemetryImporter: cannot map" << path;
+            bytesBefore += size;
+            continue;
+        }
+
+        // Header: delimiter and column mapping
+        const char *fileEnd = data + size;
+        const char *headerEnd = static_cast<const char*>(memchr(data, '\n', size_t(size)));
+        if (!headerEnd)
+            headerEnd = fileEnd;
+        const QByteArray header(data, int(headerEnd - data));
+        const char delimiter = header.count(';') > header.count(',') ? ';'
+                               : header.count('\t') > header.count(',') ? '\t' : ',';
+
+        QVector<int> fields;
+        TelemetryBatch batch;
+        bool hasTimestamp = false;
+        for (const QByteArray &name : header.split(delimiter)) {
+            const qint64 field = fieldFor(QString::fromUtf8(name));
+            if (field == kTimestampField) {
+                fields.append(hasTimestamp ? kIgnoredField : kTimestampField);
+                hasTimestamp = true;
+            } else if (field >= 0 && !batch.keys.contains(quint32(field))) {
+                fields.append(batch.keys.size());
+                batch.keys.append(quint32(field));
+            } else {
+                fields.append(kIgnoredField);
+            }
+        }
+        if (!hasTimestamp || batch.keys.isEmpty()) {
+            qWarning() << "TelemetryImporter: no timestamp or no known channel in" << path;
+            bytesBefore += size;
+            continue;
+        }
+        const int columns = batch.keys.size();
+        ++stats.files;
+
+        const char *window = headerEnd < fileEnd ? headerEnd + 1 : fileEnd;
+        while (window < fileEnd) {
+            if (cancelled && cancelled->loadRelaxed()) {
+                if (error)
+                    *error = QStringLiteral("Import cancelled.");
+                dcs.rebuild(writtenFromMs, writtenToMs);
+                stats.elapsedNs = timer.nsecsElapsed();
+                return stats;
+            }
+
+            // Window and chunks end on line boundaries
+            const char *windowEnd = window + qMin<qint64>(kWindowBytes, fileEnd - window);
+            if (windowEnd < fileEnd) {
+                const char *nl = static_cast<const char*>(memchr(windowEnd, '\n', size_t(fileEnd - windowEnd)));
+                windowEnd = nl ? nl + 1 : fileEnd;
+            }
+
+            QVector<ParsedChunk> chunks(chunkCount);
+            const qint64 step = qMax<qint64>(1, (windowEnd - window) / chunkCount);
+            const char *chunkBegin = window;
+            for (int c = 0; c < chunkCount && chunkBegin < windowEnd; ++c) {
+                const char *chunkEnd = c == chunkCount - 1 ? windowEnd
+                                                           : qMin(windowEnd, chunkBegin + step);
+                if (chunkEnd < windowEnd) {
+                    const char *nl = static_cast<const char*>(memchr(chunkEnd, '\n', size_t(windowEnd - chunkEnd)));
+                    chunkEnd = nl ? nl + 1 : windowEnd;
+                }
+                ParsedChunk *out = &chunks[c];
+                parsers.start([chunkBegin, chunkEnd, delimiter, &fields, columns, out]() {
+                    parseChunk(chunkBegin, chunkEnd, delimiter, fields, columns, out);
+                });
+                chunkBegin = chunkEnd;
+            }
+            parsers.waitForDone();
+
+            // Chunks in file order, then a stable sort keeps file order
+            // among equal timestamps so the last row for each one wins
+            // within the window (rows already in the history are kept)
+            QVector<qint64> timestamps;
+            QVector<const float*> rows;
+            for (const ParsedChunk &chunk : chunks) {
+                stats.rowsRejected += chunk.rejected;
+                for (int r = 0; r < chunk.timestamps.size(); ++r) {
+                    timestamps.append(chunk.timestamps.at(r));
+                    rows.append(chunk.values.constData() + qint64(r) * columns);
+                }
+            }
+            stats.rowsParsed += timestamps.size();
+
+            QVector<int> order(timestamps.size());
+            for (int i = 0; i < order.size(); ++i)
+                order[i] = i;
+            if (!std::is_sorted(timestamps.constBegin(), timestamps.constEnd())) {
+                std::stable_sort(order.begin(), order.end(), [&timestamps](int a, int b) {
+                    return timestamps.at(a) < timestamps.at(b);
+                });
+            }
+
+            batch.timestamps.clear();
+            batch.columns = QVector<QVector<float>>(columns);
+            for (QVector<float> &column : batch.columns)
+                column.reserve(order.size());
+            for (int i = 0; i < order.size(); ++i) {
+                const int row = order.at(i);
+                if (i + 1 < order.size() && timestamps.at(order.at(i + 1)) == timestamps.at(row))
+                    continue;
+                batch.timestamps.append(timestamps.at(row));
+                for (int c = 0; c < columns; ++c)
+                    batch.columns[c].append(rows.at(row)[c]);
+            }
+
+            QVector<int> written;
+            stats.rowsWritten += store.appendBatch(batch, &written);
+            rollups.addBatch(batch, written);
+            if (!written.isEmpty()) {
+                // The batch is in timestamp order
+                const qint64 first = batch.timestamps.at(written.first());
+                writtenFromMs = writtenToMs > 0 ? qMin(writtenFromMs, first) : first;
+                writtenToMs = qMax(writtenToMs, batch.timestamps.at(written.last()) + 1);
+            }
+
+            stats.bytes += windowEnd - window;
+            window = windowEnd;
+            progress(bytesBefore + (window - data), totalBytes, stats.rowsWritten);
+        }
+
+        file.unmap(const_cast<uchar*>(reinterpret_cast<const uchar*>(data)));
+        bytesBefore += size;
+    }
+
+    // Imported days are past days: compress them now rather than at next start
+    store.archiveSealedSegments();
+    rollups.save();
+    dcs.rebuild(writtenFromMs, writtenToMs);
+    dcs.save();
+
+    stats.elapsedNs = timer.nsecsElapsed();
+    qInfo().noquote() << QString("TelemetryImporter: %1 rows parsed, %2 written, %3 rejected, "
+                                 "%4 MB in %5 ms (%6 M rows/s)")
+                             .arg(stats.rowsParsed).arg(stats.rowsWritten).arg(stats.rowsRejected)
+                             .arg(stats.bytes / 1048576.0, 0, 'f', 1)
+                             .arg(stats.elapsedNs / 1000000)
+                             .arg(stats.rowsPerSecond() / 1e6, 0, 'f', 2);
+    return stats;
+}
@@ -0,0 +1,65 @@
+#ifndef TELEMETRYIMPORTER_H
+#define TELEMETRYIMPORTER_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QStringList>
+#include <functional>
+
+// ------------------- Import -------------------
+// Bulk-loads logger and noon-report CSV archives into the history. Each
+// file is memory-mapped and taken in windows of a few tens of MB; a window
+// is cut into line-aligned chunks that are parsed on every core straight
+// into numeric columns, then sorted, deduplicated and appended to the
+// store and rollups in one go.
+//
+// Within a window the last row for a timestamp wins. The history is
+// append-only, so a timestamp it already holds (from an earlier window or
+// file, or recorded live) keeps its first row and the later one is
+// counted as a duplicate.
+//
+// The first line names the columns: a timestamp column ("timestamp",
+// "time", "datetime", ISO 8601 or epoch seconds/ms) and channels by their
+// telemetryChannelName(), per-equipment channels with a 1-based suffix
+// ("rpm_2", "fuel_level_3"). Files written by TelemetryExporter import
+// unchanged. Unknown columns are ignored.
+class TelemetryImporter : public QObject
+{
+    Q_OBJECT
+public:
+    struct Stats {
+        int files = 0;
+        qint64 bytes = 0;
+        qint64 rowsParsed = 0;
+        qint64 rowsWritten = 0;      // parsed minus duplicates and rows already in the history (first one kept)
+        qint64 rowsRejected = 0;     // no usable timestamp
+        qint64 elapsedNs = 0;
+        double rowsPerSecond() const { return elapsedNs > 0 ? rowsParsed * 1e9 / elapsedNs : 0.0; }
+    };
+
+    explicit TelemetryImporter(QObject *parent = nullptr);
+    ~TelemetryImporter();
+
+    // Runs on the global thread pool; false if an import is already running
+    bool start(const QStringList& paths);
+    void cancel();
+    bool isRunning() const { return m_running; }
+    Stats stats() const { return m_stats; }
+
+    // Synchronous form; progress gets bytes done, bytes in total and rows written
+    static Stats importFiles(const QStringList& paths, const QAtomicInt* cancelled,
+                             const std::function<void(qint64, qint64, qint64)>& progress,
+                             QString* error = nullptr);
+
+signals:
+    void progress(int percent, qint64 rowsWritten);
+    void finished(bool ok, const QString& message);
+
+private:
+    bool m_running;
+    Stats m_stats;
+    QSharedPointer<QAtomicInt> m_cancelled;
+};
+
+#endif // TELEMETRYIMPORTER_H
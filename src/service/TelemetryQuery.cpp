@@ -0,0 +1,214 @@
+#include "TelemetryQuery.h"
+#include "TelemetryStore.h"
+#include "TelemetryRollups.h"
+#include <QPointer>
+#include <QThread>
+#include <QMetaObject>
+#include <QElapsedTimer>
+#include <QtNumeric>
+#include <QDebug>
+
+namespace {
+
+const qint64 kSecondMs = 1000;
+const qint64 kMinuteMs = 60 * kSecondMs;
+const qint64 kDayMs = 24 * 60 * kMinuteMs;
+// Far more points than any chart can show; guards against runaway windows
+const qint64 kMaxBuckets = 1000000;
+// Power below this is idling; SFOC there is noise
+const float kMinSfocPowerKw = 1.0f;
+
+inline bool isCancelled(const QAtomicInt* cancelled)
+{
+    return cancelled && cancelled->loadRelaxed() != 0;
+}
+
+// Fuel rate (kg/h) over power (kW) for rows present in both columns;
+// a merged walk, relying on read() returning each column in time order
+void addSfoc(const QVector<qint64>& fuelTs, const QVector<float>& fuel,
+             const QVector<qint64>& powerTs, const QVector<float>& power,
+             qint64 fromMs, qint64 bucketMs, QVector<TelemetryAggregate>* buckets, qint64* samples)
+{
+    int i = 0, j = 0;
+    while (i < fuelTs.size() && j < powerTs.size()) {
+        if (fuelTs.at(i) < powerTs.at(j)) {
+            ++i;
+        } else if (powerTs.at(j) < fuelTs.at(i)) {
+            ++j;
+        } else {
+            const float kw = power.at(j);
+            if (!qIsNaN(fuel.at(i)) && kw >= kMinSfocPowerKw) {
+                (*buckets)[int((fuelTs.at(i) - fromMs) / bucketMs)].add(fuel.at(i) * 1000.0f / kw);
+                ++*samples;
+            }
+            ++i;
+            ++j;
+        }
+    }
+}
+
+} // namespace
+
+TelemetryQuery::TelemetryQuery(QObject *parent)
+    : QObject(parent),
+    m_nextId(0)
+{
+}
+
+TelemetryQuery::~TelemetryQuery()
+{
+    cancelAll();
+}
+
+QThreadPool* TelemetryQuery::pool()
+{
+    // Shared by every page; kept small so history scans never starve the
+    // decoders on the global pool
+    static QThreadPool* queryPool = []() {
+        QThreadPool *p = new QThreadPool();
+        p->setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+        return p;
+    }();
+    return queryPool;
+}
+
+quint64 TelemetryQuery::submit(const TelemetryWindow& window, Callback callback)
+{
+    const quint64 id = ++m_nextId;
+    QSharedPointer<QAtomicInt> cancelled = QSharedPointer<QAtomicInt>::create(0);
+    m_pending.insert(id, cancelled);
+
+    QPointer<TelemetryQuery> receiver(this);
+    pool()->start([receiver, window, callback, cancelled, id]() {
+        if (cancelled->loadRelaxed())
+            return;
+
+        TelemetryWindowResult result = run(window, cancelled.data());
+        result.id = id;
+        if (cancelled->loadRelaxed() || !receiver)
+            return;
+
+        // Checked again on the receiving side: cancel() may land in between
+        QMetaObject::invokeMethod(receiver.data(), [receiver, callback, cancelled, result]() {
+            if (!receiver || cancelled->loadRelaxed())
+                return;
+            receiver->m_pending.remove(result.id);
+            callback(result);
+        }, Qt::QueuedConnection);
+    });
+    return id;
+}
+
+void TelemetryQuery::cancel(quint64 id)
+{
+    QSharedPointer<QAtomicInt> cancelled = m_pending.take(id);
+    if (cancelled)
+        cancelled->storeRelaxed(1);
+}
+
+void TelemetryQuery::cancelAll()
+{
+    for (auto it = m_pending.constBegin(); it != m_pending.constEnd(); ++it)
+        it.value()->storeRelaxed(1);
+    m_pending.clear();
+}
+
+qint64 TelemetryQuery::bucketForColumns(qint64 fromMs, qint64 toMs, int columns)
+{
+    const qint64 spanMs = qMax<qint64>(toMs - fromMs, 1);
+    return qMax(kSecondMs, (spanMs + qMax(columns, 1) - 1) / qMax(columns, 1));
+}
+
+TelemetryWindowResult TelemetryQuery::run(const TelemetryWindow& window, const QAtomicInt* cancelled)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    TelemetryWindowResult result;
+    if (window.bucketMs <= 0 || window.toMs <= window.fromMs)
+        return result;
+
+    const qint64 bucketCount = (window.toMs - window.fromMs + window.bucketMs - 1) / window.bucketMs;
+    if (bucketCount > kMaxBuckets) {
+        qWarning() << "TelemetryQuery: too many buckets requested:" << bucketCount;
+        return result;
+    }
+
+    const TelemetryStore &store = TelemetryStore::instance();
+    for (int slot : window.equipment) {
+        if (isCancelled(cancelled))
+            return result;
+
+        QVector<TelemetryAggregate> buckets(int(bucketCount));
+
+        if (window.measure == TelemetryWindow::Sfoc) {
+            // A day at a time keeps the copies small and cancellation prompt
+            for (qint64 from = window.fromMs; from < window.toMs && !isCancelled(cancelled); from += kDayMs) {
+                const qint64 to = qMin(from + kDayMs, window.toMs);
+                QVector<qint64> fuelTs, powerTs;
+                QVector<float> fuel, power;
+                store.read(TelemetryChannel::FuelConsumptionRate, slot, from, to, &fuelTs, &fuel);
+                store.read(TelemetryChannel::PowerOutput, slot, from, to, &powerTs, &power);
+                addSfoc(fuelTs, fuel, powerTs, power, window.fromMs, window.bucketMs,
+                        &buckets, &result.samples);
+            }
+        } else {
+            // Rollups answer minute-or-coarser buckets without touching samples
+            bool fromRollups = false;
+            if (window.bucketMs >= kMinuteMs) {
+                const QVector<RollupBucket> rollups = TelemetryRollups::instance().query(
+                    window.channel, slot, window.fromMs, window.toMs, window.bucketMs);
+                for (const RollupBucket &rollup : rollups) {
+                    const qint64 index = (rollup.startMs - window.fromMs) / window.bucketMs;
+                    if (index < 0 || index >= bucketCount)
+                        continue;
+                    buckets[int(index)].merge(rollup.value);
+                    result.samples += rollup.value.count;
+                }
+                fromRollups = !rollups.isEmpty();
+            }
+
+            if (!fromRollups) {
+                store.scan(window.channel, slot, window.fromMs, window.toMs,
+                           [&](const TelemetrySpan &span) {
+                               if (isCancelled(cancelled))
+                                   return;
+                               for (int i = 0; i < span.count; ++i)
+                                   buckets[int((span.timestamps[i] - window.fromMs) / window.bucketMs)].add(span.values[i]);
+                               result.samples += span.count;
+                           });
+            }
+        }
+
+        if (isCancelled(cancelled))
+            return result;
+
+        TelemetryWindowSeries series;
+        series.slot = slot;
+        for (int b = 0; b < buckets.size(); ++b) {
+            const TelemetryAggregate &aggregate = buckets.at(b);
+            if (aggregate.count == 0)
+                continue;
+            const qreal x = qreal(window.fromMs + b * window.bucketMs);
+            series.mean.append(QPointF(x, aggregate.mean()));
+            series.min.append(QPointF(x, aggregate.min));
+            series.max.append(QPointF(x, aggregate.max));
+
+            const QPointF low(x, aggregate.min), high(x, aggregate.max);
+            if (aggregate.min == aggregate.max) {
+                series.envelope.append(low);
+            } else if (series.envelope.isEmpty()
+                       || qAbs(series.envelope.last().y() - low.y()) <= qAbs(series.envelope.last().y() - high.y())) {
+                series.envelope.append(low);
+                series.envelope.append(high);
+            } else {
+                series.envelope.append(high);
+                series.envelope.append(low);
+            }
+        }
+        result.series.append(series);
+    }
+
+    result.elapsedNs = timer.nsecsElapsed();
+    return result;
+}
@@ -0,0 +1,89 @@
+#ifndef TELEMETRYQUERY_H
+#define TELEMETRYQUERY_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QVector>
+#include <functional>
+#include "TelemetryFrame.h"
+
+// What to aggregate: one channel for a set of equipment slots, over
+// [fromMs, toMs) in buckets of bucketMs
+struct TelemetryWindow
+{
+    enum Measure {
+        Channel,    // the channel's own values
+        Sfoc        // specific fuel oil consumption, g/kWh, from fuel rate / power output
+    };
+
+    Measure measure = Channel;
+    TelemetryChannel channel = TelemetryChannel::PowerOutput;
+    QVector<int> equipment;     // slots to aggregate, one series each
+    qint64 fromMs = 0;
+    qint64 toMs = 0;
+    qint64 bucketMs = 60 * 60 * 1000;
+};
+
+// Per-bucket mean, min and max of one slot, x = bucket start in ms.
+// Empty buckets are left out; the lists go straight into QXYSeries::replace.
+// envelope holds each bucket's min and max in the order that joins up with
+// the previous bucket: drawn as one line it keeps every spike, however
+// many samples a bucket covers.
+struct TelemetryWindowSeries
+{
+    int slot = 0;
+    QList<QPointF> mean;
+    QList<QPointF> min;
+    QList<QPointF> max;
+    QList<QPointF> envelope;
+};
+
+struct TelemetryWindowResult
+{
+    quint64 id = 0;
+    QVector<TelemetryWindowSeries> series;      // in the order of TelemetryWindow::equipment
+    qint64 samples = 0;
+    qint64 elapsedNs = 0;
+};
+
+// ------------------- Windowed aggregation -------------------
+// Runs TelemetryWindow queries against the history on a small worker pool.
+// Plain channels at minute resolution or coarser come from the rollup
+// pyramid; finer buckets and derived measures scan the store. A query can
+// be cancelled at any time: the worker stops at its next span and the
+// callback is never called.
+class TelemetryQuery : public QObject
+{
+    Q_OBJECT
+public:
+    using Callback = std::function<void(const TelemetryWindowResult&)>;
+
+    explicit TelemetryQuery(QObject *parent = nullptr);
+    ~TelemetryQuery();
+
+    // Callback runs on this object's thread once the result is ready
+    quint64 submit(const TelemetryWindow& window, Callback callback);
+    void cancel(quint64 id);
+    void cancelAll();
+    int pendingCount() const { return m_pending.size(); }
+
+    // Synchronous form, for callers already off the GUI thread
+    static TelemetryWindowResult run(const TelemetryWindow& window, const QAtomicInt* cancelled = nullptr);
+
+    // Bucket size giving about one bucket per pixel column, i.e. two
+    // envelope points per column; never finer than a second
+    static qint64 bucketForColumns(qint64 fromMs, qint64 toMs, int columns);
+
+private:
+    static QThreadPool* pool();
+
+    quint64 m_nextId;
+    QHash<quint64, QSharedPointer<QAtomicInt>> m_pending;
+};
+
+#endif // TELEMETRYQUERY_H
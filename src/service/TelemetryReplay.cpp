@@ -0,0 +1,297 @@
+#include "TelemetryReplay.h"
+#include "TelemetryStore.h"
+#include <QMap>
+#include <QtNumeric>
+#include <QDebug>
+
+namespace {
+
+const int kTickIntervalMs = 50;
+const double kMinSpeed = 1.0;
+const double kMaxSpeed = 1000.0;
+const qint64 kChunkMs = 10 * 60 * 1000;
+const qint64 kMaxChunkMs = 2 * 60 * 60 * 1000;
+// Stretches of history without frames are jumped over rather than waited out
+const qint64 kGapSkipMs = 5 * 60 * 1000;
+
+template <typename T>
+void zeroFill(QVector<T>& column, int size)
+{
+    column.fill(T(), size);
+}
+
+} // namespace
+
+TelemetryReplay::TelemetryReplay(QObject *parent)
+    : QObject(parent),
+    m_timer(new QTimer(this)),
+    m_open(false),
+    m_startMs(0),
+    m_endMs(0),
+    m_positionMs(0),
+    m_speed(kMinSpeed),
+    m_carryMs(0.0),
+    m_chunkIndex(0),
+    m_chunkEndMs(0)
+{
+    m_timer->setInterval(kTickIntervalMs);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &TelemetryReplay::onTick);
+}
+
+bool TelemetryReplay::open(qint64 fromMs, qint64 toMs)
+{
+    close();
+
+    const TelemetryStore &store = TelemetryStore::instance();
+    if (!store.isOpen() || store.rowCount() == 0)
+        return false;
+
+    m_startMs = qMax(fromMs, store.firstTimestamp());
+    m_endMs = qMin(toMs, store.lastTimestamp() + 1);
+    if (m_endMs <= m_startMs)
+        return false;
+
+    m_open = true;
+    m_positionMs = m_startMs;
+    m_carryMs = 0.0;
+    loadChunk(m_startMs, kChunkMs);
+    if (!ensureFrame()) {
+        m_open = false;
+        return false;
+    }
+
+    emit positionChanged(m_positionMs);
+    return true;
+}
+
+void TelemetryReplay::close()
+{
+    pause();
+    m_open = false;
+    m_chunk.clear();
+    m_chunkIndex = 0;
+    m_chunkEndMs = 0;
+}
+
+void TelemetryReplay::setSpeed(double factor)
+{
+    m_speed = qBound(kMinSpeed, factor, kMaxSpeed);
+}
+
+void TelemetryReplay::play()
+{
+    if (!m_open || m_timer->isActive())
+        return;
+
+    // Played to the end: start over
+    if (!ensureFrame())
+        seek(m_startMs);
+
+    m_carryMs = 0.0;
+    m_wall.start();
+    m_timer->start();
+    emit playingChanged(true);
+}
+
+void TelemetryReplay::pause()
+{
+    if (!m_timer->isActive())
+        return;
+    m_timer->stop();
+    emit playingChanged(false);
+}
+
+void TelemetryReplay::seek(qint64 positionMs)
+{
+    if (!m_open)
+        return;
+
+    positionMs = qBound(m_startMs, positionMs, m_endMs);
+    loadChunk(positionMs, kChunkMs);
+    m_positionMs = positionMs;
+    m_carryMs = 0.0;
+    if (m_timer->isActive())
+        m_wall.restart();
+
+    // Show the state at the new position straight away
+    if (ensureFrame()) {
+        const TelemetryFrame frame = m_chunk.at(m_chunkIndex++);
+        m_positionMs = frame.timestampMs;
+        emit framesReady(QVector<TelemetryFrame>() << frame);
+    }
+    emit positionChanged(m_positionMs);
+}
+
+void TelemetryReplay::step()
+{
+    if (!m_open)
+        return;
+
+    pause();
+    if (!ensureFrame()) {
+        emit finished();
+        return;
+    }
+
+    const TelemetryFrame frame = m_chunk.at(m_chunkIndex++);
+    m_positionMs = frame.timestampMs;
+    emit framesReady(QVector<TelemetryFrame>() << frame);
+    emit positionChanged(m_positionMs);
+}
+
+void TelemetryReplay::onTick()
+{
+    // Virtual clock: wall time since the last tick times the speed
+    const double advance = m_wall.restart() * m_speed + m_carryMs;
+    const qint64 wholeMs = static_cast<qint64>(advance);
+    m_carryMs = advance - wholeMs;
+    m_positionMs += wholeMs;
+
+    QVector<TelemetryFrame> due;
+    while (ensureFrame() && m_chunk.at(m_chunkIndex).timestampMs <= m_positionMs)
+        due.append(m_chunk.at(m_chunkIndex++));
+
+    const bool more = ensureFrame();
+    if (more && due.isEmpty() && m_chunk.at(m_chunkIndex).timestampMs - m_positionMs > kGapSkipMs)
+        m_positionMs = m_chunk.at(m_chunkIndex).timestampMs;
+
+    if (!due.isEmpty())
+        emit framesReady(due);
+
+    if (!more) {
+        m_positionMs = m_endMs;
+        emit positionChanged(m_positionMs);
+        pause();
+        emit finished();
+        return;
+    }
+    emit positionChanged(m_positionMs);
+}
+
+bool TelemetryReplay::ensureFrame()
+{
+    // Empty chunks (the recorder was off) widen the next read, so a long
+    // gap costs a handful of reads instead of one per chunk
+    qint64 span = kChunkMs;
+    while (m_chunkIndex >= m_chunk.size()) {
+        if (!m_open || m_chunkEndMs >= m_endMs)
+            return false;
+        if (!loadChunk(m_chunkEndMs, span))
+            span = qMin(span * 2, kMaxChunkMs);
+    }
+    return true;
+}
+
+bool TelemetryReplay::loadChunk(qint64 fromMs, qint64 spanMs)
+{
+    const TelemetryStore &store = TelemetryStore::instance();
+    const qint64 toMs = qMin(fromMs + spanMs, m_endMs);
+
+    m_chunk.clear();
+    m_chunkIndex = 0;
+    m_chunkEndMs = toMs;
+    if (toMs <= fromMs)
+        return false;
+
+    // One read per column, then rows regrouped by timestamp
+    struct Column {
+        TelemetryChannel channel;
+        int slot;
+        QVector<qint64> timestamps;
+        QVector<float> values;
+    };
+    QVector<Column> columns;
+    QMap<qint64, int> rows;
+
+    const QList<quint32> keys = store.columnKeys();
+    columns.reserve(keys.size());
+    for (quint32 key : keys) {
+        Column column;
+        column.channel = static_cast<TelemetryChannel>(key >> 16);
+        column.slot = int(key & 0xFFFF);
+        if (store.read(column.channel, column.slot, fromMs, toMs, &column.timestamps, &column.values) == 0)
+            continue;
+        for (qint64 ts : column.timestamps)
+            rows.insert(ts, 0);
+        columns.append(column);
+    }
+    if (rows.isEmpty())
+        return false;
+
+    const TelemetryFrame blank = blankFrame();
+    m_chunk.reserve(rows.size());
+    for (auto it = rows.begin(); it != rows.end(); ++it) {
+        it.value() = m_chunk.size();
+        m_chunk.append(blank);
+        m_chunk.last().timestampMs = it.key();
+    }
+
+    for (const Column &column : columns) {
+        for (int i = 0; i < column.timestamps.size(); ++i) {
+            const float value = column.values.at(i);
+            if (!qIsNaN(value))
+                m_chunk[rows.value(column.timestamps.at(i))].setValue(column.channel, column.slot, value);
+        }
+    }
+
+    for (TelemetryFrame &frame : m_chunk)
+        nameNewSlots(frame);
+    return true;
+}
+
+TelemetryFrame TelemetryReplay::blankFrame() const
+{
+    // Identity of the template, readings zeroed
+    TelemetryFrame frame;
+    frame.logId = m_template.logId;
+    frame.voyageId = m_template.voyageId;
+
+    const int nProp = m_template.propulsion.size();
+    frame.propulsion.recordId = m_template.propulsion.recordId;
+    frame.propulsion.engineId = m_template.propulsion.engineId;
+    frame.propulsion.status = m_template.propulsion.status;
+    zeroFill(frame.propulsion.rpm, nProp);
+    zeroFill(frame.propulsion.engineLoad, nProp);
+    zeroFill(frame.propulsion.powerOutput, nProp);
+    zeroFill(frame.propulsion.fuelConsumptionRate, nProp);
+    zeroFill(frame.propulsion.exhaustGasTemp, nProp);
+
+    const int nElec = m_template.electrical.size();
+    frame.electrical.recordId = m_template.electrical.recordId;
+    frame.electrical.generatorId = m_template.electrical.generatorId;
+    frame.electrical.status = m_template.electrical.status;
+    zeroFill(frame.electrical.genLoad, nElec);
+    zeroFill(frame.electrical.genPowerOutput, nElec);
+    zeroFill(frame.electrical.genFuelConsumptionRate, nElec);
+
+    const int nFuel = m_template.fuelTanks.size();
+    frame.fuelTanks.recordId = m_template.fuelTanks.recordId;
+    frame.fuelTanks.tankId = m_template.fuelTanks.tankId;
+    frame.fuelTanks.fuelType = m_template.fuelTanks.fuelType;
+    zeroFill(frame.fuelTanks.fuelLevel, nFuel);
+    zeroFill(frame.fuelTanks.fuelVolume, nFuel);
+
+    const int nBallast = m_template.ballastTanks.size();
+    frame.ballastTanks.recordId = m_template.ballastTanks.recordId;
+    frame.ballastTanks.tankId = m_template.ballastTanks.tankId;
+    frame.ballastTanks.pumpStatus = m_template.ballastTanks.pumpStatus;
+    zeroFill(frame.ballastTanks.tankLevel, nBallast);
+    zeroFill(frame.ballastTanks.pumpPowerConsumption, nBallast);
+
+    return frame;
+}
+
+void TelemetryReplay::nameNewSlots(TelemetryFrame& frame) const
+{
+    TelemetryIdTable &ids = TelemetryIdTable::instance();
+
+    for (int i = m_template.propulsion.size(); i < frame.propulsion.size(); ++i)
+        frame.propulsion.engineId[i] = ids.intern(QString("ME-%1").arg(i + 1));
+    for (int i = m_template.electrical.size(); i < frame.electrical.size(); ++i)
+        frame.electrical.generatorId[i] = ids.intern(QString("DG-%1").arg(i + 1));
+    for (int i = m_template.fuelTanks.size(); i < frame.fuelTanks.size(); ++i)
+        frame.fuelTanks.tankId[i] = ids.intern(QString("FT-%1").arg(i + 1));
+    for (int i = m_template.ballastTanks.size(); i < frame.ballastTanks.size(); ++i)
+        frame.ballastTanks.tankId[i] = ids.intern(QString("BT-%1").arg(i + 1));
+}
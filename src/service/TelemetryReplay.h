@@ -0,0 +1,82 @@
+#ifndef TELEMETRYREPLAY_H
+#define TELEMETRYREPLAY_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include "TelemetryFrame.h"
+
+// Plays a range of the on-disk history back as frames, for training and
+// regression runs. A virtual clock advances at speed() times wall time;
+// every stored frame is emitted exactly once and in timestamp order
+// whatever the speed, so two runs over the same range feed consumers the
+// same sequence. Frames are read from the store in chunks a few minutes
+// long, so seeking anywhere in a months-long history stays cheap.
+//
+// The store only keeps numbers; equipment names, fuel types and status
+// come from a template frame (normally the live state) and slots it does
+// not know are given generic names.
+class TelemetryReplay : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TelemetryReplay(QObject *parent = nullptr);
+
+    // Range of the history to play; false if it holds no frames
+    bool open(qint64 fromMs, qint64 toMs);
+    void close();
+    bool isOpen() const { return m_open; }
+
+    void setTemplate(const TelemetryFrame& frame) { m_template = frame; }
+
+    qint64 startMs() const { return m_startMs; }
+    qint64 endMs() const { return m_endMs; }
+    qint64 positionMs() const { return m_positionMs; }
+    bool isPlaying() const { return m_timer->isActive(); }
+
+    // Playback rate, clamped to 1x..1000x
+    double speed() const { return m_speed; }
+    void setSpeed(double factor);
+
+public slots:
+    void play();
+    void pause();
+    // Jumps to the first frame at or after positionMs and emits it
+    void seek(qint64 positionMs);
+    // Emits the next frame only; pauses first if playing
+    void step();
+
+signals:
+    // Frames due since the last tick, oldest first
+    void framesReady(const QVector<TelemetryFrame>& frames);
+    void positionChanged(qint64 positionMs);
+    void playingChanged(bool playing);
+    void finished();
+
+private slots:
+    void onTick();
+
+private:
+    bool loadChunk(qint64 fromMs, qint64 spanMs);
+    bool ensureFrame();
+    TelemetryFrame blankFrame() const;
+    void nameNewSlots(TelemetryFrame& frame) const;
+
+    QTimer* m_timer;
+    QElapsedTimer m_wall;
+
+    bool m_open;
+    qint64 m_startMs;
+    qint64 m_endMs;             // exclusive
+    qint64 m_positionMs;
+    double m_speed;
+    double m_carryMs;           // sub-millisecond remainder of the virtual clock
+
+    TelemetryFrame m_template;
+    QVector<TelemetryFrame> m_chunk;
+    int m_chunkIndex;           // next frame to emit
+    qint64 m_chunkEndMs;        // exclusive end of the loaded chunk
+};
+
+#endif // TELEMETRYREPLAY_H
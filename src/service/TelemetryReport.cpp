@@ -0,0 +1,631 @@
+#include "TelemetryReport.h"
+#include "TelemetryDcs.h"
+#include "TelemetryRollups.h"
+#include "TelemetryStore.h"
+#include <QPdfWriter>
+#include <QPainter>
+#include <QImage>
+#include <QSaveFile>
+#include <QSettings>
+#include <QDir>
+#include <QFile>
+#include <QDateTime>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QPointer>
+#include <QMetaObject>
+#include <QThreadPool>
+#include <QtMath>
+#include <QDebug>
+#include <limits>
+
+namespace {
+
+const qint64 kHourMs = 3600 * 1000;
+const qint64 kDayMs = 24 * kHourMs;
+const int kResolution = 150;           // dpi; plenty for text and charts on A4
+
+struct Vessel {
+    QString name;
+    QString imo;
+    QString type;
+    double deadweight = 0.0;
+
+    static Vessel fromSettings()
+    {
+        QSettings settings;
+        Vessel vessel;
+        vessel.name = settings.value("vessel/name", "MV Example").toString();
+        vessel.imo = settings.value("vessel/imo", "IMO 1234567").toString();
+        vessel.type = settings.value("vessel/type", "Container Ship").toString();
+        vessel.deadweight = settings.value("vessel/deadweight", 50000).toDouble();
+        return vessel;
+    }
+
+    // Changes whenever a figure computed from the particulars would
+    QString fingerprint() const
+    {
+        const QByteArray text = QString("%1|%2|%3|%4").arg(name, imo, type).arg(deadweight).toUtf8();
+        return QCryptographicHash::hash(text, QCryptographicHash::Md5).toHex().left(8);
+    }
+};
+
+struct ReportJob {
+    TelemetryReport::Type type = TelemetryReport::Cii;
+    TelemetryReport::Period period;
+    Vessel vessel;
+    DcsFigures figures;
+    QMap<qint64, DcsFigures> days;
+    qint64 fromMs = 0;
+    qint64 toMs = 0;
+};
+
+void hashFigures(QDataStream& out, const DcsFigures& figures)
+{
+    out << figures.firstMs << figures.lastMs << figures.distanceNm << figures.hoursUnderway
+        << figures.fuelTonnes;
+}
+
+// Changes whenever the totals or any day the report is drawn from do, a
+// rebuilt or late-filled day included
+QString dataFingerprint(const ReportJob& job)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    hashFigures(out, job.figures);
+    out << qint32(job.days.size());
+    for (auto it = job.days.constBegin(); it != job.days.constEnd(); ++it) {
+        out << it.key();
+        hashFigures(out, it.value());
+    }
+    return QCryptographicHash::hash(bytes, QCryptographicHash::Md5).toHex().left(16);
+}
+
+// ------- CII (MEPC.353(78), MEPC.354(78), MEPC.338(76)) -------
+
+struct CiiReference {
+    double a;
+    double c;
+    double capacity;
+    double d[4];        // rating boundaries over required CII: A|B, B|C, C|D, D|E
+};
+
+CiiReference ciiReference(const QString& shipType, double deadweight)
+{
+    const QString type = shipType.toLower();
+    if (type.contains("bulk"))
+        return {4745.0, 0.622, qMin(deadweight, 279000.0), {0.86, 0.94, 1.06, 1.18}};
+    if (type.contains("lng")) {
+        if (deadweight >= 100000.0)
+            return {9.827, 0.0, deadweight, {0.89, 0.98, 1.06, 1.13}};
+        return {14479e10, 2.673, qMax(deadweight, 65000.0), {0.78, 0.92, 1.10, 1.37}};
+    }
+    if (type.contains("tanker"))
+        return {5247.0, 0.610, deadweight, {0.82, 0.93, 1.08, 1.28}};
+    if (type.contains("general"))
+        return {31948.0, 0.792, deadweight, {0.83, 0.94, 1.06, 1.19}};
+    if (type.contains("ro-ro"))
+        return {10952.0, 0.637, deadweight, {0.66, 0.90, 1.11, 1.37}};
+    return {1984.0, 0.489, deadweight, {0.83, 0.94, 1.07, 1.19}};      // container ship
+}
+
+// Reduction below the 2019 reference line, percent
+double ciiReduction(int year)
+{
+    static const double reductions[] = {5.0, 7.0, 9.0, 11.0, 13.625, 16.25, 18.875, 21.5};
+    if (year < 2023)
+        return 0.0;
+    return reductions[qMin(year - 2023, 7)];
+}
+
+// g CO2 per capacity tonne-mile
+double attainedCii(double co2Tonnes, double capacity, double distanceNm)
+{
+    return capacity > 0.0 && distanceNm > 0.0 ? co2Tonnes * 1e6 / (capacity * distanceNm) : 0.0;
+}
+
+QChar ciiRating(double ratio, const CiiReference& reference)
+{
+    for (int i = 0; i < 4; ++i) {
+        if (ratio <= reference.d[i])
+            return QChar('A' + i);
+    }
+    return QChar('E');
+}
+
+// ------- Off-screen charts -------
+
+struct ChartLine {
+    QString name;
+    QColor color;
+    QVector<QPointF> points;    // x in ms since epoch
+    Qt::PenStyle style = Qt::SolidLine;
+};
+
+QImage renderChart(const QString& title, const QString& unit, const QVector<ChartLine>& lines, const QSize& size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    QFont font("Helvetica");
+    font.setPixelSize(qMax(10, size.height() / 24));
+    p.setFont(font);
+    const QFontMetrics fm(font);
+    const int line = fm.height();
+
+    QFont titleFont = font;
+    titleFont.setBold(true);
+    p.setFont(titleFont);
+    p.drawText(QRect(0, 0, size.width(), line + 4), Qt::AlignCenter, title);
+    p.setFont(font);
+
+    double minX = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = 0.0;
+    for (const ChartLine &chartLine : lines) {
+        for (const QPointF &point : chartLine.points) {
+            minX = qMin(minX, point.x());
+            maxX = qMax(maxX, point.x());
+            maxY = qMax(maxY, point.y());
+        }
+    }
+
+    const QRect plot(fm.horizontalAdvance("000000.0") + 8, line * 2,
+                     size.width() - fm.horizontalAdvance("000000.0") - 24, size.height() - line * 5);
+    p.setPen(QColor(160, 160, 160));
+    p.drawRect(plot);
+    if (maxX <= minX) {
+        p.setPen(Qt::darkGray);
+        p.drawText(plot, Qt::AlignCenter, QStringLiteral("No data recorded for this period"));
+        return image;
+    }
+    maxY = maxY > 0.0 ? maxY * 1.1 : 1.0;
+
+    auto map = [&](const QPointF &point) {
+        return QPointF(plot.left() + (point.x() - minX) / (maxX - minX) * plot.width(),
+                       plot.bottom() - point.y() / maxY * plot.height());
+    };
+
+    // Grid and axis labels
+    const bool shortSpan = maxX - minX < 3.0 * kDayMs;
+    for (int i = 0; i <= 5; ++i) {
+        const int y = plot.bottom() - plot.height() * i / 5;
+        p.setPen(QColor(225, 225, 225));
+        p.drawLine(plot.left(), y, plot.right(), y);
+        p.setPen(Qt::black);
+        p.drawText(QRect(0, y - line / 2, plot.left() - 6, line), Qt::AlignRight | Qt::AlignVCenter,
+                   QString::number(maxY * i / 5, 'f', maxY < 10.0 ? 2 : 1));
+
+        const int x = plot.left() + plot.width() * i / 5;
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(qint64(minX + (maxX - minX) * i / 5), Qt::UTC);
+        p.drawText(QRect(x - 60, plot.bottom() + 4, 120, line), Qt::AlignCenter,
+                   time.toString(shortSpan ? "dd MMM hh:mm" : "dd MMM yyyy"));
+    }
+    p.drawText(QRect(plot.left(), line, plot.width(), line), Qt::AlignLeft | Qt::AlignVCenter, unit);
+
+    // Series and legend
+    int legendX = plot.left();
+    const int legendY = plot.bottom() + line * 2;
+    for (const ChartLine &chartLine : lines) {
+        QPolygonF polygon;
+        polygon.reserve(chartLine.points.size());
+        for (const QPointF &point : chartLine.points)
+            polygon.append(map(point));
+        p.setPen(QPen(chartLine.color, 2.0, chartLine.style));
+        p.drawPolyline(polygon);
+
+        p.drawLine(legendX, legendY + line / 2, legendX + 24, legendY + line / 2);
+        p.setPen(Qt::black);
+        p.drawText(legendX + 30, legendY, fm.horizontalAdvance(chartLine.name) + 4, line,
+                   Qt::AlignVCenter, chartLine.name);
+        legendX += 30 + fm.horizontalAdvance(chartLine.name) + 24;
+    }
+    return image;
+}
+
+QColor seriesColor(int index)
+{
+    static const QColor colors[] = {QColor(52, 168, 83), QColor(66, 133, 244), QColor(251, 188, 5),
+                                    QColor(234, 67, 53), QColor(103, 58, 183)};
+    return colors[index % 5];
+}
+
+// ------- Page layout -------
+
+// Top-to-bottom layout on the PDF pages, breaking pages as needed
+class ReportCanvas
+{
+public:
+    explicit ReportCanvas(QPdfWriter* writer)
+        : m_writer(writer), m_painter(writer), m_width(writer->width()), m_y(0)
+    {
+        m_font = QFont("Helvetica", 10);
+    }
+
+    bool isActive() const { return m_painter.isActive(); }
+    int width() const { return m_width; }
+
+    void title(const QString& text, const QString& subtitle)
+    {
+        QFont font = m_font;
+        font.setPointSize(18);
+        font.setBold(true);
+        draw(text, font, QColor(33, 33, 33));
+        font.setPointSize(11);
+        font.setBold(false);
+        draw(subtitle, font, QColor(90, 90, 90));
+        m_y += lineHeight(m_font);
+    }
+
+    void heading(const QString& text)
+    {
+        QFont font = m_font;
+        font.setPointSize(13);
+        font.setBold(true);
+        ensureSpace(lineHeight(font) * 3);
+        m_y += lineHeight(m_font) / 2;
+        draw(text, font, QColor(52, 168, 83));
+    }
+
+    void table(const QList<QPair<QString, QString>>& rows)
+    {
+        m_painter.setFont(m_font);
+        const int rowHeight = lineHeight(m_font) + 6;
+        for (int i = 0; i < rows.size(); ++i) {
+            ensureSpace(rowHeight);
+            if (i % 2 == 0)
+                m_painter.fillRect(QRect(0, m_y, m_width, rowHeight), QColor(243, 246, 244));
+            m_painter.setPen(Qt::black);
+            m_painter.drawText(QRect(8, m_y, m_width / 2, rowHeight), Qt::AlignVCenter, rows.at(i).first);
+            m_painter.drawText(QRect(m_width / 2, m_y, m_width / 2 - 8, rowHeight),
+                               Qt::AlignVCenter | Qt::AlignRight, rows.at(i).second);
+            m_y += rowHeight;
+        }
+    }
+
+    void chart(const QString& title, const QString& unit, const QVector<ChartLine>& lines)
+    {
+        const QSize size(m_width, m_width * 2 / 5);
+        ensureSpace(size.height() + 10);
+        m_y += 10;
+        m_painter.drawImage(QRect(QPoint(0, m_y), size), renderChart(title, unit, lines, size));
+        m_y += size.height();
+    }
+
+    void note(const QString& text)
+    {
+        QFont font = m_font;
+        font.setPointSize(8);
+        m_painter.setFont(font);
+        m_painter.setPen(QColor(110, 110, 110));
+        const QRect bounds = m_painter.boundingRect(QRect(0, 0, m_width, 10000), Qt::TextWordWrap, text);
+        ensureSpace(bounds.height() + 10);
+        m_y += 10;
+        m_painter.drawText(QRect(0, m_y, m_width, bounds.height()), Qt::TextWordWrap, text);
+        m_y += bounds.height();
+    }
+
+private:
+    int lineHeight(const QFont& font) { return QFontMetrics(font, m_writer).height(); }
+
+    void draw(const QString& text, const QFont& font, const QColor& color)
+    {
+        m_painter.setFont(font);
+        m_painter.setPen(color);
+        const int height = lineHeight(font);
+        ensureSpace(height);
+        m_painter.drawText(QRect(0, m_y, m_width, height), Qt::AlignVCenter, text);
+        m_y += height + 4;
+    }
+
+    void ensureSpace(int height)
+    {
+        if (m_y > 0 && m_y + height > m_writer->height()) {
+            m_writer->newPage();
+            m_y = 0;
+        }
+    }
+
+    QPdfWriter *m_writer;
+    QPainter m_painter;
+    QFont m_font;
+    int m_width;
+    int m_y;
+};
+
+QString number(double value, int decimals)
+{
+    return QString::number(value, 'f', decimals);
+}
+
+QString utc(qint64 ms)
+{
+    return ms > 0 ? QDateTime::fromMSecsSinceEpoch(ms, Qt::UTC).toString("yyyy-MM-dd hh:mm 'UTC'") : QString("-");
+}
+
+// Running totals per fuel type over the period's days, plotted at each day's end
+QVector<ChartLine> cumulativeFuel(const QMap<qint64, DcsFigures>& days)
+{
+    QVector<ChartLine> lines;
+    QHash<QString, int> lineFor;
+    QHash<QString, double> totals;
+    for (auto day = days.constBegin(); day != days.constEnd(); ++day) {
+        for (auto it = day.value().fuelTonnes.constBegin(); it != day.value().fuelTonnes.constEnd(); ++it) {
+            if (!lineFor.contains(it.key())) {
+                lineFor.insert(it.key(), lines.size());
+                ChartLine chartLine;
+                chartLine.name = it.key();
+                chartLine.color = seriesColor(lines.size());
+                chartLine.points.append(QPointF(days.firstKey(), 0.0));
+                lines.append(chartLine);
+            }
+            totals[it.key()] += it.value();
+            lines[lineFor.value(it.key())].points.append(QPointF(day.key() + kDayMs, totals.value(it.key())));
+        }
+    }
+    return lines;
+}
+
+// Hourly mean of a channel, summed over equipment slots, from the rollups
+ChartLine hourlySeries(const QString& name, TelemetryChannel channel, int slots, qint64 fromMs, qint64 toMs,
+                       double scale)
+{
+    QMap<qint64, double> totals;
+    for (int slot = 0; slot < slots; ++slot) {
+        const QVector<RollupBucket> buckets =
+            TelemetryRollups::instance().query(channel, slot, fromMs, toMs, kHourMs);
+        for (const RollupBucket &bucket : buckets)
+            totals[bucket.startMs] += bucket.value.mean() * scale;
+    }
+    ChartLine chartLine;
+    chartLine.name = name;
+    for (auto it = totals.constBegin(); it != totals.constEnd(); ++it)
+        chartLine.points.append(QPointF(it.key(), it.value()));
+    return chartLine;
+}
+
+void fuelRows(const DcsFigures& figures, QList<QPair<QString, QString>>* rows)
+{
+    for (auto it = figures.fuelTonnes.constBegin(); it != figures.fuelTonnes.constEnd(); ++it) {
+        *rows << qMakePair(QString("Fuel consumed: %1 (Cf %2)").arg(it.key(), number(TelemetryDcs::carbonFactor(it.key()), 3)),
+                           number(it.value(), 2) + " t");
+    }
+    *rows << qMakePair(QString("Total fuel consumed"), number(figures.totalFuelTonnes(), 2) + " t")
+          << qMakePair(QString("CO2 emitted"), number(figures.co2Tonnes(), 2) + " t");
+}
+
+// Returns an error message, empty on success
+QString renderReport(const ReportJob& job, QIODevice* device)
+{
+    QPdfWriter writer(device);
+    writer.setPageSize(QPageSize(QPageSize::A4));
+    writer.setPageMargins(QMarginsF(15, 15, 15, 15), QPageLayout::Millimeter);
+    writer.setResolution(kResolution);
+    writer.setCreator("S-Core");
+    writer.setTitle(TelemetryReport::typeName(job.type) + " - " + job.period.label());
+
+    ReportCanvas canvas(&writer);
+    if (!canvas.isActive())
+        return QStringLiteral("Cannot start the PDF writer.");
+
+    const DcsFigures &figures = job.figures;
+    const Vessel &vessel = job.vessel;
+    canvas.title(TelemetryReport::typeName(job.type),
+                 QString("%1  |  generated %2").arg(job.period.label(),
+                                                    utc(QDateTime::currentMSecsSinceEpoch())));
+
+    canvas.heading("Ship particulars");
+    canvas.table({qMakePair(QString("Name"), vessel.name),
+                  qMakePair(QString("IMO number"), vessel.imo),
+                  qMakePair(QString("Ship type"), vessel.type),
+                  qMakePair(QString("Deadweight"), number(vessel.deadweight, 0) + " t")});
+
+    const CiiReference reference = ciiReference(vessel.type, vessel.deadweight);
+    const double attained = attainedCii(figures.co2Tonnes(), reference.capacity, figures.distanceNm);
+    const int ciiYear = job.period.voyage.isEmpty() ? job.period.year
+                                                    : QDateTime::fromMSecsSinceEpoch(figures.firstMs, Qt::UTC).date().year();
+
+    QList<QPair<QString, QString>> rows;
+    rows << qMakePair(QString("Start of period"), utc(figures.firstMs))
+         << qMakePair(QString("End of period"), utc(figures.lastMs))
+         << qMakePair(QString("Distance travelled"), number(figures.distanceNm, 1) + " nm")
+         << qMakePair(QString("Hours underway"), number(figures.hoursUnderway, 1) + " h");
+
+    switch (job.type) {
+    case TelemetryReport::Dcs: {
+        fuelRows(figures, &rows);
+        canvas.heading("Fuel oil consumption data (MARPOL Annex VI, regulation 27)");
+        canvas.table(rows);
+        canvas.chart("Cumulative fuel consumption", "t", cumulativeFuel(job.days));
+        canvas.note("Fuel consumed is measured by tank soundings (fuel_volume) converted to mass with the "
+                    "fuel type's density. Small rises in tank volume (sloshing, sounding noise) are netted "
+                    "against later drops; a rise of more than 2 m³ per fuel type, or one not used up within "
+                    "2 h, is treated as bunkering.");
+        break;
+    }
+    case TelemetryReport::Cii: {
+        const double referenceCii = reference.a * qPow(reference.capacity, -reference.c);
+        const double required = referenceCii * (1.0 - ciiReduction(ciiYear) / 100.0);
+        const double ratio = required > 0.0 ? attained / required : 0.0;
+        rows << qMakePair(QString("CO2 emitted"), number(figures.co2Tonnes(), 2) + " t")
+             << qMakePair(QString("Capacity"), number(reference.capacity, 0) + " DWT")
+             << qMakePair(QString("Attained CII"), number(attained, 3) + " gCO2/t·nm")
+             << qMakePair(QString("Reference CII (2019)"), number(referenceCii, 3) + " gCO2/t·nm")
+             << qMakePair(QString("Reduction factor Z (%1)").arg(ciiYear), number(ciiReduction(ciiYear), 3) + " %")
+             << qMakePair(QString("Required CII"), number(required, 3) + " gCO2/t·nm")
+             << qMakePair(QString("Attained / required"), number(ratio, 3))
+             << qMakePair(QString("Operational carbon intensity rating"),
+                          attained > 0.0 ? QString(ciiRating(ratio, reference)) : QString("-"));
+        canvas.heading("Operational carbon intensity (MARPOL Annex VI, regulation 28)");
+        canvas.table(rows);
+
+        QList<QPair<QString, QString>> boundaries;
+        for (int i = 0; i < 4; ++i) {
+            boundaries << qMakePair(QString("%1 | %2 boundary").arg(QChar('A' + i)).arg(QChar('B' + i)),
+                                    number(required * reference.d[i], 3) + " gCO2/t·nm");
+        }
+        canvas.heading("Rating boundaries");
+        canvas.table(boundaries);
+
+        // Attained CII to date over the period against the required line
+        ChartLine attainedLine;
+        attainedLine.name = "Attained CII to date";
+        attainedLine.color = seriesColor(0);
+        ChartLine requiredLine;
+        requiredLine.name = "Required CII";
+        requiredLine.color = seriesColor(3);
+        requiredLine.style = Qt::DashLine;
+        double co2 = 0.0, distance = 0.0;
+        for (auto day = job.days.constBegin(); day != job.days.constEnd(); ++day) {
+            co2 += day.value().co2Tonnes();
+            distance += day.value().distanceNm;
+            if (distance > 0.0)
+                attainedLine.points.append(QPointF(day.key() + kDayMs, attainedCii(co2, reference.capacity, distance)));
+        }
+        if (!attainedLine.points.isEmpty()) {
+            requiredLine.points << QPointF(attainedLine.points.first().x(), required)
+                                << QPointF(attainedLine.points.last().x(), required);
+        }
+        canvas.chart("Attained CII to date", "gCO2/t·nm", QVector<ChartLine>() << attainedLine << requiredLine);
+        canvas.note("Attained CII per MEPC.352(78): CO2 mass over capacity times distance travelled. "
+                    "Reference lines per MEPC.353(78), reduction factors per MEPC.338(76) and "
+                    "rating boundaries per MEPC.354(78).");
+        break;
+    }
+    case TelemetryReport::VoyageSummary: {
+        const double hours = (figures.lastMs - figures.firstMs) / double(kHourMs);
+        rows << qMakePair(QString("Duration"), number(hours, 1) + " h")
+             << qMakePair(QString("Average speed underway"),
+                          figures.hoursUnderway > 0.0 ? number(figures.distanceNm / figures.hoursUnderway, 2) + " kn"
+                                                      : QString("-"));
+        fuelRows(figures, &rows);
+        rows << qMakePair(QString("Attained CII (voyage)"), number(attained, 3) + " gCO2/t·nm");
+        canvas.heading("Voyage");
+        canvas.table(rows);
+
+        ChartLine speed = hourlySeries("Ship speed", TelemetryChannel::ShipSpeed, 1, job.fromMs, job.toMs, 1.0);
+        speed.color = seriesColor(1);
+        canvas.chart("Ship speed, hourly mean", "kn", QVector<ChartLine>() << speed);
+
+        ChartLine power = hourlySeries("Main engines", TelemetryChannel::PowerOutput, 8, job.fromMs, job.toMs, 0.001);
+        power.color = seriesColor(0);
+        canvas.chart("Propulsion power, hourly mean", "MW", QVector<ChartLine>() << power);
+        canvas.chart("Cumulative fuel consumption", "t", cumulativeFuel(job.days));
+        break;
+    }
+    }
+    return QString();
+}
+
+} // namespace
+
+// ------------------- TelemetryReport -------------------
+
+QString TelemetryReport::Period::key() const
+{
+    if (voyage.isEmpty())
+        return QString("y%1").arg(year);
+    // Voyage names are free text; the file name only needs them distinct
+    return "v" + QCryptographicHash::hash(voyage.toUtf8(), QCryptographicHash::Md5).toHex().left(12);
+}
+
+QString TelemetryReport::Period::label() const
+{
+    return voyage.isEmpty() ? QString("Calendar Year %1").arg(year) : QString("Voyage %1").arg(voyage);
+}
+
+TelemetryReport::TelemetryReport(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QString TelemetryReport::typeName(Type type)
+{
+    switch (type) {
+    case Cii:           return QStringLiteral("Operational Carbon Intensity (CII) Report");
+    case Dcs:           return QStringLiteral("IMO DCS Fuel Oil Consumption Report");
+    case VoyageSummary: return QStringLiteral("Voyage Summary");
+    }
+    return QString();
+}
+
+QString TelemetryReport::cacheDirectory()
+{
+    return QDir(TelemetryStore::defaultDirectory()).filePath("reports");
+}
+
+QString TelemetryReport::request(Type type, const Period& period)
+{
+    // Snapshot on the calling thread: the file name then matches the data
+    // the report is rendered from
+    ReportJob job;
+    job.type = type;
+    job.period = period;
+    job.vessel = Vessel::fromSettings();
+    const TelemetryDcs &dcs = TelemetryDcs::instance();
+    if (period.voyage.isEmpty()) {
+        job.figures = dcs.year(period.year);
+        job.fromMs = QDateTime(QDate(period.year, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+        job.toMs = QDateTime(QDate(period.year + 1, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    } else {
+        job.figures = dcs.voyage(period.voyage);
+        job.fromMs = job.figures.firstMs;
+        job.toMs = job.figures.lastMs + 1;
+    }
+    job.days = dcs.days(job.fromMs, job.toMs);
+
+    static const char *const tags[] = {"cii", "dcs", "voyage"};
+    const QString prefix = QString("%1-%2-").arg(tags[type], period.key());
+    const QDir dir(cacheDirectory());
+    const QString path = dir.filePath(QString("%1%2-%3.pdf").arg(prefix, dataFingerprint(job),
+                                                                 job.vessel.fingerprint()));
+    if (QFile::exists(path))
+        return path;
+    if (m_pending.contains(path))
+        return QString();
+
+    m_pending.insert(path);
+    QPointer<TelemetryReport> receiver(this);
+    QThreadPool::globalInstance()->start([receiver, job, path, prefix]() {
+        QDir dir(cacheDirectory());
+        dir.mkpath(".");
+
+        QSaveFile file(path);
+        QString error;
+        if (!file.open(QIODevice::WriteOnly)) {
+            error = file.errorString();
+        } else {
+            error = renderReport(job, &file);
+            if (error.isEmpty() && !file.commit())
+                error = file.errorString();
+        }
+
+        // Only the newest version of a report is kept
+        if (error.isEmpty()) {
+            const QStringList stale = dir.entryList(QStringList() << prefix + "*.pdf", QDir::Files);
+            for (const QString &name : stale) {
+                if (dir.filePath(name) != path)
+                    dir.remove(name);
+            }
+        } else {
+            qWarning() << "TelemetryReport:" << path << error;
+        }
+
+        if (!receiver)
+            return;
+        const int type = int(job.type);
+        const QString periodKey = job.period.key();
+        QMetaObject::invokeMethod(receiver.data(), [receiver, type, periodKey, path, error]() {
+            if (!receiver)
+                return;
+            receiver->m_pending.remove(path);
+            if (error.isEmpty())
+                emit receiver->reportReady(type, periodKey, path);
+            else
+                emit receiver->reportFailed(type, periodKey, error);
+        }, Qt::QueuedConnection);
+    });
+    return QString();
+}
@@ -0,0 +1,55 @@
+#ifndef TELEMETRYREPORT_H
+#define TELEMETRYREPORT_H
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+// ------------------- Reports -------------------
+// CII, DCS and voyage summary reports rendered to PDF from the DCS totals
+// and the rollup pyramid. Rendering (charts included, drawn into images
+// off-screen) runs on the global thread pool.
+//
+// Finished reports are kept on disk under a name made of the report type,
+// the period, a hash of the DCS totals and daily figures the report is
+// drawn from and the vessel particulars they were computed with. Asking
+// again for a report whose data has not moved returns the existing file at
+// once; once it has, rebuilt days included, the report is rendered anew
+// and older versions are removed.
+class TelemetryReport : public QObject
+{
+    Q_OBJECT
+public:
+    enum Type {
+        Cii = 0,
+        Dcs,
+        VoyageSummary
+    };
+
+    // A calendar year, or a voyage when voyage is set
+    struct Period {
+        int year = 0;
+        QString voyage;
+
+        QString key() const;
+        QString label() const;
+    };
+
+    explicit TelemetryReport(QObject *parent = nullptr);
+
+    // Path of an up-to-date report if there is one; otherwise empty, and
+    // reportReady or reportFailed follows
+    QString request(Type type, const Period& period);
+
+    static QString typeName(Type type);
+    static QString cacheDirectory();
+
+signals:
+    void reportReady(int type, const QString& periodKey, const QString& path);
+    void reportFailed(int type, const QString& periodKey, const QString& message);
+
+private:
+    QSet<QString> m_pending;    // paths being rendered
+};
+
+#endif // TELEMETRYREPORT_H
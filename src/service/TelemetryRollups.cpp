@@ -0,0 +1,390 @@
+#include "TelemetryRollups.h"
+#include <QDir>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QThreadPool>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QtNumeric>
+#include <QDebug>
+
+namespace {
+
+const quint32 kMagic = 0x53435250;   // "SCRP"
+const quint32 kVersion = 2;
+const qint64 kMinuteMs = 60 * 1000;
+const qint64 kHourMs = 60 * kMinuteMs;
+const qint64 kDayMs = 24 * kHourMs;
+
+qint64 floorTo(qint64 timestampMs, qint64 bucketMs)
+{
+    qint64 q = timestampMs / bucketMs;
+    if (timestampMs < 0 && q * bucketMs != timestampMs)
+        --q;
+    return q * bucketMs;
+}
+
+} // namespace
+
+TelemetryRollups::TelemetryRollups()
+    : m_path(QDir(TelemetryStore::defaultDirectory()).filePath("rollups.dat")),
+    m_lastMs(0),
+    m_lastSavedHour(0),
+    m_version(0),
+    m_catchingUp(false)
+{
+    load();
+}
+
+TelemetryRollups::~TelemetryRollups()
+{
+}
+
+TelemetryRollups& TelemetryRollups::instance()
+{
+    static TelemetryRollups rollups;
+    return rollups;
+}
+
+qint64 TelemetryRollups::bucketMs(Level level)
+{
+    switch (level) {
+    case Minute: return kMinuteMs;
+    case Hour:   return kHourMs;
+    case Day:    return kDayMs;
+    default:     return kDayMs;
+    }
+}
+
+qint64 TelemetryRollups::retentionMs(Level level)
+{
+    switch (level) {
+    case Minute: return 7 * kDayMs;
+    case Hour:   return 400 * kDayMs;
+    default:     return 0;   // unlimited
+    }
+}
+
+quint64 TelemetryRollups::version() const
+{
+    QReadLocker locker(&m_lock);
+    return m_version;
+}
+
+qint64 TelemetryRollups::coveredUntilMs() const
+{
+    QReadLocker locker(&m_lock);
+    return m_lastMs;
+}
+
+void TelemetryRollups::addSample(quint32 key, qint64 timestampMs, float value)
+{
+    if (qIsNaN(value))
+        return;
+    for (int level = 0; level < LevelCount; ++level) {
+        const qint64 start = floorTo(timestampMs, bucketMs(Level(level)));
+        m_levels[level][key][start].add(value);
+    }
+}
+
+void TelemetryRollups::addFrame(const TelemetryFrame& frame)
+{
+    for (int c = 0; c < int(TelemetryChannel::ChannelCount); ++c) {
+        const TelemetryChannel channel = static_cast<TelemetryChannel>(c);
+        const int slots = frame.slotCount(channel);
+        for (int slot = 0; slot < slots; ++slot)
+            addSample(telemetryChannelKey(channel, slot), frame.timestampMs,
+                      static_cast<float>(frame.value(channel, slot)));
+    }
+    m_lastMs = qMax(m_lastMs, frame.timestampMs);
+}
+
+void TelemetryRollups::add(const TelemetryFrame& frame)
+{
+    if (frame.timestampMs <= 0)
+        return;
+
+    bool saveNow = false;
+    {
+        QWriteLocker locker(&m_lock);
+        if (m_catchingUp) {
+            m_deferred.append(frame);
+            return;
+        }
+
+        addFrame(frame);
+        ++m_version;
+
+        // Trim and persist once per hour boundary
+        const qint64 hour = floorTo(frame.timestampMs, kHourMs);
+        if (hour > m_lastSavedHour) {
+            prune(frame.timestampMs);
+            m_lastSavedHour = hour;
+            saveNow = true;
+        }
+    }
+
+    if (saveNow)
+        QThreadPool::globalInstance()->start([this]() { save(); });
+}
+
+void TelemetryRollups::addBatch(const TelemetryBatch& batch, const QVector<int>& rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    QWriteLocker locker(&m_lock);
+    qint64 firstMs = batch.timestamps.at(rows.first());
+    qint64 lastMs = firstMs;
+    for (int row : rows) {
+        firstMs = qMin(firstMs, batch.timestamps.at(row));
+        lastMs = qMax(lastMs, batch.timestamps.at(row));
+    }
+    for (int k = 0; k < batch.keys.size(); ++k) {
+        const quint32 key = batch.keys.at(k);
+        const QVector<float> &values = batch.columns.at(k);
+        for (int row : rows)
+            addSample(key, batch.timestamps.at(row), values.at(row));
+    }
+
+    // Imported history is usually older than anything seen live, so the
+    // catch-up mark stays where it is; rows past it are marked instead
+    if (lastMs > m_lastMs)
+        markImported(qMax(firstMs, m_lastMs + 1), lastMs + 1);
+    prune(QDateTime::currentMSecsSinceEpoch());
+    ++m_version;
+}
+
+void TelemetryRollups::markImported(qint64 fromMs, qint64 toMs)
+{
+    // Merged with every range it touches
+    auto it = m_imported.upperBound(fromMs);
+    if (it != m_imported.begin()) {
+        auto previous = it;
+        --previous;
+        if (previous.value() >= fromMs) {
+            fromMs = previous.key();
+            toMs = qMax(toMs, previous.value());
+            it = m_imported.erase(previous);
+        }
+    }
+    while (it != m_imported.end() && it.key() <= toMs) {
+        toMs = qMax(toMs, it.value());
+        it = m_imported.erase(it);
+    }
+    m_imported.insert(fromMs, toMs);
+}
+
+bool TelemetryRollups::isImported(qint64 timestampMs) const
+{
+    auto it = m_imported.upperBound(timestampMs);
+    if (it == m_imported.constBegin())
+        return false;
+    --it;
+    return timestampMs < it.value();
+}
+
+void TelemetryRollups::prune(qint64 nowMs)
+{
+    // Catch-up starts past m_lastMs; marks below it are moot
+    while (!m_imported.isEmpty() && m_imported.first() <= m_lastMs + 1)
+        m_imported.erase(m_imported.begin());
+
+    for (int level = 0; level < LevelCount; ++level) {
+        const qint64 retention = retentionMs(Level(level));
+        if (retention <= 0)
+            continue;
+
+        const qint64 oldest = nowMs - retention;
+        for (auto it = m_levels[level].begin(); it != m_levels[level].end(); ++it) {
+            Series &series = it.value();
+            while (!series.isEmpty() && series.firstKey() < oldest)
+                series.erase(series.begin());
+        }
+    }
+}
+
+TelemetryRollups::Level TelemetryRollups::levelFor(qint64 fromMs, qint64 resolutionMs) const
+{
+    // Coarsest level no coarser than the resolution, then finer levels
+    // are skipped if their retention no longer reaches back to fromMs
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    int level = Minute;
+    for (int l = LevelCount - 1; l >= 0; --l) {
+        if (bucketMs(Level(l)) <= resolutionMs) {
+            level = l;
+            break;
+        }
+    }
+    while (level < LevelCount - 1 && retentionMs(Level(level)) > 0
+           && fromMs < now - retentionMs(Level(level)))
+        ++level;
+    return Level(level);
+}
+
+QVector<RollupBucket> TelemetryRollups::query(TelemetryChannel channel, int slot,
+                                              qint64 fromMs, qint64 toMs, qint64 resolutionMs) const
+{
+    QVector<RollupBucket> result;
+    const Level level = levelFor(fromMs, resolutionMs);
+    const qint64 step = qMax(resolutionMs, bucketMs(level));
+
+    QReadLocker locker(&m_lock);
+    auto seriesIt = m_levels[level].constFind(telemetryChannelKey(channel, slot));
+    if (seriesIt == m_levels[level].constEnd())
+        return result;
+
+    const Series &series = seriesIt.value();
+    // A level bucket straddling fromMs holds earlier samples too, so the
+    // first one taken is the first that starts inside the range
+    for (auto it = series.lowerBound(fromMs);
+         it != series.constEnd() && it.key() < toMs; ++it) {
+        const qint64 start = fromMs + floorTo(it.key() - fromMs, step);
+        if (result.isEmpty() || result.last().startMs != start) {
+            RollupBucket bucket;
+            bucket.startMs = start;
+            result.append(bucket);
+        }
+        result.last().value.merge(it.value());
+    }
+    return result;
+}
+
+void TelemetryRollups::catchUpFromStore()
+{
+    qint64 fromMs;
+    qint64 toMs;
+    {
+        QWriteLocker locker(&m_lock);
+        if (m_catchingUp)
+            return;
+        fromMs = m_lastMs + 1;
+        toMs = TelemetryStore::instance().lastTimestamp() + 1;
+        if (toMs <= fromMs)
+            return;
+        // Everything below toMs is in the store already; add() holds back
+        // frames from here on
+        m_catchingUp = true;
+    }
+
+    // Buckets past a level's retention are pruned again afterwards
+    QThreadPool::globalInstance()->start([this, fromMs, toMs]() {
+        TelemetryStore &store = TelemetryStore::instance();
+        const QList<quint32> keys = store.columnKeys();
+        for (quint32 key : keys) {
+            const TelemetryChannel channel = static_cast<TelemetryChannel>(key >> 16);
+            const int slot = int(key & 0xFFFF);
+            store.scan(channel, slot, fromMs, toMs, [this, key](const TelemetrySpan &span) {
+                QWriteLocker locker(&m_lock);
+                for (int i = 0; i < span.count; ++i) {
+                    // Imported rows were folded in by addBatch() already
+                    if (!isImported(span.timestamps[i]))
+                        addSample(key, span.timestamps[i], span.values[i]);
+                }
+            });
+        }
+
+        {
+            QWriteLocker locker(&m_lock);
+            m_lastMs = qMax(m_lastMs, toMs - 1);
+
+            // Held-back frames the scan did not already cover, in order
+            for (const TelemetryFrame &frame : m_deferred) {
+                if (frame.timestampMs >= toMs)
+                    addFrame(frame);
+            }
+            m_deferred.clear();
+            m_deferred.squeeze();
+            m_catchingUp = false;
+
+            m_lastSavedHour = floorTo(m_lastMs, kHourMs);
+            prune(QDateTime::currentMSecsSinceEpoch());
+            ++m_version;
+        }
+        save();
+    });
+}
+
+bool TelemetryRollups::save() const
+{
+    QMutexLocker saving(&m_saveMutex);
+
+    // Implicitly shared copies; add() detaches whatever it touches next
+    QHash<quint32, Series> levels[LevelCount];
+    qint64 lastMs;
+    QMap<qint64, qint64> imported;
+    {
+        QReadLocker locker(&m_lock);
+        for (int level = 0; level < LevelCount; ++level)
+            levels[level] = m_levels[level];
+        lastMs = m_lastMs;
+        imported = m_imported;
+    }
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out << kMagic << kVersion << lastMs << imported;
+    for (int level = 0; level < LevelCount; ++level) {
+        out << qint32(levels[level].size());
+        for (auto it = levels[level].constBegin(); it != levels[level].constEnd(); ++it) {
+            out << it.key() << qint32(it.value().size());
+            for (auto b = it.value().constBegin(); b != it.value().constEnd(); ++b)
+                out << b.key() << b.value().count << b.value().sum << b.value().min << b.value().max;
+        }
+    }
+    return file.commit();
+}
+
+bool TelemetryRollups::load()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion)
+        return false;
+
+    qint64 lastMs = 0;
+    QMap<qint64, qint64> imported;
+    in >> lastMs >> imported;
+
+    QHash<quint32, Series> levels[LevelCount];
+    for (int level = 0; level < LevelCount && in.status() == QDataStream::Ok; ++level) {
+        qint32 keyCount = 0;
+        in >> keyCount;
+        for (qint32 k = 0; k < keyCount && in.status() == QDataStream::Ok; ++k) {
+            quint32 key = 0;
+            qint32 bucketCount = 0;
+            in >> key >> bucketCount;
+            Series &series = levels[level][key];
+            for (qint32 b = 0; b < bucketCount && in.status() == QDataStream::Ok; ++b) {
+                qint64 start = 0;
+                TelemetryAggregate value;
+                in >> start >> value.count >> value.sum >> value.min >> value.max;
+                series.insert(start, value);
+            }
+        }
+    }
+
+    // A truncated file is rebuilt from the store instead
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    for (int level = 0; level < LevelCount; ++level)
+        m_levels[level].swap(levels[level]);
+    m_lastMs = lastMs;
+    m_imported.swap(imported);
+    m_lastSavedHour = floorTo(lastMs, kHourMs);
+    return true;
+}
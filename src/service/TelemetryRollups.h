@@ -0,0 +1,100 @@
+#ifndef TELEMETRYROLLUPS_H
+#define TELEMETRYROLLUPS_H
+
+#include <QHash>
+#include <QMap>
+#include <QVector>
+#include <QReadWriteLock>
+#include <QMutex>
+#include "TelemetryFrame.h"
+#include "TelemetryStore.h"
+
+struct RollupBucket
+{
+    qint64 startMs = 0;
+    TelemetryAggregate value;
+};
+
+// ------------------- Rollup pyramid -------------------
+// Count/sum/min/max per (channel, slot) at 1 minute, 1 hour and 1 day,
+// updated as each frame arrives. A query is answered from the coarsest
+// level that is still fine enough for the requested resolution, so charts
+// and the heat map never touch raw samples on redraw.
+//
+// Minute buckets are kept for a week and hour buckets for a bit over a
+// year; day buckets are kept for as long as the history itself. The
+// pyramid is saved next to the history and topped up from the store on
+// start-up for whatever it has not seen yet.
+class TelemetryRollups
+{
+public:
+    enum Level {
+        Minute = 0,
+        Hour,
+        Day,
+        LevelCount
+    };
+
+    static TelemetryRollups& instance();
+
+    void add(const TelemetryFrame& frame);
+
+    // Folds in the given rows of a bulk-loaded batch (see
+    // TelemetryStore::appendBatch). Their span is remembered so a later
+    // catchUpFromStore() does not fold them again.
+    void addBatch(const TelemetryBatch& batch, const QVector<int>& rows);
+
+    // Buckets of resolutionMs (rounded up to a level) in [fromMs, toMs)
+    QVector<RollupBucket> query(TelemetryChannel channel, int slot,
+                                qint64 fromMs, qint64 toMs, qint64 resolutionMs) const;
+
+    // Level query() would use for this range and resolution
+    Level levelFor(qint64 fromMs, qint64 resolutionMs) const;
+
+    static qint64 bucketMs(Level level);
+    static qint64 retentionMs(Level level);
+
+    // Bumped whenever a bucket changes, for cache invalidation
+    quint64 version() const;
+
+    // Newest frame folded in; raw history up to here may be dropped
+    qint64 coveredUntilMs() const;
+
+    // Replays store rows newer than what the pyramid has seen, on the
+    // global thread pool. Frames passed to add() meanwhile are held back
+    // and folded in after it, so none is counted twice or out of order.
+    void catchUpFromStore();
+
+    // Writes a snapshot, so add() is only blocked while it is taken. Also
+    // run on the thread pool on every hour boundary; the application saves
+    // on quit.
+    bool save() const;
+
+private:
+    TelemetryRollups();
+    ~TelemetryRollups();
+    Q_DISABLE_COPY(TelemetryRollups)
+
+    typedef QMap<qint64, TelemetryAggregate> Series;
+
+    void addSample(quint32 key, qint64 timestampMs, float value);
+    void addFrame(const TelemetryFrame& frame);
+    void markImported(qint64 fromMs, qint64 toMs);
+    bool isImported(qint64 timestampMs) const;
+    void prune(qint64 nowMs);
+    bool load();
+
+    mutable QReadWriteLock m_lock;
+    mutable QMutex m_saveMutex;     // one save() at a time
+    QString m_path;
+    QHash<quint32, Series> m_levels[LevelCount];
+    qint64 m_lastMs;            // newest frame folded in
+    QMap<qint64, qint64> m_imported;    // [from, to) folded by addBatch() past m_lastMs
+    qint64 m_lastSavedHour;
+    quint64 m_version;
+
+    bool m_catchingUp;
+    QVector<TelemetryFrame> m_deferred;     // live frames held back meanwhile
+};
+
+#endif // TELEMETRYROLLUPS_H
@@ -0,0 +1,190 @@
+#ifndef TELEMETRYSTORE_H
+#define TELEMETRYSTORE_H
+
+#include <QFile>
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QReadWriteLock>
+#include <QMutex>
+#include <functional>
+#include "TelemetryFrame.h"
+
+// Rows of one column inside one segment. Pointers stay valid for the
+// duration of the scan callback only.
+struct TelemetrySpan
+{
+    const qint64* timestamps = nullptr;
+    const float* values = nullptr;      // NaN where the channel was absent
+    int count = 0;
+};
+
+// Count, sum and extremes of the non-NaN samples in a range
+struct TelemetryAggregate
+{
+    qint64 count = 0;
+    double sum = 0.0;
+    float min = 0.0f;
+    float max = 0.0f;
+
+    double mean() const { return count > 0 ? sum / count : 0.0; }
+    void add(float value);
+    void merge(const TelemetryAggregate& other);
+};
+
+// Rows for bulk loading in columnar form: timestamps ascending and
+// distinct, one value column per key
+struct TelemetryBatch
+{
+    QVector<qint64> timestamps;
+    QVector<quint32> keys;
+    QVector<QVector<float>> columns;    // NaN where a value is missing
+};
+
+// ------------------- Store -------------------
+// Embedded append-only history of every TelemetryFrame. Frames go into
+// memory-mapped segment files, one per UTC day (or per kSegmentRows rows),
+// each holding a timestamp column and one float column per (channel, slot).
+// A range scan binary-searches the segments and the timestamp column and
+// hands out pointers into the mappings, so nothing is copied or parsed.
+//
+// Segments of past days are archived in the background (TelemetryCompactor):
+// rewritten as Gorilla-compressed blocks of kBlockRows rows with per-block
+// min/max/sum, so aggregates over whole blocks are answered from the block
+// headers without decoding.
+//
+// Frames arriving out of order (gap recovery) open a second head segment
+// instead of rewriting the live one; segments may therefore overlap in
+// time, and scans visit them in order of their first timestamp.
+class TelemetryStore
+{
+public:
+    static TelemetryStore& instance();
+
+    bool open(const QString& directory);
+    void close();
+    bool isOpen() const;
+    QString directory() const;
+
+    // False for frames without a timestamp or repeating the last one
+    bool append(const TelemetryFrame& frame);
+
+    // Bulk load, taking the lock a few thousand rows at a time. Rows whose
+    // timestamp is already in the history are skipped (for archived days: any row inside the archive's
+    // span). Returns the number written; their batch indices go to written.
+    int appendBatch(const TelemetryBatch& batch, QVector<int>* written = nullptr);
+
+    // Calls visitor once per contiguous run of rows in [fromMs, toMs): a raw
+    // segment, or a decoded block of an archived one
+    void scan(TelemetryChannel channel, int slot, qint64 fromMs, qint64 toMs,
+              const std::function<void(const TelemetrySpan&)>& visitor) const;
+
+    // Aggregate over [fromMs, toMs); archived blocks fully inside the range
+    // are taken from their headers
+    TelemetryAggregate aggregate(TelemetryChannel channel, int slot, qint64 fromMs, qint64 toMs) const;
+
+    // Copying convenience over scan(), appending rows in timestamp order
+    // even where segments overlap
+    int read(TelemetryChannel channel, int slot, qint64 fromMs, qint64 toMs,
+             QVector<qint64>* timestamps, QVector<float>* values) const;
+
+    // Every (channel, slot) key with a column in at least one segment
+    QList<quint32> columnKeys() const;
+
+    qint64 firstTimestamp() const;
+    qint64 lastTimestamp() const;
+    qint64 rowCount() const;
+    int segmentCount() const;
+
+    // Monotonic counter bumped on every append, for cache invalidation
+    quint64 version() const;
+
+    static QString defaultDirectory();
+
+    // Compression results for segments archived since open()
+    struct ArchiveStats {
+        int segments = 0;
+        qint64 rows = 0;
+        qint64 rawBytes = 0;
+        qint64 archivedBytes = 0;
+        qint64 decodedValues = 0;
+        qint64 decodeNs = 0;
+        double ratio() const { return archivedBytes > 0 ? double(rawBytes) / archivedBytes : 0.0; }
+        double decodeMValuesPerSecond() const { return decodeNs > 0 ? decodedValues * 1000.0 / decodeNs : 0.0; }
+    };
+    ArchiveStats archiveStats() const;
+
+    // ------- Maintenance (see TelemetryCompactor) -------
+    // Segments of past UTC days that are no longer heads are sealed. The
+    // passes below work on those only, build their output outside the
+    // store lock and take the write lock just to swap files in and out, so
+    // appends and scans carry on meanwhile. Passes run one at a time.
+    //
+    // pace is called after each file with the bytes it read and wrote;
+    // returning false ends the pass early, leaving the store consistent.
+    typedef std::function<bool(qint64)> Pace;
+
+    // Archives every sealed raw segment
+    int archiveSealedSegments(const Pace& pace = Pace());
+
+    // Rewrites the sealed segments of each day that has more than one (or
+    // any raw one) as a single archive; overlapping rows keep the newest
+    // segment's values. Returns the number of days rewritten.
+    int mergeSealedDays(const Pace& pace = Pace());
+
+    // Deletes sealed segments whose last row is before beforeMs
+    int dropSealedBefore(qint64 beforeMs);
+
+    // Deletes the oldest sealed segments, none ending after notAfterMs,
+    // until the history takes at most maxBytes on disk
+    int trimToSize(qint64 maxBytes, qint64 notAfterMs);
+
+    // Size of every segment file
+    qint64 diskBytes() const;
+
+    static const int kSegmentRows = 86400;
+    static const int kMaxColumns = 1000;
+    static const int kBlockRows = 1024;
+
+private:
+    TelemetryStore();
+    ~TelemetryStore();
+    Q_DISABLE_COPY(TelemetryStore)
+
+    struct Header;
+    struct Segment;
+    struct ArchiveHeader;
+    struct TimeBlock;
+    struct ValueBlock;
+
+    Segment* openSegment(const QString& path);
+    Segment* createSegment(qint64 firstMs);
+    Segment* headFor(qint64 timestampMs);
+    bool reserveRow(Segment* segment, bool* remapped);
+    int columnIndex(Segment* segment, quint32 key, bool create);
+    bool hasTimestamp(qint64 timestampMs) const;
+    bool mapSegment(Segment* segment, qint64 size);
+    void closeSegment(Segment* segment);
+    Segment* openArchive(const QString& path);
+    QString newSegmentPath(qint64 firstMs, const QString& suffix) const;
+
+    struct ArchiveSource;
+    Segment* writeArchive(const QString& path, const ArchiveSource& source, ArchiveStats* stats);
+    bool decodeTimestamps(const Segment* segment, qint64* out) const;
+    bool decodeColumn(const Segment* segment, int column, float* out) const;
+    QList<Segment*> sealedSegments() const;
+    void replaceSegments(const QList<Segment*>& old, Segment* replacement, const ArchiveStats& stats);
+    void scanArchive(const Segment* segment, int column, qint64 fromMs, qint64 toMs,
+                     const std::function<void(const TelemetrySpan&)>& visitor,
+                     TelemetryAggregate* wholeBlocks) const;
+
+    mutable QReadWriteLock m_lock;
+    QString m_directory;
+    QList<Segment*> m_segments;     // by first timestamp
+    QList<Segment*> m_heads;        // segments still accepting rows
+    QMutex m_maintenance;           // one maintenance pass at a time; held by close()
+    quint64 m_version;
+    ArchiveStats m_archiveStats;
+};
+
+#endif // TELEMETRYSTORE_H
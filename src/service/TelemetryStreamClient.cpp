@@ -0,0 +1,175 @@
+#include "TelemetryStreamClient.h"
+#include "MqttPacket.h"
+#include <QUuid>
+#include <QDebug>
+
+namespace {
+const quint16 kDefaultKeepAliveSecs = 30;
+const quint16 kSubscribePacketId = 1;
+const int kMinReconnectDelayMs = 1000;
+const int kMaxReconnectDelayMs = 30000;
+}
+
+TelemetryStreamClient::TelemetryStreamClient(QObject *parent)
+    : QObject(parent),
+    m_socket(new QSslSocket(this)),
+    m_keepAliveTimer(new QTimer(this)),
+    m_reconnectTimer(new QTimer(this)),
+    m_port(0),
+    m_keepAliveSecs(kDefaultKeepAliveSecs),
+    m_subscribed(false),
+    m_wanted(false),
+    m_reconnectDelayMs(kMinReconnectDelayMs)
+{
+    // Small frames must leave immediately, not wait for Nagle coalescing
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    connect(m_socket, &QSslSocket::connected, this, &TelemetryStreamClient::onSocketConnected);
+    connect(m_socket, &QSslSocket::encrypted, this, &TelemetryStreamClient::onSocketConnected);
+    connect(m_socket, &QSslSocket::disconnected, this, &TelemetryStreamClient::onSocketDisconnected);
+    connect(m_socket, &QSslSocket::readyRead, this, &TelemetryStreamClient::onReadyRead);
+    connect(m_socket, &QAbstractSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        qWarning() << "Telemetry stream error:" << m_socket->errorString();
+        if (m_socket->state() == QAbstractSocket::UnconnectedState)
+            onSocketDisconnected();
+    });
+
+    connect(m_keepAliveTimer, &QTimer::timeout, this, &TelemetryStreamClient::onKeepAlive);
+
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &TelemetryStreamClient::reconnect);
+}
+
+void TelemetryStreamClient::connectToBroker(const QString& host, quint16 port, const QString& topic)
+{
+    // Drop any current connection first, so its disconnected() does not
+    // arm the reconnect timer on top of the reconnect below
+    m_wanted = false;
+    m_reconnectTimer->stop();
+    m_socket->abort();
+
+    m_host = host;
+    m_port = port;
+    m_topic = topic;
+    m_wanted = true;
+    m_reconnectDelayMs = kMinReconnectDelayMs;
+    reconnect();
+}
+
+void TelemetryStreamClient::disconnectFromBroker()
+{
+    m_wanted = false;
+    m_reconnectTimer->stop();
+    m_keepAliveTimer->stop();
+
+    if (m_socket->state() == QAbstractSocket::ConnectedState)
+        m_socket->write(Mqtt::disconnectPacket());
+    m_socket->disconnectFromHost();
+}
+
+void TelemetryStreamClient::reconnect()
+{
+    if (!m_wanted || m_host.isEmpty())
+        return;
+
+    m_buffer.clear();
+    if (m_port == 8883)
+        m_socket->connectToHostEncrypted(m_host, m_port);
+    else
+        m_socket->connectToHost(m_host, m_port);
+}
+
+void TelemetryStreamClient::onSocketConnected()
+{
+    // With TLS, connected() fires before the handshake; wait for encrypted()
+    if (m_port == 8883 && !m_socket->isEncrypted())
+        return;
+
+    QString clientId = QStringLiteral("score-") + QUuid::createUuid().toString(QUuid::Id128).left(12);
+    m_socket->write(Mqtt::connectPacket(clientId, m_keepAliveSecs));
+
+    // Also catches a broker that never answers CONNECT or SUBSCRIBE
+    m_sinceInbound.start();
+    m_keepAliveTimer->start(m_keepAliveSecs * 1000 / 2);
+}
+
+void TelemetryStreamClient::onSocketDisconnected()
+{
+    m_keepAliveTimer->stop();
+
+    bool wasSubscribed = m_subscribed;
+    m_subscribed = false;
+    if (wasSubscribed)
+        emit disconnected();
+
+    if (m_wanted && !m_reconnectTimer->isActive()) {
+        m_reconnectTimer->start(m_reconnectDelayMs);
+        m_reconnectDelayMs = qMin(m_reconnectDelayMs * 2, kMaxReconnectDelayMs);
+    }
+}
+
+void TelemetryStreamClient::onReadyRead()
+{
+    m_buffer.append(m_socket->readAll());
+    m_sinceInbound.start();
+
+    quint8 header = 0;
+    QByteArray body;
+    while (Mqtt::takePacket(m_buffer, &header, &body))
+        handlePacket(header, body);
+}
+
+void TelemetryStreamClient::handlePacket(quint8 header, const QByteArray& body)
+{
+    switch (header & 0xF0) {
+    case Mqtt::ConnAck:
+        if (body.size() >= 2 && body.at(1) == 0) {
+            m_socket->write(Mqtt::subscribePacket(kSubscribePacketId, m_topic));
+        } else {
+            qWarning() << "Telemetry broker refused connection";
+            m_socket->disconnectFromHost();
+        }
+        break;
+
+    case Mqtt::SubAck:
+        // Packet id, then one return code per topic; 0x80 is a refusal
+        if (body.size() < 3 || static_cast<quint8>(body.at(2)) == 0x80) {
+            qWarning() << "Telemetry broker refused subscription to" << m_topic;
+            m_socket->disconnectFromHost();
+            break;
+        }
+        m_subscribed = true;
+        m_reconnectDelayMs = kMinReconnectDelayMs;
+        emit connected();
+        break;
+
+    case Mqtt::Publish: {
+        int offset = 0;
+        Mqtt::readString(body, &offset);        // topic
+        if ((header & 0x06) != 0)
+            offset += 2;                        // packet id for QoS > 0
+        emit frameReceived(body.mid(offset));
+        break;
+    }
+
+    case Mqtt::PingResp:
+    default:
+        break;
+    }
+}
+
+void TelemetryStreamClient::onKeepAlive()
+{
+    // abort() ends in onSocketDisconnected, which schedules a reconnect
+    // and lets HTTPS polling take over meanwhile. Silence for 1.5 intervals
+    // means a half-open link: no PINGRESP, no data
+    if (m_sinceInbound.isValid() && m_sinceInbound.elapsed() > m_keepAliveSecs * 1500) {
+        qWarning() << "Telemetry stream: nothing from broker for" << m_sinceInbound.elapsed() / 1000
+                   << "s, reconnecting";
+        m_socket->abort();
+        return;
+    }
+
+    if (m_subscribed)
+        m_socket->write(Mqtt::pingReqPacket());
+}
@@ -0,0 +1,61 @@
+#ifndef TELEMETRYSTREAMCLIENT_H
+#define TELEMETRYSTREAMCLIENT_H
+
+#include <QObject>
+#include <QSslSocket>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QString>
+
+// Persistent MQTT subscription to the vessel's telemetry topic.
+// Port 8883 is opened with TLS, any other port as plain TCP.
+// Each PUBLISH payload is one VoyageLogs record in the logs-data JSON shape.
+class TelemetryStreamClient : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TelemetryStreamClient(QObject *parent = nullptr);
+
+    void connectToBroker(const QString& host, quint16 port, const QString& topic);
+    void disconnectFromBroker();
+
+    bool isConnected() const { return m_subscribed; }
+
+    // MQTT keep-alive, applied on the next connect; the link counts as
+    // half-open after 1.5 intervals without anything from the broker
+    void setKeepAliveSecs(quint16 seconds) { m_keepAliveSecs = qMax<quint16>(1, seconds); }
+    quint16 keepAliveSecs() const { return m_keepAliveSecs; }
+
+signals:
+    void connected();
+    void disconnected();
+    void frameReceived(const QByteArray& payload);
+
+private slots:
+    void onSocketConnected();
+    void onSocketDisconnected();
+    void onReadyRead();
+    void onKeepAlive();
+    void reconnect();
+
+private:
+    void handlePacket(quint8 header, const QByteArray& body);
+
+    QSslSocket* m_socket;
+    QTimer* m_keepAliveTimer;
+    QTimer* m_reconnectTimer;
+
+    QString m_host;
+    quint16 m_port;
+    QString m_topic;
+    quint16 m_keepAliveSecs;
+    QByteArray m_buffer;
+    QElapsedTimer m_sinceInbound;   // restarted by every packet from the broker
+
+    bool m_subscribed;
+    bool m_wanted;
+    int m_reconnectDelayMs;
+};
+
+#endif // TELEMETRYSTREAMCLIENT_H
@@ -0,0 +1,364 @@
+#include "VoyageLogsCbor.h"
+#include "VoyageLogsDecoder.h"
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+
+namespace {
+
+QString readText(QCborStreamReader& reader)
+{
+    QString text;
+    auto chunk = reader.readString();
+    while (chunk.status == QCborStreamReader::Ok) {
+        text += chunk.data;
+        chunk = reader.readString();
+    }
+    return text;
+}
+
+double readNumber(QCborStreamReader& reader)
+{
+    double value = 0.0;
+    if (reader.isInteger()) {
+        value = static_cast<double>(reader.toInteger());
+        reader.next();
+    } else if (reader.isDouble()) {
+        value = reader.toDouble();
+        reader.next();
+    } else if (reader.isFloat()) {
+        value = reader.toFloat();
+        reader.next();
+    } else if (reader.isFloat16()) {
+        value = reader.toFloat16();
+        reader.next();
+    } else if (reader.isString()) {
+        value = readText(reader).toDouble();
+    } else {
+        reader.next();
+    }
+    return value;
+}
+
+int readInt(QCborStreamReader& reader)
+{
+    return static_cast<int>(readNumber(reader));
+}
+
+// Text fields that some firmware sends as numbers (e.g. air_temperature)
+QString readScalarText(QCborStreamReader& reader)
+{
+    if (reader.isString())
+        return readText(reader);
+    if (reader.isInteger() || reader.isDouble() || reader.isFloat() || reader.isFloat16())
+        return QString::number(readNumber(reader));
+    reader.next();
+    return QString();
+}
+
+template <typename Log>
+void readArray(QCborStreamReader& reader, QList<Log>* out,
+               void (*readField)(QCborStreamReader&, const QString&, Log*))
+{
+    if (!reader.isArray()) {
+        reader.next();
+        return;
+    }
+
+    if (reader.isLengthKnown())
+        out->reserve(out->size() + static_cast<int>(reader.length()));
+
+    reader.enterContainer();
+    while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        if (!reader.isMap()) {
+            reader.next();
+            continue;
+        }
+        Log log = Log();
+        reader.enterContainer();
+        while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+            if (!reader.isString()) {
+                reader.next();
+                reader.next();
+                continue;
+            }
+            const QString key = readText(reader);
+            readField(reader, key, &log);
+        }
+        reader.leaveContainer();
+        out->append(log);
+    }
+    reader.leaveContainer();
+}
+
+void readPropulsionField(QCborStreamReader& r, const QString& key, PropulsionLog* log)
+{
+    if (key == QLatin1String("propulsion_log_id"))          log->propulsion_log_id = readInt(r);
+    else if (key == QLatin1String("log_id"))                log->log_id = readInt(r);
+    else if (key == QLatin1String("engine_id"))             log->engine_id = readScalarText(r);
+    else if (key == QLatin1String("status"))                log->status = readScalarText(r);
+    else if (key == QLatin1String("rpm"))                   log->rpm = readInt(r);
+    else if (key == QLatin1String("engine_load"))           log->engine_load = readInt(r);
+    else if (key == QLatin1String("power_output"))          log->power_output = readNumber(r);
+    else if (key == QLatin1String("fuel_consumption_rate")) log->fuel_consumption_rate = readNumber(r);
+    else if (key == QLatin1String("exhaust_gas_temp"))      log->exhaust_gas_temp = readInt(r);
+    else r.next();
+}
+
+void readElectricalField(QCborStreamReader& r, const QString& key, ElectricalLog* log)
+{
+    if (key == QLatin1String("electrical_log_id"))              log->electrical_log_id = readInt(r);
+    else if (key == QLatin1String("log_id"))                    log->log_id = readInt(r);
+    else if (key == QLatin1String("generator_id"))              log->generator_id = readScalarText(r);
+    else if (key == QLatin1String("status"))                    log->status = readScalarText(r);
+    else if (key == QLatin1String("gen_load"))                  log->gen_load = readInt(r);
+    else if (key == QLatin1String("gen_power_output"))          log->gen_power_output = readNumber(r);
+    else if (key == QLatin1String("gen_fuel_consumption_rate")) log->gen_fuel_consumption_rate = readNumber(r);
+    else r.next();
+}
+
+void readFuelTankField(QCborStreamReader& r, const QString& key, FuelTankLog* log)
+{
+    if (key == QLatin1String("fuel_tank_log_id")) log->fuel_tank_log_id = readInt(r);
+    else if (key == QLatin1String("log_id"))      log->log_id = readInt(r);
+    else if (key == QLatin1String("tank_id"))     log->tank_id = readScalarText(r);
+    else if (key == QLatin1String("fuel_type"))   log->fuel_type = readScalarText(r);
+    else if (key == QLatin1String("fuel_level"))  log->fuel_level = readNumber(r);
+    else if (key == QLatin1String("fuel_volume")) log->fuel_volume = readNumber(r);
+    else r.next();
+}
+
+void readBallastTankField(QCborStreamReader& r, const QString& key, BallastTankLog* log)
+{
+    if (key == QLatin1String("ballast_tank_log_id"))         log->ballast_tank_log_id = readInt(r);
+    else if (key == QLatin1String("log_id"))                 log->log_id = readInt(r);
+    else if (key == QLatin1String("tank_id"))                log->tank_id = readScalarText(r);
+    else if (key == QLatin1String("tank_level"))             log->tank_level = readNumber(r);
+    else if (key == QLatin1String("pump_status"))            log->pump_status = readScalarText(r);
+    else if (key == QLatin1String("pump_power_consumption")) log->pump_power_consumption = readNumber(r);
+    else r.next();
+}
+
+// Reads one key/value of a VoyageLogs map and records which subsystem it belongs to
+void readRecordField(QCborStreamReader& r, const QString& key, VoyageLogs* logs,
+                     MockApiService::Subsystems* present)
+{
+    if (key == QLatin1String("log_id"))                  logs->log_id = readInt(r);
+    else if (key == QLatin1String("voyage_id"))          logs->voyage_id = readScalarText(r);
+    else if (key == QLatin1String("timestamp"))          logs->timestamp = readScalarText(r);
+    else if (key == QLatin1String("latitude"))         { logs->latitude = readNumber(r); *present |= MockApiService::Navigation; }
+    else if (key == QLatin1String("longitude"))          logs->longitude = readNumber(r);
+    else if (key == QLatin1String("ship_speed"))       { logs->ship_speed = readNumber(r); *present |= MockApiService::Navigation; }
+    else if (key == QLatin1String("course"))             logs->course = readInt(r);
+    else if (key == QLatin1String("wind_speed"))       { logs->wind_speed = readNumber(r); *present |= MockApiService::Weather; }
+    else if (key == QLatin1String("sea_state"))        { logs->sea_state = readNumber(r); *present |= MockApiService::Weather; }
+    else if (key == QLatin1String("air_temperature"))  { logs->air_temperature = readScalarText(r); *present |= MockApiService::Weather; }
+    else if (key == QLatin1String("humidity"))           logs->humidity = readScalarText(r);
+    else if (key == QLatin1String("barometric_pressure")) logs->barometric_pressure = readScalarText(r);
+    else if (key == QLatin1String("hvac_power"))       { logs->hvac_power = readNumber(r); *present |= MockApiService::HotelLoad; }
+    else if (key == QLatin1String("galley_power"))       logs->galley_power = readNumber(r);
+    else if (key == QLatin1String("lighting_power"))     logs->lighting_power = readNumber(r);
+    else if (key == QLatin1String("total_hotel_load")) { logs->total_hotel_load = readNumber(r); *present |= MockApiService::HotelLoad; }
+    else if (key == QLatin1String("propulsion_logs")) {
+        readArray(r, &logs->propulsion_logs, readPropulsionField);
+        *present |= MockApiService::Propulsion;
+    } else if (key == QLatin1String("electrical_logs")) {
+        readArray(r, &logs->electrical_logs, readElectricalField);
+        *present |= MockApiService::Electrical;
+    } else if (key == QLatin1String("fuel_tank_logs")) {
+        readArray(r, &logs->fuel_tank_logs, readFuelTankField);
+        *present |= MockApiService::FuelTanks;
+    } else if (key == QLatin1String("ballast_tank_logs")) {
+        readArray(r, &logs->ballast_tank_logs, readBallastTankField);
+        *present |= MockApiService::BallastTanks;
+    } else {
+        r.next();
+    }
+}
+
+// Reads the entries of an already-entered record map
+void readRecordBody(QCborStreamReader& r, VoyageLogs* logs, MockApiService::Subsystems* present)
+{
+    while (r.lastError() == QCborError::NoError && r.hasNext()) {
+        if (!r.isString()) {
+            r.next();
+            r.next();
+            continue;
+        }
+        const QString key = readText(r);
+        readRecordField(r, key, logs, present);
+    }
+}
+
+void readRecord(QCborStreamReader& r, DecodedVoyageLogs* decoded)
+{
+    if (!r.isMap()) {
+        r.next();
+        return;
+    }
+    VoyageLogs logs = VoyageLogs();
+    MockApiService::Subsystems present = MockApiService::NoSubsystem;
+    r.enterContainer();
+    readRecordBody(r, &logs, &present);
+    r.leaveContainer();
+    decoded->records.append(logs);
+    decoded->present.append(present);
+}
+
+} // namespace
+
+bool VoyageLogsCbor::decode(const QByteArray& payload, DecodedVoyageLogs* decoded)
+{
+    QCborStreamReader r(payload);
+    if (!r.isMap())
+        return false;
+
+    r.enterContainer();
+
+    // A bare record (streamed frames) may list its keys in any order, so
+    // every top-level entry other than "data" goes into a candidate record
+    // and the choice between the two is made once the map is done
+    VoyageLogs bare = VoyageLogs();
+    MockApiService::Subsystems barePresent = MockApiService::NoSubsystem;
+    bool hasLogId = false;
+    bool found = false;
+    while (r.lastError() == QCborError::NoError && r.hasNext()) {
+        if (!r.isString()) {
+            r.next();
+            r.next();
+            continue;
+        }
+
+        const QString key = readText(r);
+        if (key == QLatin1String("data")) {
+            if (r.isArray()) {
+                if (r.isLengthKnown()) {
+                    decoded->records.reserve(static_cast<int>(r.length()));
+                    decoded->present.reserve(static_cast<int>(r.length()));
+                }
+                r.enterContainer();
+                while (r.lastError() == QCborError::NoError && r.hasNext())
+                    readRecord(r, decoded);
+                r.leaveContainer();
+                found = true;
+            } else if (r.isMap()) {
+                readRecord(r, decoded);
+                found = true;
+            } else {
+                r.next();
+            }
+        } else if (found) {
+            r.next();
+        } else {
+            hasLogId = hasLogId || key == QLatin1String("log_id");
+            readRecordField(r, key, &bare, &barePresent);
+        }
+    }
+
+    if (r.lastError() == QCborError::NoError)
+        r.leaveContainer();
+
+    if (!found && hasLogId) {
+        decoded->records.append(bare);
+        decoded->present.append(barePresent);
+        found = true;
+    }
+
+    return found && r.lastError() == QCborError::NoError;
+}
+
+void VoyageLogsCbor::encodeRecord(QCborStreamWriter& w, const VoyageLogs& logs)
+{
+    w.startMap();
+    w.append(QLatin1String("log_id"));              w.append(qint64(logs.log_id));
+    w.append(QLatin1String("voyage_id"));           w.append(logs.voyage_id);
+    w.append(QLatin1String("timestamp"));           w.append(logs.timestamp);
+    w.append(QLatin1String("latitude"));            w.append(logs.latitude);
+    w.append(QLatin1String("longitude"));           w.append(logs.longitude);
+    w.append(QLatin1String("ship_speed"));          w.append(logs.ship_speed);
+    w.append(QLatin1String("course"));              w.append(qint64(logs.course));
+    w.append(QLatin1String("wind_speed"));          w.append(logs.wind_speed);
+    w.append(QLatin1String("sea_state"));           w.append(logs.sea_state);
+    w.append(QLatin1String("air_temperature"));     w.append(logs.air_temperature);
+    w.append(QLatin1String("humidity"));            w.append(logs.humidity);
+    w.append(QLatin1String("barometric_pressure")); w.append(logs.barometric_pressure);
+    w.append(QLatin1String("hvac_power"));          w.append(logs.hvac_power);
+    w.append(QLatin1String("galley_power"));        w.append(logs.galley_power);
+    w.append(QLatin1String("lighting_power"));      w.append(logs.lighting_power);
+    w.append(QLatin1String("total_hotel_load"));    w.append(logs.total_hotel_load);
+
+    w.append(QLatin1String("propulsion_logs"));
+    w.startArray(logs.propulsion_logs.size());
+    for (const PropulsionLog &p : logs.propulsion_logs) {
+        w.startMap();
+        w.append(QLatin1String("propulsion_log_id"));     w.append(qint64(p.propulsion_log_id));
+        w.append(QLatin1String("log_id"));                w.append(qint64(p.log_id));
+        w.append(QLatin1String("engine_id"));             w.append(p.engine_id);
+        w.append(QLatin1String("status"));                w.append(p.status);
+        w.append(QLatin1String("rpm"));                   w.append(qint64(p.rpm));
+        w.append(QLatin1String("engine_load"));           w.append(qint64(p.engine_load));
+        w.append(QLatin1String("power_output"));          w.append(p.power_output);
+        w.append(QLatin1String("fuel_consumption_rate")); w.append(p.fuel_consumption_rate);
+        w.append(QLatin1String("exhaust_gas_temp"));      w.append(qint64(p.exhaust_gas_temp));
+        w.endMap();
+    }
+    w.endArray();
+
+    w.append(QLatin1String("electrical_logs"));
+    w.startArray(logs.electrical_logs.size());
+    for (const ElectricalLog &e : logs.electrical_logs) {
+        w.startMap();
+        w.append(QLatin1String("electrical_log_id"));         w.append(qint64(e.electrical_log_id));
+        w.append(QLatin1String("log_id"));                    w.append(qint64(e.log_id));
+        w.append(QLatin1String("generator_id"));              w.append(e.generator_id);
+        w.append(QLatin1String("status"));                    w.append(e.status);
+        w.append(QLatin1String("gen_load"));                  w.append(qint64(e.gen_load));
+        w.append(QLatin1String("gen_power_output"));          w.append(e.gen_power_output);
+        w.append(QLatin1String("gen_fuel_consumption_rate")); w.append(e.gen_fuel_consumption_rate);
+        w.endMap();
+    }
+    w.endArray();
+
+    w.append(QLatin1String("fuel_tank_logs"));
+    w.startArray(logs.fuel_tank_logs.size());
+    for (const FuelTankLog &f : logs.fuel_tank_logs) {
+        w.startMap();
+        w.append(QLatin1String("fuel_tank_log_id")); w.append(qint64(f.fuel_tank_log_id));
+        w.append(QLatin1String("log_id"));           w.append(qint64(f.log_id));
+        w.append(QLatin1String("tank_id"));          w.append(f.tank_id);
+        w.append(QLatin1String("fuel_type"));        w.append(f.fuel_type);
+        w.append(QLatin1String("fuel_level"));       w.append(f.fuel_level);
+        w.append(QLatin1String("fuel_volume"));      w.append(f.fuel_volume);
+        w.endMap();
+    }
+    w.endArray();
+
+    w.append(QLatin1String("ballast_tank_logs"));
+    w.startArray(logs.ballast_tank_logs.size());
+    for (const BallastTankLog &b : logs.ballast_tank_logs) {
+        w.startMap();
+        w.append(QLatin1String("ballast_tank_log_id"));    w.append(qint64(b.ballast_tank_log_id));
+        w.append(QLatin1String("log_id"));                 w.append(qint64(b.log_id));
+        w.append(QLatin1String("tank_id"));                w.append(b.tank_id);
+        w.append(QLatin1String("tank_level"));             w.append(b.tank_level);
+        w.append(QLatin1String("pump_status"));            w.append(b.pump_status);
+        w.append(QLatin1String("pump_power_consumption")); w.append(b.pump_power_consumption);
+        w.endMap();
+    }
+    w.endArray();
+
+    w.endMap();
+}
+
+QByteArray VoyageLogsCbor::encode(const QList<VoyageLogs>& records)
+{
+    QByteArray out;
+    QCborStreamWriter w(&out);
+    w.startMap(1);
+    w.append(QLatin1String("data"));
+    w.startArray(records.size());
+    for (const VoyageLogs &logs : records)
+        encodeRecord(w, logs);
+    w.endArray();
+    w.endMap();
+    return out;
+}
@@ -0,0 +1,26 @@
+#ifndef VOYAGELOGSCBOR_H
+#define VOYAGELOGSCBOR_H
+
+#include <QByteArray>
+#include <QList>
+#include "VoyageLogs.h"
+
+class QCborStreamWriter;
+struct DecodedVoyageLogs;
+
+// CBOR (RFC 8949) form of the logs-data payload, using the same keys as the
+// JSON API. Decoding streams straight into VoyageLogs with QCborStreamReader;
+// no QCborValue/QJsonObject tree is built.
+class VoyageLogsCbor
+{
+public:
+    static const char* mimeType() { return "application/cbor"; }
+
+    // Accepts {"data": record}, {"data": [records]} or a bare record
+    static bool decode(const QByteArray& payload, DecodedVoyageLogs* decoded);
+
+    static QByteArray encode(const QList<VoyageLogs>& records);
+    static void encodeRecord(QCborStreamWriter& writer, const VoyageLogs& logs);
+};
+
+#endif // VOYAGELOGSCBOR_H
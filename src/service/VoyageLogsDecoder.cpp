@@ -0,0 +1,197 @@
+#include "VoyageLogsDecoder.h"
+#include "VoyageLogsCbor.h"
+#include "VoyageLogsJsonReader.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+VoyageLogsDecoder::VoyageLogsDecoder(const QByteArray& payload, WireFormat format,
+                                     QObject* receiver, Callback callback)
+    : m_payload(payload),
+    m_format(format),
+    m_receiver(receiver),
+    m_callback(std::move(callback))
+{
+    setAutoDelete(true);
+    m_queued.start();
+}
+
+void VoyageLogsDecoder::run()
+{
+    const qint64 queueDelayNs = m_queued.nsecsElapsed();
+    DecodedVoyageLogs decoded = decode(m_payload, m_format);
+    decoded.queueDelayNs = queueDelayNs;
+    m_payload.clear();
+
+    if (!m_receiver)
+        return;
+
+    // Queued onto the receiver's thread; dropped if the receiver is gone by then
+    Callback callback = m_callback;
+    QMetaObject::invokeMethod(m_receiver.data(), [callback, decoded]() {
+        callback(decoded);
+    }, Qt::QueuedConnection);
+}
+
+DecodedVoyageLogs VoyageLogsDecoder::decode(const QByteArray& payload, WireFormat format)
+{
+    DecodedVoyageLogs decoded;
+    decoded.format = format;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (format == WireFormat::Cbor)
+        decoded.ok = VoyageLogsCbor::decode(payload, &decoded);
+    else
+        decodeJson(payload, &decoded);
+
+    decoded.decodeNs = timer.nsecsElapsed();
+    return decoded;
+}
+
+void VoyageLogsDecoder::decodeJson(const QByteArray& payload, DecodedVoyageLogs* decoded)
+{
+    // Fast path: single pass over the bytes, no intermediate JSON tree
+    VoyageLogsJsonReader reader(payload);
+    if (reader.read(decoded)) {
+        decoded->ok = true;
+        return;
+    }
+
+    // Anything the fast reader rejects goes through QJsonDocument
+    decoded->records.clear();
+    decoded->present.clear();
+
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(payload);
+
+    if (!jsonDoc.isNull() && jsonDoc.isObject()) {
+        QJsonObject root = jsonDoc.object();
+        QJsonValue data = root["data"];
+
+        // A delta reply carries every record newer than the cursor, oldest first.
+        // A full snapshot is a single object; both are merged the same way.
+        if (data.isArray()) {
+            QJsonArray records = data.toArray();
+            decoded->records.reserve(records.size());
+            decoded->present.reserve(records.size());
+            for (const QJsonValue &record : records) {
+                MockApiService::Subsystems present = MockApiService::NoSubsystem;
+                decoded->records.append(parseVoyageLogs(record.toObject(), &present));
+                decoded->present.append(present);
+            }
+            decoded->ok = true;
+        } else if (data.isObject() || root.contains("log_id")) {
+            // Streamed frames carry the record itself without the "data" envelope
+            QJsonObject record = data.isObject() ? data.toObject() : root;
+            MockApiService::Subsystems present = MockApiService::NoSubsystem;
+            decoded->records.append(parseVoyageLogs(record, &present));
+            decoded->present.append(present);
+            decoded->ok = true;
+        }
+    }
+}
+
+VoyageLogs VoyageLogsDecoder::parseVoyageLogs(const QJsonObject& obj, MockApiService::Subsystems* present)
+{
+    VoyageLogs logs;
+    logs.log_id = obj["log_id"].toInt();
+    logs.voyage_id = obj["voyage_id"].toString();
+    logs.timestamp = obj["timestamp"].toString();
+    logs.latitude = obj["latitude"].toDouble();
+    logs.longitude = obj["longitude"].toDouble();
+    logs.ship_speed = obj["ship_speed"].toDouble();
+    logs.course = obj["course"].toInt();
+    logs.wind_speed = obj["wind_speed"].toDouble();
+    logs.sea_state = obj["sea_state"].toDouble();
+    logs.hvac_power = obj["hvac_power"].toDouble();
+    logs.galley_power = obj["galley_power"].toDouble();
+    logs.lighting_power = obj["lighting_power"].toDouble();
+    logs.total_hotel_load = obj["total_hotel_load"].toDouble();
+    logs.air_temperature = obj["air_temperature"].toVariant().toString();
+    logs.humidity = obj["humidity"].toVariant().toString();
+    logs.barometric_pressure = obj["barometric_pressure"].toVariant().toString();
+
+    // Delta records omit subsystems that did not change since the cursor
+    if (present) {
+        MockApiService::Subsystems p = MockApiService::NoSubsystem;
+        if (obj.contains("latitude") || obj.contains("ship_speed"))
+            p |= MockApiService::Navigation;
+        if (obj.contains("wind_speed") || obj.contains("sea_state") || obj.contains("air_temperature"))
+            p |= MockApiService::Weather;
+        if (obj.contains("total_hotel_load") || obj.contains("hvac_power"))
+            p |= MockApiService::HotelLoad;
+        if (obj.contains("propulsion_logs"))
+            p |= MockApiService::Propulsion;
+        if (obj.contains("electrical_logs"))
+            p |= MockApiService::Electrical;
+        if (obj.contains("fuel_tank_logs"))
+            p |= MockApiService::FuelTanks;
+        if (obj.contains("ballast_tank_logs"))
+            p |= MockApiService::BallastTanks;
+        *present = p;
+    }
+
+    // Propulsion Logs
+    QJsonArray propulsionArr = obj["propulsion_logs"].toArray();
+    for (auto v : propulsionArr) {
+        QJsonObject p = v.toObject();
+        PropulsionLog log;
+        log.propulsion_log_id = p["propulsion_log_id"].toInt();
+        log.log_id = p["log_id"].toInt();
+        log.engine_id = p["engine_id"].toString();
+        log.status = p["status"].toString();
+        log.rpm = p["rpm"].toInt();
+        log.engine_load = p["engine_load"].toInt();
+        log.power_output = p["power_output"].toDouble();
+        log.fuel_consumption_rate = p["fuel_consumption_rate"].toDouble();
+        log.exhaust_gas_temp = p["exhaust_gas_temp"].toInt();
+        logs.propulsion_logs.append(log);
+    }
+
+    // Electrical Logs
+    QJsonArray electricalArr = obj["electrical_logs"].toArray();
+    for (auto v : electricalArr) {
+        QJsonObject e = v.toObject();
+        ElectricalLog log;
+        log.electrical_log_id = e["electrical_log_id"].toInt();
+        log.log_id = e["log_id"].toInt();
+        log.generator_id = e["generator_id"].toString();
+        log.status = e["status"].toString();
+        log.gen_load = e["gen_load"].toInt();
+        log.gen_power_output = e["gen_power_output"].toDouble();
+        log.gen_fuel_consumption_rate = e["gen_fuel_consumption_rate"].toDouble();
+        logs.electrical_logs.append(log);
+    }
+
+    // Fuel Tank Logs
+    QJsonArray fuelArr = obj["fuel_tank_logs"].toArray();
+    for (auto v : fuelArr) {
+        QJsonObject f = v.toObject();
+        FuelTankLog log;
+        log.fuel_tank_log_id = f["fuel_tank_log_id"].toInt();
+        log.log_id = f["log_id"].toInt();
+        log.tank_id = f["tank_id"].toString();
+        log.fuel_type = f["fuel_type"].toString();
+        log.fuel_level = f["fuel_level"].toDouble();
+        log.fuel_volume = f["fuel_volume"].toDouble();
+        logs.fuel_tank_logs.append(log);
+    }
+
+    // Ballast Tank Logs
+    QJsonArray ballastArr = obj["ballast_tank_logs"].toArray();
+    for (auto v : ballastArr) {
+        QJsonObject b = v.toObject();
+        BallastTankLog log;
+        log.ballast_tank_log_id = b["ballast_tank_log_id"].toInt();
+        log.log_id = b["log_id"].toInt();
+        log.tank_id = b["tank_id"].toString();
+        log.tank_level = b["tank_level"].toDouble();
+        log.pump_status = b["pump_status"].toString();
+        log.pump_power_consumption = b["pump_power_consumption"].toDouble();
+        logs.ballast_tank_logs.append(log);
+    }
+
+    return logs;
+}
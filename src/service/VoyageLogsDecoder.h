@@ -0,0 +1,54 @@
+#ifndef VOYAGELOGSDECODER_H
+#define VOYAGELOGSDECODER_H
+
+#include <QRunnable>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QJsonObject>
+#include <functional>
+#include "MockApiService.h"
+
+// Encodings the logs-data endpoint can answer with (negotiated via Accept)
+enum class WireFormat {
+    Json,
+    Cbor
+};
+
+// Result of decoding one logs-data reply body
+struct DecodedVoyageLogs {
+    bool ok = false;
+    WireFormat format = WireFormat::Json;
+    QList<VoyageLogs> records;                      // oldest first
+    QList<MockApiService::Subsystems> present;      // fields present in each record
+    qint64 decodeNs = 0;                            // time spent decoding on the worker
+    qint64 queueDelayNs = 0;                        // wait in the pool before decoding
+};
+
+// Decodes a logs-data reply on a pool thread and hands the result back to
+// the receiver's thread through a queued call.
+class VoyageLogsDecoder : public QRunnable
+{
+public:
+    using Callback = std::function<void(const DecodedVoyageLogs&)>;
+
+    VoyageLogsDecoder(const QByteArray& payload, WireFormat format,
+                      QObject* receiver, Callback callback);
+
+    void run() override;
+
+    static DecodedVoyageLogs decode(const QByteArray& payload, WireFormat format = WireFormat::Json);
+    static VoyageLogs parseVoyageLogs(const QJsonObject& obj,
+                                      MockApiService::Subsystems* present = nullptr);
+
+private:
+    static void decodeJson(const QByteArray& payload, DecodedVoyageLogs* decoded);
+
+    QByteArray m_payload;
+    WireFormat m_format;
+    QElapsedTimer m_queued;
+    QPointer<QObject> m_receiver;
+    Callback m_callback;
+};
+
+#endif // VOYAGELOGSDECODER_H
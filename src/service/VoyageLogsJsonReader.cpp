@@ -0,0 +1,658 @@
+#include "VoyageLogsJsonReader.h"
+#include "VoyageLogsDecoder.h"
+#include <cstring>
+
+namespace {
+
+// Powers of ten exactly representable as double (Clinger's fast path)
+const double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void appendUtf8(QByteArray& out, uint codePoint)
+{
+    if (codePoint < 0x80) {
+        out.append(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.append(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.append(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.append(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+} // namespace
+
+VoyageLogsJsonReader::VoyageLogsJsonReader(const QByteArray& payload)
+    : m_pos(payload.constData()),
+    m_end(payload.constData() + payload.size())
+{
+}
+
+template <int N>
+bool VoyageLogsJsonReader::keyIs(const char* key, int length, const char (&literal)[N])
+{
+    return length == N - 1 && std::memcmp(key, literal, N - 1) == 0;
+}
+
+// ------------------- Tokens -------------------
+
+void VoyageLogsJsonReader::skipWhitespace()
+{
+    while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+        ++m_pos;
+}
+
+bool VoyageLogsJsonReader::peek(char c)
+{
+    skipWhitespace();
+    return m_pos < m_end && *m_pos == c;
+}
+
+bool VoyageLogsJsonReader::consume(char c)
+{
+    if (!peek(c))
+        return false;
+    ++m_pos;
+    return true;
+}
+
+bool VoyageLogsJsonReader::readKey(const char** key, int* length)
+{
+    if (!consume('"'))
+        return false;
+
+    const char *start = m_pos;
+    while (m_pos < m_end && *m_pos != '"') {
+        if (*m_pos == '\\')
+            ++m_pos;
+        ++m_pos;
+    }
+    if (m_pos >= m_end)
+        return false;
+
+    *key = start;
+    *length = static_cast<int>(m_pos - start);
+    ++m_pos;
+    return consume(':');
+}
+
+bool VoyageLogsJsonReader::skipString()
+{
+    if (!consume('"'))
+        return false;
+    while (m_pos < m_end && *m_pos != '"') {
+        if (*m_pos == '\\')
+            ++m_pos;
+        ++m_pos;
+    }
+    if (m_pos >= m_end)
+        return false;
+    ++m_pos;
+    return true;
+}
+
+bool VoyageLogsJsonReader::readString(QString* out)
+{
+    if (peek('n')) {
+        if (m_end - m_pos < 4 || std::memcmp(m_pos, "null", 4) != 0)
+            return false;
+        m_pos += 4;
+        out->clear();
+        return true;
+    }
+    if (!consume('"'))
+        return false;
+
+    const char *start = m_pos;
+    bool escaped = false;
+    while (m_pos < m_end && *m_pos != '"') {
+        if (*m_pos == '\\') {
+            escaped = true;
+            ++m_pos;
+        }
+        ++m_pos;
+    }
+    if (m_pos >= m_end)
+        return false;
+
+    const char *stop = m_pos;
+    ++m_pos;
+
+    if (!escaped) {
+        *out = QString::fromUtf8(start, static_cast<int>(stop - start));
+        return true;
+    }
+
+    // Rare path: unescape into a scratch buffer
+    QByteArray raw;
+    raw.reserve(static_cast<int>(stop - start));
+    for (const char *c = start; c < stop; ++c) {
+        if (*c != '\\') {
+            raw.append(*c);
+            continue;
+        }
+        ++c;
+        switch (*c) {
+        case 'n': raw.append('\n'); break;
+        case 't': raw.append('\t'); break;
+        case 'r': raw.append('\r'); break;
+        case 'b': raw.append('\b'); break;
+        case 'f': raw.append('\f'); break;
+        case 'u': {
+            if (stop - c < 5)
+                return false;
+            uint codePoint = 0;
+            for (int i = 1; i <= 4; ++i) {
+                int h = hexValue(c[i]);
+                if (h < 0)
+                    return false;
+                codePoint = (codePoint << 4) | static_cast<uint>(h);
+            }
+            c += 4;
+            // Surrogate pair
+            if (codePoint >= 0xD800 && codePoint < 0xDC00 && stop - c >= 7
+                && c[1] == '\\' && c[2] == 'u') {
+                uint low = 0;
+                bool ok = true;
+                for (int i = 3; i <= 6; ++i) {
+                    int h = hexValue(c[i]);
+                    ok = ok && h >= 0;
+                    low = (low << 4) | static_cast<uint>(qMax(h, 0));
+                }
+                if (ok && low >= 0xDC00 && low < 0xE000) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    c += 6;
+                }
+            }
+            appendUtf8(raw, codePoint);
+            break;
+        }
+        default:
+            raw.append(*c);     // \" \\ \/
+            break;
+        }
+    }
+    *out = QString::fromUtf8(raw);
+    return true;
+}
+
+bool VoyageLogsJsonReader::readNumber(double* out)
+{
+    skipWhitespace();
+    if (m_pos >= m_end)
+        return false;
+
+    // Some firmware sends numbers as strings, null for missing values
+    if (*m_pos == '"') {
+        const char *save = ++m_pos;
+        bool ok = readNumber(out);
+        if (!ok || m_pos >= m_end || *m_pos != '"') {
+            m_pos = save - 1;
+            *out = 0.0;
+            return skipString();
+        }
+        ++m_pos;
+        return true;
+    }
+    if (*m_pos == 'n' || *m_pos == 't' || *m_pos == 'f') {
+        *out = (*m_pos == 't') ? 1.0 : 0.0;
+        return skipValue();
+    }
+
+    const char *start = m_pos;
+    bool negative = false;
+    if (*m_pos == '-') {
+        negative = true;
+        ++m_pos;
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+
+    while (m_pos < m_end && isDigit(*m_pos)) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<quint64>(*m_pos - '0');
+            if (mantissa != 0)
+                ++digits;
+        } else {
+            ++exponent;
+        }
+        ++m_pos;
+    }
+    if (m_pos < m_end && *m_pos == '.') {
+        ++m_pos;
+        while (m_pos < m_end && isDigit(*m_pos)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<quint64>(*m_pos - '0');
+                if (mantissa != 0)
+                    ++digits;
+                --exponent;
+            }
+            ++m_pos;
+        }
+    }
+    if (m_pos < m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+        ++m_pos;
+        bool expNegative = false;
+        if (m_pos < m_end && (*m_pos == '+' || *m_pos == '-')) {
+            expNegative = *m_pos == '-';
+            ++m_pos;
+        }
+        int e = 0;
+        while (m_pos < m_end && isDigit(*m_pos)) {
+            if (e < 10000)
+                e = e * 10 + (*m_pos - '0');
+            ++m_pos;
+        }
+        exponent += expNegative ? -e : e;
+    }
+
+    if (m_pos == start || (negative && m_pos == start + 1))
+        return false;
+
+    if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+        // Exact: both mantissa and the power of ten fit in a double
+        double value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / kPow10[-exponent] : value * kPow10[exponent];
+        *out = negative ? -value : value;
+        return true;
+    }
+
+    // Long mantissas or large exponents: defer to Qt's correctly rounded parser
+    bool ok = false;
+    *out = QByteArray(start, static_cast<int>(m_pos - start)).toDouble(&ok);
+    return ok;
+}
+
+bool VoyageLogsJsonReader::readInt(int* out)
+{
+    double value = 0.0;
+    if (!readNumber(&value))
+        return false;
+    *out = static_cast<int>(value);
+    return true;
+}
+
+bool VoyageLogsJsonReader::readText(QString* out)
+{
+    skipWhitespace();
+    if (m_pos < m_end && (*m_pos == '"' || *m_pos == 'n'))
+        return readString(out);
+
+    const char *start = m_pos;
+    double ignored = 0.0;
+    if (!readNumber(&ignored))
+        return skipValue();
+    *out = QString::fromLatin1(start, static_cast<int>(m_pos - start));
+    return true;
+}
+
+bool VoyageLogsJsonReader::skipValue()
+{
+    skipWhitespace();
+    if (m_pos >= m_end)
+        return false;
+
+    switch (*m_pos) {
+    case '"':
+        return skipString();
+
+    case '{':
+        ++m_pos;
+        if (consume('}'))
+            return true;
+        while (true) {
+            const char *key = nullptr;
+            int length = 0;
+            if (!readKey(&key, &length) || !skipValue())
+                return false;
+            if (consume(','))
+                continue;
+            return consume('}');
+        }
+
+    case '[':
+        ++m_pos;
+        if (consume(']'))
+            return true;
+        while (true) {
+            if (!skipValue())
+                return false;
+            if (consume(','))
+                continue;
+            return consume(']');
+        }
+
+    default:
+        // number, true, false, null
+        while (m_pos < m_end && *m_pos != ',' && *m_pos != '}' && *m_pos != ']'
+               && *m_pos != ' ' && *m_pos != '\n' && *m_pos != '\r' && *m_pos != '\t')
+            ++m_pos;
+        return true;
+    }
+}
+
+int VoyageLogsJsonReader::countArrayElements()
+{
+    const char *save = m_pos;
+    int count = 0;
+
+    if (consume('[') && !consume(']')) {
+        while (skipValue()) {
+            ++count;
+            if (!consume(','))
+                break;
+        }
+    }
+
+    m_pos = save;
+    return count;
+}
+
+// ------------------- Records -------------------
+
+template <typename Log>
+bool VoyageLogsJsonReader::readArray(QList<Log>* out, bool (VoyageLogsJsonReader::*readItem)(Log*))
+{
+    if (!peek('['))
+        return skipValue();
+
+    out->reserve(out->size() + countArrayElements());
+
+    consume('[');
+    if (consume(']'))
+        return true;
+
+    while (true) {
+        Log log = Log();
+        if (!(this->*readItem)(&log))
+            return false;
+        out->append(log);
+        if (consume(','))
+            continue;
+        return consume(']');
+    }
+}
+
+bool VoyageLogsJsonReader::readPropulsion(PropulsionLog* log)
+{
+    if (!consume('{'))
+        return skipValue();
+    if (consume('}'))
+        return true;
+
+    while (true) {
+        const char *k = nullptr;
+        int n = 0;
+        if (!readKey(&k, &n))
+            return false;
+
+        bool ok;
+        if (keyIs(k, n, "propulsion_log_id"))          ok = readInt(&log->propulsion_log_id);
+        else if (keyIs(k, n, "log_id"))                ok = readInt(&log->log_id);
+        else if (keyIs(k, n, "engine_id"))             ok = readText(&log->engine_id);
+        else if (keyIs(k, n, "status"))                ok = readText(&log->status);
+        else if (keyIs(k, n, "rpm"))                   ok = readInt(&log->rpm);
+        else if (keyIs(k, n, "engine_load"))           ok = readInt(&log->engine_load);
+        else if (keyIs(k, n, "power_output"))          ok = readNumber(&log->power_output);
+        else if (keyIs(k, n, "fuel_consumption_rate")) ok = readNumber(&log->fuel_consumption_rate);
+        else if (keyIs(k, n, "exhaust_gas_temp"))      ok = readInt(&log->exhaust_gas_temp);
+        else                                           ok = skipValue();
+
+        if (!ok)
+            return false;
+        if (consume(','))
+            continue;
+        return consume('}');
+    }
+}
+
+bool VoyageLogsJsonReader::readElectrical(ElectricalLog* log)
+{
+    if (!consume('{'))
+        return skipValue();
+    if (consume('}'))
+        return true;
+
+    while (true) {
+        const char *k = nullptr;
+        int n = 0;
+        if (!readKey(&k, &n))
+            return false;
+
+        bool ok;
+        if (keyIs(k, n, "electrical_log_id"))              ok = readInt(&log->electrical_log_id);
+        else if (keyIs(k, n, "log_id"))                    ok = readInt(&log->log_id);
+        else if (keyIs(k, n, "generator_id"))              ok = readText(&log->generator_id);
+        else if (keyIs(k, n, "status"))                    ok = readText(&log->status);
+        else if (keyIs(k, n, "gen_load"))                  ok = readInt(&log->gen_load);
+        else if (keyIs(k, n, "gen_power_output"))          ok = readNumber(&log->gen_power_output);
+        else if (keyIs(k, n, "gen_fuel_consumption_rate")) ok = readNumber(&log->gen_fuel_consumption_rate);
+        else                                               ok = skipValue();
+
+        if (!ok)
+            return false;
+        if (consume(','))
+            continue;
+        return consume('}');
+    }
+}
+
+bool VoyageLogsJsonReader::readFuelTank(FuelTankLog* log)
+{
+    if (!consume('{'))
+        return skipValue();
+    if (consume('}'))
+        return true;
+
+    while (true) {
+        const char *k = nullptr;
+        int n = 0;
+        if (!readKey(&k, &n))
+            return false;
+
+        bool ok;
+        if (keyIs(k, n, "fuel_tank_log_id")) ok = readInt(&log->fuel_tank_log_id);
+        else if (keyIs(k, n, "log_id"))      ok = readInt(&log->log_id);
+        else if (keyIs(k, n, "tank_id"))     ok = readText(&log->tank_id);
+        else if (keyIs(k, n, "fuel_type"))   ok = readText(&log->fuel_type);
+        else if (keyIs(k, n, "fuel_level"))  ok = readNumber(&log->fuel_level);
+        else if (keyIs(k, n, "fuel_volume")) ok = readNumber(&log->fuel_volume);
+        else                                 ok = skipValue();
+
+        if (!ok)
+            return false;
+        if (consume(','))
+            continue;
+        return consume('}');
+    }
+}
+
+bool VoyageLogsJsonReader::readBallastTank(BallastTankLog* log)
+{
+    if (!consume('{'))
+        return skipValue();
+    if (consume('}'))
+        return true;
+
+    while (true) {
+        const char *k = nullptr;
+        int n = 0;
+        if (!readKey(&k, &n))
+            return false;
+
+        bool ok;
+        if (keyIs(k, n, "ballast_tank_log_id"))         ok = readInt(&log->ballast_tank_log_id);
+        else if (keyIs(k, n, "log_id"))                 ok = readInt(&log->log_id);
+        else if (keyIs(k, n, "tank_id"))                ok = readText(&log->tank_id);
+        else if (keyIs(k, n, "tank_level"))             ok = readNumber(&log->tank_level);
+        else if (keyIs(k, n, "pump_status"))            ok = readText(&log->pump_status);
+        else if (keyIs(k, n, "pump_power_consumption")) ok = readNumber(&log->pump_power_consumption);
+        else                                            ok = skipValue();
+
+        if (!ok)
+            return false;
+        if (consume(','))
+            continue;
+        return consume('}');
+    }
+}
+
+bool VoyageLogsJsonReader::readRecordField(const char* k, int n, VoyageLogs* logs,
+                                           MockApiService::Subsystems* present)
+{
+    bool ok;
+    double course = 0.0;
+
+    if (keyIs(k, n, "log_id"))                   ok = readInt(&logs->log_id);
+    else if (keyIs(k, n, "voyage_id"))           ok = readText(&logs->voyage_id);
+    else if (keyIs(k, n, "timestamp"))           ok = readText(&logs->timestamp);
+    else if (keyIs(k, n, "latitude"))          { ok = readNumber(&logs->latitude); *present |= MockApiService::Navigation; }
+    else if (keyIs(k, n, "longitude"))           ok = readNumber(&logs->longitude);
+    else if (keyIs(k, n, "ship_speed"))        { ok = readNumber(&logs->ship_speed); *present |= MockApiService::Navigation; }
+    else if (keyIs(k, n, "course"))            { ok = readNumber(&course); logs->course = static_cast<int>(course); }
+    else if (keyIs(k, n, "wind_speed"))        { ok = readNumber(&logs->wind_speed); *present |= MockApiService::Weather; }
+    else if (keyIs(k, n, "sea_state"))         { ok = readNumber(&logs->sea_state); *present |= MockApiService::Weather; }
+    else if (keyIs(k, n, "air_temperature"))   { ok = readText(&logs->air_temperature); *present |= MockApiService::Weather; }
+    else if (keyIs(k, n, "humidity"))            ok = readText(&logs->humidity);
+    else if (keyIs(k, n, "barometric_pressure")) ok = readText(&logs->barometric_pressure);
+    else if (keyIs(k, n, "hvac_power"))        { ok = readNumber(&logs->hvac_power); *present |= MockApiService::HotelLoad; }
+    else if (keyIs(k, n, "galley_power"))        ok = readNumber(&logs->galley_power);
+    else if (keyIs(k, n, "lighting_power"))      ok = readNumber(&logs->lighting_power);
+    else if (keyIs(k, n, "total_hotel_load"))  { ok = readNumber(&logs->total_hotel_load); *present |= MockApiService::HotelLoad; }
+    else if (keyIs(k, n, "propulsion_logs")) {
+        ok = readArray(&logs->propulsion_logs, &VoyageLogsJsonReader::readPropulsion);
+        *present |= MockApiService::Propulsion;
+    } else if (keyIs(k, n, "electrical_logs")) {
+        ok = readArray(&logs->electrical_logs, &VoyageLogsJsonReader::readElectrical);
+        *present |= MockApiService::Electrical;
+    } else if (keyIs(k, n, "fuel_tank_logs")) {
+        ok = readArray(&logs->fuel_tank_logs, &VoyageLogsJsonReader::readFuelTank);
+        *present |= MockApiService::FuelTanks;
+    } else if (keyIs(k, n, "ballast_tank_logs")) {
+        ok = readArray(&logs->ballast_tank_logs, &VoyageLogsJsonReader::readBallastTank);
+        *present |= MockApiService::BallastTanks;
+    } else {
+        ok = skipValue();
+    }
+
+    return ok;
+}
+
+bool VoyageLogsJsonReader::readRecord(VoyageLogs* logs, MockApiService::Subsystems* present)
+{
+    if (!consume('{'))
+        return false;
+    if (consume('}'))
+        return true;
+
+    while (true) {
+        const char *k = nullptr;
+        int n = 0;
+        if (!readKey(&k, &n) || !readRecordField(k, n, logs, present))
+            return false;
+        if (consume(','))
+            continue;
+        return consume('}');
+    }
+}
+
+bool VoyageLogsJsonReader::read(DecodedVoyageLogs* decoded)
+{
+    if (!consume('{') || consume('}'))
+        return false;
+
+    // Streamed frames carry the record itself without the "data" envelope,
+    // and its keys may come in any order. Every top-level member other than
+    // "data" is read into a candidate record as it goes by; which of the two
+    // the object was is only decided at its closing brace.
+    VoyageLogs bare = VoyageLogs();
+    MockApiService::Subsystems barePresent = MockApiService::NoSubsystem;
+    bool hasLogId = false;
+    bool found = false;
+
+    while (true) {
+        const char *k = nullptr;
+        int n = 0;
+        if (!readKey(&k, &n))
+            return false;
+
+        if (keyIs(k, n, "data")) {
+            if (peek('[')) {
+                const int count = countArrayElements();
+                decoded->records.reserve(count);
+                decoded->present.reserve(count);
+
+                consume('[');
+                if (!consume(']')) {
+                    while (true) {
+                        VoyageLogs logs = VoyageLogs();
+                        MockApiService::Subsystems present = MockApiService::NoSubsystem;
+                        if (!readRecord(&logs, &present))
+                            return false;
+                        decoded->records.append(logs);
+                        decoded->present.append(present);
+                        if (consume(','))
+                            continue;
+                        if (!consume(']'))
+                            return false;
+                        break;
+                    }
+                }
+                found = true;
+            } else if (peek('{')) {
+                VoyageLogs logs = VoyageLogs();
+                MockApiService::Subsystems present = MockApiService::NoSubsystem;
+                if (!readRecord(&logs, &present))
+                    return false;
+                decoded->records.append(logs);
+                decoded->present.append(present);
+                found = true;
+            } else if (!skipValue()) {
+                return false;
+            }
+        } else if (found) {
+            if (!skipValue())
+                return false;
+        } else {
+            hasLogId = hasLogId || keyIs(k, n, "log_id");
+            if (!readRecordField(k, n, &bare, &barePresent))
+                return false;
+        }
+
+        if (consume(','))
+            continue;
+        if (!consume('}'))
+            return false;
+
+        if (!found && hasLogId) {
+            decoded->records.append(bare);
+            decoded->present.append(barePresent);
+            found = true;
+        }
+        return found;
+    }
+}
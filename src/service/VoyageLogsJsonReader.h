@@ -0,0 +1,56 @@
+#ifndef VOYAGELOGSJSONREADER_H
+#define VOYAGELOGSJSONREADER_H
+
+#include <QByteArray>
+#include "VoyageLogs.h"
+#include "MockApiService.h"
+
+struct DecodedVoyageLogs;
+
+// Single-pass JSON reader for the logs-data payload. Keys are matched in place
+// against the byte buffer and values are written straight into VoyageLogs, so
+// no QJsonDocument/QJsonObject tree or per-key QString is built. Sub-log
+// arrays are counted with a skip scan first and reserved before filling.
+class VoyageLogsJsonReader
+{
+public:
+    explicit VoyageLogsJsonReader(const QByteArray& payload);
+
+    // Accepts {"data": record}, {"data": [records]} or a bare record.
+    // Returns false on malformed input; the caller may fall back to QJsonDocument.
+    bool read(DecodedVoyageLogs* decoded);
+
+private:
+    template <int N>
+    static bool keyIs(const char* key, int length, const char (&literal)[N]);
+
+    void skipWhitespace();
+    bool consume(char c);
+    bool peek(char c);
+
+    bool readKey(const char** key, int* length);
+    bool readString(QString* out);
+    bool readNumber(double* out);
+    bool readInt(int* out);
+    bool readText(QString* out);       // string, or number rendered as text
+    bool skipValue();
+    bool skipString();
+    int countArrayElements();
+
+    bool readRecord(VoyageLogs* logs, MockApiService::Subsystems* present);
+    bool readRecordField(const char* key, int length, VoyageLogs* logs,
+                         MockApiService::Subsystems* present);
+
+    bool readPropulsion(PropulsionLog* log);
+    bool readElectrical(ElectricalLog* log);
+    bool readFuelTank(FuelTankLog* log);
+    bool readBallastTank(BallastTankLog* log);
+
+    template <typename Log>
+    bool readArray(QList<Log>* out, bool (VoyageLogsJsonReader::*readItem)(Log*));
+
+    const char* m_pos;
+    const char* m_end;
+};
+
+#endif // VOYAGELOGSJSONREADER_H
@@ -11,14 +11,24 @@
 #include "Pages/DashboardPage.h"
 
 #include "MapboxWidget.h"
+#include "../service/TelemetryExporter.h"
+#include "../service/TelemetryImporter.h"
+#include "../service/TelemetryStore.h"
 
 #include <QComboBox>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QProgressDialog>
+#include <QStandardPaths>
+#include <QDateTime>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui_MainWindow)
     , m_DockManager(nullptr)
     , m_availableDockArea(nullptr)
+    , m_exporter(new TelemetryExporter(this))
+    , m_importer(new TelemetryImporter(this))
 {
     ui->setupUi(this);
 
@@ -33,7 +43,8 @@ MainWindow::MainWindow(QWidget *parent)
     // --- File ---
     connect(ui->actionOpen_Configuration, &QAction::triggered, this, &MainWindow::previewFeature_clicked);
     connect(ui->actionSave_Configuration, &QAction::triggered, this, &MainWindow::previewFeature_clicked);
-    connect(ui->actionExport_Data, &QAction::triggered, this, &MainWindow::previewFeature_clicked);
+    connect(ui->actionImport_Data, &QAction::triggered, this, &MainWindow::importData_triggered);
+    connect(ui->actionExport_Data, &QAction::triggered, this, &MainWindow::exportData_triggered);
     connect(ui->actionPrint, &QAction::triggered, this, &MainWindow::previewFeature_clicked);
     connect(ui->actionExit, &QAction::triggered, this, &MainWindow::applicationExit);
 
@@ -1129,6 +1140,107 @@ void MainWindow::previewFeature_clicked(bool checked)
     QMessageBox::information(this, "Preview", "This button is a preview-only");
 }
 
+void MainWindow::importData_triggered(bool checked)
+{
+    Q_UNUSED(checked);
+
+    if (m_importer->isRunning()) {
+        QMessageBox::information(this, "Import Data", "An import is already running.");
+        return;
+    }
+
+    const QStringList paths = QFileDialog::getOpenFileNames(
+        this, "Import Data",
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+        "Voyage log archives (*.csv *.txt);;All files (*)");
+    if (paths.isEmpty() || !m_importer->start(paths))
+        return;
+
+    QProgressDialog *dialog = new QProgressDialog("Importing voyage logs...", "Cancel", 0, 100, this);
+    dialog->setWindowTitle("Import Data");
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setMinimumDuration(500);
+    dialog->setValue(0);
+
+    connect(dialog, &QProgressDialog::canceled, m_importer, &TelemetryImporter::cancel);
+    connect(m_importer, &TelemetryImporter::progress, dialog, [dialog](int percent, qint64 rows) {
+        dialog->setLabelText(QString("Importing voyage logs... %1 rows").arg(rows));
+        dialog->setValue(percent);
+    });
+    connect(m_importer, &TelemetryImporter::finished, dialog, [this, dialog](bool success, const QString &message) {
+        // Closing a progress dialog emits canceled(); read the user's choice first
+        const bool canceled = dialog->wasCanceled();
+        disconnect(dialog, &QProgressDialog::canceled, m_importer, &TelemetryImporter::cancel);
+        dialog->close();
+        if (success)
+            QMessageBox::information(this, "Import Data", message);
+        else if (!canceled)
+            QMessageBox::warning(this, "Import Data", message);
+    });
+}
+
+void MainWindow::exportData_triggered(bool checked)
+{
+    Q_UNUSED(checked);
+
+    if (m_exporter->isRunning()) {
+        QMessageBox::information(this, "Export Data", "An export is already running.");
+        return;
+    }
+
+    const TelemetryStore &store = TelemetryStore::instance();
+    if (store.rowCount() == 0) {
+        QMessageBox::information(this, "Export Data", "No telemetry has been recorded yet.");
+        return;
+    }
+
+    bool ok = false;
+    const int days = QInputDialog::getInt(this, "Export Data", "Days of history to export (0 = all):",
+                                          30, 0, 36500, 1, &ok);
+    if (!ok)
+        return;
+
+    const QString defaultName = QString("telemetry-%1.csv")
+                                    .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmm"));
+    const QString path = QFileDialog::getSaveFileName(
+        this, "Export Data",
+        QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).filePath(defaultName),
+        "CSV (*.csv);;Columnar telemetry (*.sctx)");
+    if (path.isEmpty())
+        return;
+
+    const qint64 toMs = store.lastTimestamp() + 1;
+    const qint64 fromMs = days > 0 ? qMax(store.firstTimestamp(), toMs - qint64(days) * 24 * 3600 * 1000)
+                                   : store.firstTimestamp();
+
+    if (!m_exporter->start(path, TelemetryExporter::formatForPath(path), fromMs, toMs))
+        return;
+
+    // Modeless, so the rest of the application stays usable meanwhile
+    QProgressDialog *dialog = new QProgressDialog("Exporting telemetry...", "Cancel", 0, 100, this);
+    dialog->setWindowTitle("Export Data");
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setMinimumDuration(500);
+    dialog->setValue(0);
+
+    connect(dialog, &QProgressDialog::canceled, m_exporter, &TelemetryExporter::cancel);
+    connect(m_exporter, &TelemetryExporter::progress, dialog, [dialog](int percent, qint64 rows) {
+        dialog->setLabelText(QString("Exporting telemetry... %1 rows").arg(rows));
+        dialog->setValue(percent);
+    });
+    connect(m_exporter, &TelemetryExporter::finished, dialog, [this, dialog](bool success, const QString &message) {
+        // Closing a progress dialog emits canceled(), so the user's choice
+        // is read first and the finished job is no longer told about it
+        const bool canceled = dialog->wasCanceled();
+        disconnect(dialog, &QProgressDialog::canceled, m_exporter, &TelemetryExporter::cancel);
+        dialog->close();
+        if (success)
+            QMessageBox::information(this, "Export Data", QString("Exported to %1").arg(message));
+        else if (!canceled)
+            QMessageBox::warning(this, "Export Data", message);
+    });
+}
+
 void MainWindow::applicationExit(bool checked)
 {
     // Confirm dialog before exit
@@ -1227,6 +1339,9 @@ void MainWindow::addDockWidgetWithDockManager(QPushButton *pushButtonSource, boo
         if (!DockWidget)
             return;
 
+        // Closing the tab destroys the page, which also drops its data subscription
+        DockWidget->setFeature(ads::CDockWidget::DockWidgetDeleteOnClose, true);
+
         if (m_availableDockArea == nullptr)
         {
             auto DockAreaWidget = m_DockManager->addDockWidget(area, DockWidget);
@@ -1283,7 +1398,7 @@ void MainWindow::addDockWidgetWithDockManager(QPushButton *pushButtonSource, boo
         }
 
         if (dockToRemove != nullptr)
-            m_DockManager->removeDockWidget(dockToRemove);
+            dockToRemove->deleteDockWidget();
 
         if (map.size()<1)
             m_availableDockArea = nullptr;
@@ -14,6 +14,9 @@ QT_BEGIN_NAMESPACE
 class Ui_MainWindow;
 QT_END_NAMESPACE
 
+class TelemetryExporter;
+class TelemetryImporter;
+
 // ──────────────────────────────────────────────
 // NOTE: Some styling, such as QMenu in QMenuBar,
 //       is configured directly in the .ui file
@@ -55,6 +58,9 @@ private slots:
 
     void previewFeature_clicked(bool checked);
 
+    void importData_triggered(bool checked);
+    void exportData_triggered(bool checked);
+
     void applicationExit(bool checked);
     void applicationUserManual(bool checked);
     void applicationAbout(bool checked);
@@ -84,6 +90,9 @@ private:
 
     QPushButton* m_pushButtonWelcomePage;
 
+    TelemetryExporter* m_exporter;
+    TelemetryImporter* m_importer;
+
 // Utilities
 private:
     QAction* createToolbarAction(QToolBar* toolbar, const QString& iconPath, const QString& text, QObject* parent = nullptr);
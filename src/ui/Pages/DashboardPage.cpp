@@ -62,7 +62,11 @@ DashboardPage::DashboardPage(QWidget *parent)
     connect(MockApiService::instance(), &MockApiService::dataUpdated,
             this, &DashboardPage::onDataUpdated);
 
-    MockApiService::instance()->startPolling(1, 5000);
+    MockApiService::instance()->subscribe(this,
+                                          MockApiService::Navigation
+                                              | MockApiService::Weather
+                                              | MockApiService::Propulsion,
+                                          5000);
 
 
     // KPI Animation Timer
@@ -97,6 +101,10 @@ DashboardPage::DashboardPage(QWidget *parent)
 
     createWidgetFrameOverlay();
     positionOverlay();
+
+    // Deltas only carry changes; start from what the service already has
+    if (MockApiService::instance()->hasState())
+        onDataUpdated(MockApiService::instance()->currentState());
 }
 
 void DashboardPage::setupInitialMapRoute()
@@ -200,6 +208,8 @@ void DashboardPage::setupShipMovementSimulation()
 
     // Start the simulation after a small delay to ensure map is ready
     QTimer::singleShot(1000, this, [this](){
+        if (m_followingTelemetry)
+            return;
         qDebug() << "Starting ship movement simulation";
         m_shipUpdateTimer->start(1000); // Update every 1000ms = 1 second
     });
@@ -325,6 +335,17 @@ void DashboardPage::setupIcon()
 
 void DashboardPage::onDataUpdated(const VoyageLogs &data)
 {
+    // Live or replayed positions take over from the route simulation
+    if (m_mapboxWidget && (data.latitude != 0.0 || data.longitude != 0.0)) {
+        m_followingTelemetry = true;
+        if (m_shipUpdateTimer && m_shipUpdateTimer->isActive())
+            m_shipUpdateTimer->stop();
+        m_mapboxWidget->setShipPosition(data.longitude, data.latitude, data.course);
+    }
+
+    if (data.propulsion_logs.isEmpty())
+        return;
+
     // Print received data for debugging
 
     // m_KPIOverviewFrame->labelFOConsumption()->setText(QString::number(data.propulsion_logs[0].fuel_consumption_rate, 'f', 2));
@@ -97,6 +97,7 @@ private:
     QList<QPointF> m_routeCoordinates;
     int m_currentRouteIndex = 0;
     double m_shipProgress = 0.0;
+    bool m_followingTelemetry = false;   // real positions are arriving
 
     // Legacy variables
     QVariantList m_routePoints;
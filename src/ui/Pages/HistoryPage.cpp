@@ -1,13 +1,85 @@
 #include "HistoryPage.h"
 #include "ui_HistoryPage.h"
+#include "../../service/TelemetryRollups.h"
+#include "../../service/TelemetryDcs.h"
+#include "../../service/MockApiService.h"
+#include "../../service/TelemetryReplay.h"
 #include <QApplication>
 #include <QStandardPaths>
 #include <QDir>
+#include <QSignalBlocker>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const qint64 kHourMs = 3600 * 1000;
+const qint64 kDayMs = 24 * kHourMs;
+const qint64 kMinuteMs = 60 * 1000;
+const qint64 kLiveWindowMs = 24 * kHourMs;
+const int kLiveCapacity = 24 * 3600;        // one sample a second for a day
+
+// Per-bucket sum over equipment slots of a channel's mean, from the rollups
+QHash<qint64, double> summedMeans(TelemetryChannel channel, qint64 fromMs, qint64 toMs, qint64 resolutionMs)
+{
+    QHash<qint64, double> totals;
+    for (int slot = 0; slot < 16; ++slot) {
+        const QVector<RollupBucket> buckets =
+            TelemetryRollups::instance().query(channel, slot, fromMs, toMs, resolutionMs);
+        for (const RollupBucket &bucket : buckets)
+            totals[bucket.startMs] += bucket.value.mean();
+    }
+    return totals;
+}
+
+// t CO2 per t of fuel on each UTC day, weighted by the fuel types DCS saw
+// leave the tanks that day; days without tank data use the year's mix
+struct CarbonFactors
+{
+    QMap<qint64, double> byDay;
+    double fallback = TelemetryDcs::carbonFactor(QString());
+
+    double at(qint64 timestampMs) const { return byDay.value(timestampMs / kDayMs * kDayMs, fallback); }
+};
+
+CarbonFactors carbonFactors(qint64 fromMs, qint64 toMs)
+{
+    TelemetryDcs &dcs = TelemetryDcs::instance();
+    CarbonFactors factors;
+    const DcsFigures year = dcs.year(QDate::currentDate().year());
+    if (year.totalFuelTonnes() > 0.0)
+        factors.fallback = year.co2Tonnes() / year.totalFuelTonnes();
+
+    const QMap<qint64, DcsFigures> days = dcs.days(fromMs - kDayMs, toMs);
+    for (auto it = days.constBegin(); it != days.constEnd(); ++it) {
+        if (it.value().totalFuelTonnes() > 0.0)
+            factors.byDay.insert(it.key(), it.value().co2Tonnes() / it.value().totalFuelTonnes());
+    }
+    return factors;
+}
+
+// Nearest-rank percentile, p in [0, 100]
+double percentile(QVector<double> values, double p)
+{
+    if (values.isEmpty())
+        return 0.0;
+    const int rank = qBound(0, int(std::ceil(p / 100.0 * values.size())) - 1, values.size() - 1);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values.at(rank);
+}
+
+} // namespace
 
 HistoryPage::HistoryPage(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::HistoryPage)
     , m_updateTimer(new QTimer(this))
+    , m_dcsVersion(0)
+    , m_liveFuel(nullptr)
+    , m_reports(new TelemetryReport(this))
+    , m_heatMap(nullptr)
+    , m_heatMapMeanEmission(0.0)
+    , m_heatMapSample(false)
 {
     ui->setupUi(this);
 
@@ -186,9 +258,18 @@ HistoryPage::HistoryPage(QWidget *parent)
     connect(ui->listWidget, &QListWidget::currentRowChanged,
             this, &HistoryPage::onNavigationSelectionChanged);
 
-    // Setup timer for DCS updates
+    // DCS totals are kept current by TelemetryDcs; the page only redraws
+    // when they have changed
     connect(m_updateTimer, &QTimer::timeout, this, &HistoryPage::updateDCSChart);
-    m_updateTimer->start(5000); // Update every 5 seconds
+    // The heat map's latest hours fill in as the rollups catch up
+    connect(m_updateTimer, &QTimer::timeout, this, &HistoryPage::refreshHeatMap);
+    m_updateTimer->start(5000);
+
+    // Live ME fuel rate; the service already records every frame, the
+    // chart only keeps the last day in memory
+    connect(MockApiService::instance(), &MockApiService::frameUpdated,
+            this, &HistoryPage::onFrameUpdated);
+    MockApiService::instance()->subscribe(this, MockApiService::Propulsion, 5000);
 }
 
 HistoryPage::~HistoryPage()
@@ -223,44 +304,81 @@ QWidget* HistoryPage::createDCSPage()
     title->setStyleSheet("font-size: 16pt; font-weight: bold; color: white; margin-bottom: 10px; background-color: transparent;");
     layout->addWidget(title);
 
-    // Component selection with proper spacing
+    // Reporting period: calendar years and voyages
     QHBoxLayout *selectionLayout = new QHBoxLayout;
     selectionLayout->setSpacing(10);
 
-    QLabel *componentLabel = new QLabel("Select Component:");
-    componentLabel->setStyleSheet("color: white; font-size: 11pt; background-color: transparent; min-width: 120px;");
+    QLabel *periodLabel = new QLabel("Reporting Period:");
+    periodLabel->setStyleSheet("color: white; font-size: 11pt; background-color: transparent; min-width: 120px;");
 
-    m_dcsComponentCombo = new QComboBox;
-    m_dcsComponentCombo->setMinimumWidth(300);
-    m_dcsComponentCombo->addItem("Main Engine (ME) - Exhaust Temperature");
-    m_dcsComponentCombo->addItem("Main Engine (ME) - Cylinder Temperature");
-    m_dcsComponentCombo->addItem("Auxiliary Engine (AE) - Exhaust Temperature");
-    // m_dcsComponentCombo->addItem("Boiler - Steam Temperature");
-    // m_dcsComponentCombo->addItem("Turbocharger - Inlet Temperature");
+    m_dcsPeriodCombo = new QComboBox;
+    m_dcsPeriodCombo->setMinimumWidth(300);
 
-    selectionLayout->addWidget(componentLabel);
-    selectionLayout->addWidget(m_dcsComponentCombo);
+    selectionLayout->addWidget(periodLabel);
+    selectionLayout->addWidget(m_dcsPeriodCombo);
     selectionLayout->addStretch();
     layout->addLayout(selectionLayout);
 
+    m_dcsFigures = new QLabel;
+    m_dcsFigures->setTextFormat(Qt::RichText);
+    m_dcsFigures->setStyleSheet("color: white; font-size: 11pt; background-color: #333333; border: 1px solid #555555; padding: 10px;");
+    layout->addWidget(m_dcsFigures);
+
     // Chart
     m_chart = new QChart();
-    m_chart->setTitle("Real-time Monitoring Data");
+    m_chart->setTitle("Cumulative Fuel Consumption");
     m_chart->setTitleBrush(QBrush(Qt::white));
     m_chart->setBackgroundBrush(QBrush(QColor(43, 43, 43)));
     m_chart->legend()->setLabelColor(Qt::white);
 
+    // Kept across refreshes; only the series are replaced
+    m_dcsTimeAxis = new QDateTimeAxis;
+    m_dcsTimeAxis->setFormat("dd MMM");
+    m_dcsTimeAxis->setTitleText("Date (UTC)");
+    m_dcsTimeAxis->setTitleBrush(QBrush(Qt::white));
+    m_dcsTimeAxis->setLabelsBrush(QBrush(Qt::white));
+    m_dcsTimeAxis->setGridLineColor(QColor(100, 100, 100));
+    m_chart->addAxis(m_dcsTimeAxis, Qt::AlignBottom);
+
+    m_dcsFuelAxis = new QValueAxis;
+    m_dcsFuelAxis->setTitleText("Fuel consumed (t)");
+    m_dcsFuelAxis->setTitleBrush(QBrush(Qt::white));
+    m_dcsFuelAxis->setLabelsBrush(QBrush(Qt::white));
+    m_dcsFuelAxis->setGridLineColor(QColor(100, 100, 100));
+    m_chart->addAxis(m_dcsFuelAxis, Qt::AlignLeft);
+
     m_chartView = new QChartView(m_chart);
     m_chartView->setRenderHint(QPainter::Antialiasing);
     m_chartView->setStyleSheet("background-color: #2B2B2B; border: 1px solid #555555;");
 
     layout->addWidget(m_chartView, 1);
 
-    connect(m_dcsComponentCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, &HistoryPage::onDCSComponentChanged);
+    // Live fuel rate per main engine over the last 24 h
+    m_liveChart = new QChart();
+    m_liveChart->setTitle("Main Engine Fuel Rate (kg/h), last 24 h");
+    m_liveChart->setTitleBrush(QBrush(Qt::white));
+    m_liveChart->setBackgroundBrush(QBrush(QColor(43, 43, 43)));
+    m_liveChart->legend()->setLabelColor(Qt::white);
+
+    m_liveFuel = new StreamingChart(m_liveChart, kLiveWindowMs, kLiveCapacity, this);
+    m_liveFuel->timeAxis()->setFormat("HH:mm");
+    m_liveFuel->timeAxis()->setTickCount(7);
+    m_liveFuel->timeAxis()->setLabelsColor(Qt::white);
+    m_liveFuel->valueAxis()->setLabelFormat("%.0f");
+    m_liveFuel->valueAxis()->setLabelsColor(Qt::white);
+
+    m_liveChartView = new QChartView(m_liveChart);
+    m_liveChartView->setRenderHint(QPainter::Antialiasing);
+    m_liveChartView->setStyleSheet("background-color: #2B2B2B; border: 1px solid #555555;");
 
-    // Generate initial data
-    generateDummyChartData();
+    layout->addWidget(m_liveChartView, 1);
+    prefillLiveFuel();
+
+    refreshDCSPeriods();
+    connect(m_dcsPeriodCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HistoryPage::onDCSPeriodChanged);
+
+    showDCSFigures();
 
     return dcsPage;
 }
@@ -279,7 +397,7 @@ QWidget* HistoryPage::createHistoricalPage()
     QHBoxLayout *legendLayout = new QHBoxLayout;
     legendLayout->setSpacing(5);
 
-    QLabel *legendLabel = new QLabel("Emission Level:");
+    QLabel *legendLabel = new QLabel("Emission Level (t CO₂/h):");
     legendLabel->setStyleSheet("color: white; margin-right: 10px; background-color: transparent; font-size: 11pt;");
     legendLayout->addWidget(legendLabel);
 
@@ -293,11 +411,18 @@ QWidget* HistoryPage::createHistoricalPage()
         colorBox->setStyleSheet(QString("background-color: %1; border: 1px solid #666666;").arg(legendColors[i]));
         QLabel *legendText = new QLabel(legendItems[i]);
         legendText->setStyleSheet("color: white; margin-right: 15px; background-color: transparent; font-size: 10pt;");
+        m_heatMapLegend.append(legendText);
 
         legendLayout->addWidget(colorBox);
         legendLayout->addWidget(legendText);
     }
     legendLayout->addStretch();
+
+    m_heatMapRangeCombo = new QComboBox;
+    m_heatMapRangeCombo->addItem("Last 7 days", 7);
+    m_heatMapRangeCombo->addItem("Last 30 days", 30);
+    m_heatMapRangeCombo->addItem("Last 365 days", 365);
+    legendLayout->addWidget(m_heatMapRangeCombo);
     layout->addLayout(legendLayout);
 
     // Heat map scroll area
@@ -306,24 +431,176 @@ QWidget* HistoryPage::createHistoricalPage()
     m_heatMapScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     m_heatMapScrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
 
+    m_heatMap = new EmissionHeatMap;
+    m_heatMapScrollArea->setWidget(m_heatMap);
     createHeatMapGrid();
+    connect(m_heatMapRangeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HistoryPage::onHeatMapRangeChanged);
 
     layout->addWidget(m_heatMapScrollArea, 1);
+    layout->addWidget(createReplayControls());
 
     return historicalPage;
 }
 
+QWidget* HistoryPage::createReplayControls()
+{
+    QFrame *frame = new QFrame;
+    QVBoxLayout *layout = new QVBoxLayout(frame);
+    layout->setContentsMargins(0, 10, 0, 0);
+
+    QLabel *title = new QLabel("Replay Recorded History");
+    title->setStyleSheet("font-size: 12pt; font-weight: bold; color: white; background-color: transparent;");
+    layout->addWidget(title);
+
+    QHBoxLayout *rangeLayout = new QHBoxLayout;
+    const QDateTime now = QDateTime::currentDateTime();
+    m_replayFrom = new QDateTimeEdit(now.addSecs(-3600));
+    m_replayTo = new QDateTimeEdit(now);
+    for (QDateTimeEdit *edit : {m_replayFrom, m_replayTo}) {
+        edit->setDisplayFormat("yyyy-MM-dd HH:mm");
+        edit->setCalendarPopup(true);
+        edit->setStyleSheet("background-color: #4F4F4F; color: white; border: 1px solid #666666; border-radius: 4px; padding: 6px; font-size: 11pt;");
+    }
+
+    QLabel *fromLabel = new QLabel("From:");
+    QLabel *toLabel = new QLabel("To:");
+    fromLabel->setStyleSheet("color: white; background-color: transparent; font-size: 11pt;");
+    toLabel->setStyleSheet("color: white; background-color: transparent; font-size: 11pt;");
+
+    m_replayStartButton = new QPushButton("Start Replay");
+    m_replayPlayButton = new QPushButton("Play");
+    m_replayStepButton = new QPushButton("Step");
+    m_replaySpeedCombo = new QComboBox;
+    for (int factor : {1, 10, 60, 100, 600, 1000})
+        m_replaySpeedCombo->addItem(QString("%1x").arg(factor), factor);
+
+    rangeLayout->addWidget(fromLabel);
+    rangeLayout->addWidget(m_replayFrom);
+    rangeLayout->addWidget(toLabel);
+    rangeLayout->addWidget(m_replayTo);
+    rangeLayout->addWidget(m_replayStartButton);
+    rangeLayout->addStretch();
+    rangeLayout->addWidget(m_replayPlayButton);
+    rangeLayout->addWidget(m_replayStepButton);
+    rangeLayout->addWidget(m_replaySpeedCombo);
+    layout->addLayout(rangeLayout);
+
+    QHBoxLayout *positionLayout = new QHBoxLayout;
+    m_replaySlider = new QSlider(Qt::Horizontal);
+    m_replayPosition = new QLabel("--");
+    m_replayPosition->setStyleSheet("color: white; background-color: transparent; font-size: 10pt;");
+    m_replayPosition->setMinimumWidth(140);
+    positionLayout->addWidget(m_replaySlider, 1);
+    positionLayout->addWidget(m_replayPosition);
+    layout->addLayout(positionLayout);
+
+    TelemetryReplay *replay = MockApiService::instance()->replay();
+    connect(m_replayStartButton, &QPushButton::clicked, this, &HistoryPage::onReplayStartStop);
+    connect(m_replayPlayButton, &QPushButton::clicked, this, &HistoryPage::onReplayPlayPause);
+    connect(m_replayStepButton, &QPushButton::clicked, replay, &TelemetryReplay::step);
+    connect(m_replaySpeedCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HistoryPage::onReplaySpeedChanged);
+    // Seek once the handle is let go, not for every pixel it is dragged
+    connect(m_replaySlider, &QSlider::sliderReleased, this, &HistoryPage::onReplaySliderReleased);
+    connect(m_replaySlider, &QSlider::actionTriggered, this, [this](int action) {
+        if (action != QAbstractSlider::SliderMove)
+            QTimer::singleShot(0, this, &HistoryPage::onReplaySliderReleased);
+    });
+    connect(MockApiService::instance(), &MockApiService::replayingChanged,
+            this, &HistoryPage::onReplayingChanged);
+    connect(replay, &TelemetryReplay::positionChanged, this, &HistoryPage::onReplayPositionChanged);
+    connect(replay, &TelemetryReplay::playingChanged, this, &HistoryPage::onReplayPlayingChanged);
+
+    onReplayingChanged(MockApiService::instance()->isReplaying());
+    return frame;
+}
+
+void HistoryPage::onReplayStartStop()
+{
+    MockApiService *service = MockApiService::instance();
+    if (service->isReplaying()) {
+        service->stopReplay();
+        return;
+    }
+
+    const qint64 fromMs = m_replayFrom->dateTime().toMSecsSinceEpoch();
+    const qint64 toMs = m_replayTo->dateTime().toMSecsSinceEpoch();
+    if (toMs <= fromMs || !service->startReplay(fromMs, toMs))
+        m_replayPosition->setText("No recorded data in range");
+}
+
+void HistoryPage::onReplayPlayPause()
+{
+    TelemetryReplay *replay = MockApiService::instance()->replay();
+    if (replay->isPlaying())
+        replay->pause();
+    else
+        replay->play();
+}
+
+void HistoryPage::onReplaySliderReleased()
+{
+    TelemetryReplay *replay = MockApiService::instance()->replay();
+    if (replay->isOpen())
+        replay->seek(replay->startMs() + qint64(m_replaySlider->value()) * 1000);
+}
+
+void HistoryPage::onReplaySpeedChanged(int index)
+{
+    MockApiService::instance()->replay()->setSpeed(m_replaySpeedCombo->itemData(index).toDouble());
+}
+
+void HistoryPage::onReplayingChanged(bool replaying)
+{
+    TelemetryReplay *replay = MockApiService::instance()->replay();
+    m_replayStartButton->setText(replaying ? "Stop Replay" : "Start Replay");
+    m_replayFrom->setEnabled(!replaying);
+    m_replayTo->setEnabled(!replaying);
+    m_replayPlayButton->setEnabled(replaying);
+    m_replayStepButton->setEnabled(replaying);
+    m_replaySlider->setEnabled(replaying);
+
+    if (replaying) {
+        replay->setSpeed(m_replaySpeedCombo->currentData().toDouble());
+        m_replaySlider->setRange(0, int((replay->endMs() - replay->startMs()) / 1000));
+        onReplayPositionChanged(replay->positionMs());
+    } else {
+        m_replaySlider->setValue(0);
+        m_replayPosition->setText("--");
+    }
+    onReplayPlayingChanged(replaying && replay->isPlaying());
+}
+
+void HistoryPage::onReplayPositionChanged(qint64 positionMs)
+{
+    TelemetryReplay *replay = MockApiService::instance()->replay();
+    if (!replay->isOpen())
+        return;
+
+    if (!m_replaySlider->isSliderDown()) {
+        QSignalBlocker blocker(m_replaySlider);
+        m_replaySlider->setValue(int((positionMs - replay->startMs()) / 1000));
+    }
+    m_replayPosition->setText(QDateTime::fromMSecsSinceEpoch(positionMs).toString("yyyy-MM-dd HH:mm:ss"));
+}
+
+void HistoryPage::onReplayPlayingChanged(bool playing)
+{
+    m_replayPlayButton->setText(playing ? "Pause" : "Play");
+}
+
 QWidget* HistoryPage::createReportPage()
 {
     QWidget *reportPage = new QWidget;
     QVBoxLayout *layout = new QVBoxLayout(reportPage);
 
     // Title with dark theme
-    QLabel *title = new QLabel("CII Compliance Reports");
+    QLabel *title = new QLabel("Compliance Reports");
     title->setStyleSheet("font-size: 16pt; font-weight: bold; color: white; margin-bottom: 10px; background-color: transparent;");
     layout->addWidget(title);
 
-    // Report selection with proper sizing
+    // Report and period selection
     QHBoxLayout *selectionLayout = new QHBoxLayout;
     selectionLayout->setSpacing(10);
 
@@ -332,14 +609,20 @@ QWidget* HistoryPage::createReportPage()
 
     m_reportCombo = new QComboBox;
     m_reportCombo->setMinimumWidth(400);
-    m_reportCombo->addItem("SHIP MANAGEMENT PLAN TO IMPROVE ENERGY EFFICIENCY (PART I OF THE SEEMP)");
-    m_reportCombo->addItem("SHIP FUEL OIL CONSUMPTION DATA COLLECTION PLAN (PART II OF THE SEEMP)");
-    m_reportCombo->addItem("SHIP OPERATIONAL CARBON INTENSITY PLAN (PART III OF THE SEEMP)");
-    m_reportCombo->addItem("STANDARDIZED DATA REPORTING FORMAT FOR THE DATA COLLECTION SYSTEM");
-    m_reportCombo->addItem("STANDARDIZED DATA REPORTING FORMAT FOR THE PARAMETERS TO CALCULATE TRIAL CII");
+    m_reportCombo->addItem(TelemetryReport::typeName(TelemetryReport::Cii), int(TelemetryReport::Cii));
+    m_reportCombo->addItem(TelemetryReport::typeName(TelemetryReport::Dcs), int(TelemetryReport::Dcs));
+    m_reportCombo->addItem(TelemetryReport::typeName(TelemetryReport::VoyageSummary), int(TelemetryReport::VoyageSummary));
+
+    m_reportPeriodCombo = new QComboBox;
+    m_reportPeriodCombo->setMinimumWidth(250);
+
+    m_reportStatus = new QLabel;
+    m_reportStatus->setStyleSheet("color: #AAAAAA; font-size: 10pt; background-color: transparent;");
 
     selectionLayout->addWidget(reportLabel);
     selectionLayout->addWidget(m_reportCombo);
+    selectionLayout->addWidget(m_reportPeriodCombo);
+    selectionLayout->addWidget(m_reportStatus);
     selectionLayout->addStretch();
     layout->addLayout(selectionLayout);
 
@@ -353,6 +636,10 @@ QWidget* HistoryPage::createReportPage()
 
     connect(m_reportCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &HistoryPage::onReportSelectionChanged);
+    connect(m_reportPeriodCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HistoryPage::onReportSelectionChanged);
+    connect(m_reports, &TelemetryReport::reportReady, this, &HistoryPage::onReportReady);
+    connect(m_reports, &TelemetryReport::reportFailed, this, &HistoryPage::onReportFailed);
 
     // Load first report
     onReportSelectionChanged();
@@ -362,117 +649,239 @@ QWidget* HistoryPage::createReportPage()
 
 void HistoryPage::createHeatMapGrid()
 {
-    QWidget *heatMapWidget = new QWidget;
-    m_heatMapLayout = new QGridLayout(heatMapWidget);
-    m_heatMapLayout->setSpacing(2);
+    const int days = m_heatMapRangeCombo->currentData().toInt();
+    const QDate firstDay = QDate::currentDate().addDays(1 - days);
+    m_heatMap->setDays(firstDay, days);
+
+    // Hourly fuel burn (kg/h) and power (kW) of main engines and generators
+    const qint64 fromMs = QDateTime(firstDay, QTime(0, 0)).toMSecsSinceEpoch();
+    const qint64 toMs = fromMs + days * 24 * kHourMs;
+    const CarbonFactors factors = carbonFactors(fromMs, toMs);
+    QHash<qint64, double> fuel = summedMeans(TelemetryChannel::FuelConsumptionRate, fromMs, toMs, kHourMs);
+    QHash<qint64, double> power = summedMeans(TelemetryChannel::PowerOutput, fromMs, toMs, kHourMs);
+    const QHash<qint64, double> genFuel = summedMeans(TelemetryChannel::GenFuelConsumptionRate, fromMs, toMs, kHourMs);
+    const QHash<qint64, double> genPower = summedMeans(TelemetryChannel::GenPowerOutput, fromMs, toMs, kHourMs);
+    for (auto it = genFuel.constBegin(); it != genFuel.constEnd(); ++it)
+        fuel[it.key()] += it.value();
+    for (auto it = genPower.constBegin(); it != genPower.constEnd(); ++it)
+        power[it.key()] += it.value();
+
+    // Emission in t CO2/h; saving is measured against the period's mean
+    m_heatMapSample = fuel.isEmpty();
+    QHash<qint64, double> emissions;
+    if (m_heatMapSample) {
+        // No history recorded yet: generated sample data in a plausible range
+        for (int hour = 0; hour < days * 24; ++hour) {
+            const qint64 hourStart = fromMs + hour * kHourMs;
+            emissions.insert(hourStart, 2.0 + QRandomGenerator::global()->generateDouble() * 2.0);
+            power.insert(hourStart, 5000.0 + QRandomGenerator::global()->generateDouble() * 3000.0);
+        }
+    } else {
+        for (auto it = fuel.constBegin(); it != fuel.constEnd(); ++it)
+            emissions.insert(it.key(), it.value() / 1000.0 * factors.at(it.key()));
+    }
 
-    // Create time labels (hours)
-    QStringList timeLabels;
-    for (int hour = 0; hour < 24; ++hour) {
-        timeLabels << QString("%1:00").arg(hour, 2, 10, QChar('0'));
+    m_heatMapMeanEmission = 0.0;
+    for (double emission : emissions)
+        m_heatMapMeanEmission += emission;
+    if (!emissions.isEmpty())
+        m_heatMapMeanEmission /= emissions.size();
+
+    // Colour bands follow the period's own spread: the lowest quarter is
+    // Low, the top 5% Critical
+    const QVector<double> values = emissions.values();
+    const double mediumFrom = percentile(values, 25);
+    const double highFrom = percentile(values, 75);
+    const double criticalFrom = percentile(values, 95);
+    m_heatMap->setThresholds(mediumFrom, highFrom, criticalFrom);
+    if (m_heatMapLegend.size() == 4) {
+        m_heatMapLegend[0]->setText(QString("Low < %1").arg(mediumFrom, 0, 'f', 2));
+        m_heatMapLegend[1]->setText(QString("Medium < %1").arg(highFrom, 0, 'f', 2));
+        m_heatMapLegend[2]->setText(QString("High < %1").arg(criticalFrom, 0, 'f', 2));
+        m_heatMapLegend[3]->setText(QString("Critical ≥ %1").arg(criticalFrom, 0, 'f', 2));
     }
 
-    // Create date labels (7 days)
-    QStringList dateLabels;
-    QDate currentDate = QDate::currentDate().addDays(-6);
-    for (int day = 0; day < 7; ++day) {
-        dateLabels << currentDate.addDays(day).toString("d MMM yy");
+    for (auto it = emissions.constBegin(); it != emissions.constEnd(); ++it) {
+        const qint64 index = (it.key() - fromMs) / kHourMs;
+        const double emission = it.value();
+        const double saving = m_heatMapMeanEmission > 0.0
+                              ? qMax(0.0, (m_heatMapMeanEmission - emission) / m_heatMapMeanEmission * 100.0) : 0.0;
+        m_heatMap->setHour(int(index / 24), int(index % 24), emission, power.value(it.key()) / 1000.0, saving);
+    }
+}
+
+void HistoryPage::refreshHeatMap()
+{
+    if (!m_heatMap)
+        return;
+
+    // A new day moves every row; otherwise only the last two hours change
+    const int days = m_heatMapRangeCombo->currentData().toInt();
+    if (m_heatMap->firstDay() != QDate::currentDate().addDays(1 - days)) {
+        createHeatMapGrid();
+        return;
     }
 
-    // Add time header with dark theme styling
-    for (int col = 0; col < timeLabels.size(); ++col) {
-        QLabel *timeLabel = new QLabel(timeLabels[col]);
-        timeLabel->setAlignment(Qt::AlignCenter);
-        timeLabel->setStyleSheet("color: white; font-size: 10pt; padding: 5px; background-color: #333333; border: 1px solid #555555;");
-        timeLabel->setMinimumHeight(25);
-        m_heatMapLayout->addWidget(timeLabel, 0, col + 1);
+    const qint64 mapStartMs = QDateTime(m_heatMap->firstDay(), QTime(0, 0)).toMSecsSinceEpoch();
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    const qint64 fromMs = qMax(mapStartMs, mapStartMs + (nowMs - mapStartMs) / kHourMs * kHourMs - kHourMs);
+    const qint64 toMs = nowMs + 1;
+    QHash<qint64, double> fuel = summedMeans(TelemetryChannel::FuelConsumptionRate, fromMs, toMs, kHourMs);
+    if (fuel.isEmpty())
+        return;
+    if (m_heatMapSample) {
+        // The first recorded hours replace the sample data
+        createHeatMapGrid();
+        return;
     }
 
-    // Add heat map cells with enhanced styling
-    for (int row = 0; row < dateLabels.size(); ++row) {
-        // Date label with consistent styling
-        QLabel *dateLabel = new QLabel(dateLabels[row]);
-        dateLabel->setAlignment(Qt::AlignCenter);
-        dateLabel->setStyleSheet("color: white; font-size: 10pt; padding: 5px; background-color: #333333; border: 1px solid #555555;");
-        dateLabel->setMinimumSize(80, 25);
-        m_heatMapLayout->addWidget(dateLabel, row + 1, 0);
+    QHash<qint64, double> power = summedMeans(TelemetryChannel::PowerOutput, fromMs, toMs, kHourMs);
+    const QHash<qint64, double> genFuel = summedMeans(TelemetryChannel::GenFuelConsumptionRate, fromMs, toMs, kHourMs);
+    const QHash<qint64, double> genPower = summedMeans(TelemetryChannel::GenPowerOutput, fromMs, toMs, kHourMs);
+    for (auto it = genFuel.constBegin(); it != genFuel.constEnd(); ++it)
+        fuel[it.key()] += it.value();
+    for (auto it = genPower.constBegin(); it != genPower.constEnd(); ++it)
+        power[it.key()] += it.value();
+
+    const CarbonFactors factors = carbonFactors(fromMs, toMs);
+    for (auto it = fuel.constBegin(); it != fuel.constEnd(); ++it) {
+        const qint64 index = (it.key() - mapStartMs) / kHourMs;
+        const double emission = it.value() / 1000.0 * factors.at(it.key());
+        const double saving = m_heatMapMeanEmission > 0.0
+                              ? qMax(0.0, (m_heatMapMeanEmission - emission) / m_heatMapMeanEmission * 100.0) : 0.0;
+        m_heatMap->setHour(int(index / 24), int(index % 24), emission, power.value(it.key()) / 1000.0, saving);
+    }
+}
 
-        // Heat map cells for each hour
-        for (int col = 0; col < timeLabels.size(); ++col) {
-            // Generate random emission data
-            double emission = 50.0 + QRandomGenerator::global()->generateDouble() * (100.0 - 50.0);
-            double power    = 800.0 + QRandomGenerator::global()->generateDouble() * (900.0 - 800.0);
-            double saving   = 0.0 + QRandomGenerator::global()->generateDouble() * (15.0 - 0.0);
+void HistoryPage::onHeatMapRangeChanged()
+{
+    createHeatMapGrid();
+}
 
-            HeatMapCell *cell = new HeatMapCell(timeLabels[col], dateLabels[row],
-                                              emission, power, saving);
-            cell->setMinimumSize(35, 25);
-            cell->setStyleSheet("border: 1px solid #555555;");
-            m_heatMapLayout->addWidget(cell, row + 1, col + 1);
+// Years newest first, then voyages newest first; the selection survives
+// a rebuild. Item data is the year (int) or the voyage name.
+void HistoryPage::fillPeriodCombo(QComboBox* combo, bool voyagesOnly)
+{
+    const TelemetryDcs &dcs = TelemetryDcs::instance();
+    QStringList labels;
+    QVariantList periods;
+
+    if (!voyagesOnly) {
+        const QList<int> years = dcs.years();
+        for (int i = years.size() - 1; i >= 0; --i) {
+            labels << QString("Calendar Year %1").arg(years.at(i));
+            periods << QVariant(years.at(i));
+        }
+        const int thisYear = QDateTime::currentDateTimeUtc().date().year();
+        if (years.isEmpty() || years.last() != thisYear) {
+            labels.prepend(QString("Calendar Year %1").arg(thisYear));
+            periods.prepend(QVariant(thisYear));
         }
     }
+    const QStringList voyages = dcs.voyages();
+    for (int i = voyages.size() - 1; i >= 0; --i) {
+        labels << QString("Voyage %1").arg(voyages.at(i));
+        periods << QVariant(voyages.at(i));
+    }
 
-    m_heatMapScrollArea->setWidget(heatMapWidget);
+    bool same = labels.size() == combo->count();
+    for (int i = 0; same && i < labels.size(); ++i)
+        same = combo->itemText(i) == labels.at(i);
+    if (same)
+        return;
+
+    const QVariant current = combo->currentData();
+    QSignalBlocker blocker(combo);
+    combo->clear();
+    for (int i = 0; i < labels.size(); ++i)
+        combo->addItem(labels.at(i), periods.at(i));
+    const int index = current.isValid() ? combo->findData(current) : -1;
+    combo->setCurrentIndex(qMax(0, index));
 }
 
-void HistoryPage::generateDummyChartData()
+void HistoryPage::refreshDCSPeriods()
 {
-    m_chart->removeAllSeries();
+    fillPeriodCombo(m_dcsPeriodCombo, false);
+}
 
-    QString componentType = m_dcsComponentCombo->currentText();
+void HistoryPage::showDCSFigures()
+{
+    const TelemetryDcs &dcs = TelemetryDcs::instance();
+    m_dcsVersion = dcs.version();
+
+    // Selected period: a year is an int, a voyage its name
+    const QVariant period = m_dcsPeriodCombo->currentData();
+    DcsFigures figures;
+    qint64 fromMs = 0;
+    qint64 toMs = 0;
+    if (period.typeId() == QMetaType::Int) {
+        figures = dcs.year(period.toInt());
+        fromMs = QDateTime(QDate(period.toInt(), 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+        toMs = QDateTime(QDate(period.toInt() + 1, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    } else {
+        figures = dcs.voyage(period.toString());
+        fromMs = figures.firstMs;
+        toMs = figures.lastMs + 1;
+    }
 
-    if (componentType.contains("Main Engine")) {
-        // Create multiple series for different ME units
-        for (int me = 1; me <= 3; ++me) {
-            QLineSeries *series = new QLineSeries();
-            series->setName(QString("ME-%1").arg(me));
+    QString fuelRows;
+    for (auto it = figures.fuelTonnes.constBegin(); it != figures.fuelTonnes.constEnd(); ++it) {
+        fuelRows += QString("<tr><td>Fuel consumed (%1)</td><td align=right>%2 t</td></tr>")
+                        .arg(it.key().toHtmlEscaped()).arg(it.value(), 0, 'f', 2);
+    }
+    const QString dateFormat("yyyy-MM-dd hh:mm");
+    m_dcsFigures->setText(QString(
+        "<table cellspacing=4>"
+        "<tr><td>Period covered</td><td align=right>%1 – %2 UTC</td></tr>"
+        "<tr><td>Distance sailed</td><td align=right>%3 nm</td></tr>"
+        "<tr><td>Hours underway</td><td align=right>%4 h</td></tr>"
+        "%5"
+        "<tr><td>Total fuel consumed</td><td align=right>%6 t</td></tr>"
+        "<tr><td>CO₂ emitted</td><td align=right>%7 t</td></tr>"
+        "</table>")
+        .arg(figures.isEmpty() ? QString("-") : QDateTime::fromMSecsSinceEpoch(figures.firstMs, Qt::UTC).toString(dateFormat))
+        .arg(figures.isEmpty() ? QString("-") : QDateTime::fromMSecsSinceEpoch(figures.lastMs, Qt::UTC).toString(dateFormat))
+        .arg(figures.distanceNm, 0, 'f', 1)
+        .arg(figures.hoursUnderway, 0, 'f', 1)
+        .arg(fuelRows)
+        .arg(figures.totalFuelTonnes(), 0, 'f', 2)
+        .arg(figures.co2Tonnes(), 0, 'f', 2));
+
+    // Cumulative fuel per type over the days of the period
+    m_chart->removeAllSeries();
 
-            QDateTime baseTime = QDateTime::currentDateTime().addSecs(-3600); // Last hour
-            for (int i = 0; i < 60; ++i) {
-                QDateTime time = baseTime.addSecs(i * 60); // Every minute
-                double temperature = 450 + me * 10 + QRandomGenerator::global()->bounded(-20, 20);
-                series->append(time.toMSecsSinceEpoch(), temperature);
+    QHash<QString, QLineSeries*> series;
+    QHash<QString, double> cumulative;
+    double maxTonnes = 0.0;
+    const QMap<qint64, DcsFigures> days = dcs.days(fromMs, toMs);
+    for (auto day = days.constBegin(); day != days.constEnd(); ++day) {
+        for (auto it = day.value().fuelTonnes.constBegin(); it != day.value().fuelTonnes.constEnd(); ++it) {
+            QLineSeries *&line = series[it.key()];
+            if (!line) {
+                line = new QLineSeries;
+                line->setName(it.key());
+                line->append(qreal(days.firstKey()), 0.0);
             }
-
-            m_chart->addSeries(series);
+            // A day's fuel is plotted at its end
+            double &total = cumulative[it.key()];
+            total += it.value();
+            line->append(qreal(day.key() + 24 * kHourMs), total);
+            maxTonnes = qMax(maxTonnes, total);
         }
-        m_chart->setTitle("Main Engine Temperature Monitoring");
     }
-    else if (componentType.contains("Auxiliary Engine")) {
-        QLineSeries *series = new QLineSeries();
-        series->setName("AE-1");
-
-        QDateTime baseTime = QDateTime::currentDateTime().addSecs(-3600);
-        for (int i = 0; i < 60; ++i) {
-            QDateTime time = baseTime.addSecs(i * 60);
-            double temperature = 380 + QRandomGenerator::global()->bounded(-15, 15);
-            series->append(time.toMSecsSinceEpoch(), temperature);
-        }
-
-        m_chart->addSeries(series);
-        m_chart->setTitle("Auxiliary Engine Temperature Monitoring");
+    for (QLineSeries *line : series) {
+        m_chart->addSeries(line);
+        line->attachAxis(m_dcsTimeAxis);
+        line->attachAxis(m_dcsFuelAxis);
     }
 
-    // Setup axes
-    m_chart->createDefaultAxes();
-
-    // Configure X-axis as DateTime
-    QDateTimeAxis *xAxis = new QDateTimeAxis;
-    xAxis->setFormat("hh:mm");
-    xAxis->setTitleText("Time");
-    xAxis->setTitleBrush(QBrush(Qt::white));
-    xAxis->setLabelsBrush(QBrush(Qt::white));
-    xAxis->setGridLineColor(QColor(100, 100, 100));
-
-    // Configure Y-axis
-    QValueAxis *yAxis = new QValueAxis;
-    yAxis->setTitleText("Temperature (°C)");
-    yAxis->setTitleBrush(QBrush(Qt::white));
-    yAxis->setLabelsBrush(QBrush(Qt::white));
-    yAxis->setGridLineColor(QColor(100, 100, 100));
-
-    m_chart->setAxisX(xAxis, m_chart->series().first());
-    m_chart->setAxisY(yAxis, m_chart->series().first());
+    if (days.isEmpty()) {
+        m_dcsTimeAxis->setRange(QDateTime::currentDateTimeUtc().addDays(-7), QDateTime::currentDateTimeUtc());
+    } else {
+        m_dcsTimeAxis->setRange(QDateTime::fromMSecsSinceEpoch(days.firstKey(), Qt::UTC),
+                                QDateTime::fromMSecsSinceEpoch(days.lastKey(), Qt::UTC).addDays(1));
+    }
+    m_dcsFuelAxis->setRange(0.0, maxTonnes > 0.0 ? maxTonnes * 1.1 : 1.0);
 }
 
 void HistoryPage::onNavigationSelectionChanged()
@@ -481,118 +890,354 @@ void HistoryPage::onNavigationSelectionChanged()
     ui->stackedWidget->setCurrentIndex(currentIndex);
 }
 
-void HistoryPage::onDCSComponentChanged()
+void HistoryPage::onDCSPeriodChanged()
+{
+    showDCSFigures();
+}
+
+TelemetryReport::Period HistoryPage::selectedReportPeriod() const
 {
-    generateDummyChartData();
+    TelemetryReport::Period period;
+    const QVariant data = m_reportPeriodCombo->currentData();
+    if (data.typeId() == QMetaType::Int)
+        period.year = data.toInt();
+    else
+        period.voyage = data.toString();
+    return period;
 }
 
 void HistoryPage::onReportSelectionChanged()
 {
-    QString reportPath = ":/reports/trial_cii_report.pdf";
+    const TelemetryReport::Type type = TelemetryReport::Type(m_reportCombo->currentData().toInt());
+    fillPeriodCombo(m_reportPeriodCombo, type == TelemetryReport::VoyageSummary);
+    if (m_reportPeriodCombo->count() == 0) {
+        m_pdfDocument->close();
+        m_reportStatus->setText("No voyages recorded yet");
+        return;
+    }
 
-    if (m_reportCombo->currentIndex()==0) {
-        reportPath = ":/reports/1.pdf";
-    } else if (m_reportCombo->currentIndex()==1) {
-        reportPath = ":/reports/2.pdf";
-    } else if (m_reportCombo->currentIndex()==2) {
-        reportPath = ":/reports/3.pdf";
-    } else if (m_reportCombo->currentIndex()==3) {
-        reportPath = ":/reports/4.pdf";
-    } else if (m_reportCombo->currentIndex()==4) {
-        reportPath = ":/reports/trial_cii_report.pdf";
+    // Cached reports open at once; others are rendered in the background
+    const QString path = m_reports->request(type, selectedReportPeriod());
+    if (path.isEmpty()) {
+        m_reportStatus->setText("Generating report...");
+        return;
     }
+    m_reportStatus->clear();
+    m_pdfDocument->load(path);
+}
 
-    m_pdfDocument->load(reportPath);
+void HistoryPage::onReportReady(int type, const QString& periodKey, const QString& path)
+{
+    // Only the report still selected is shown
+    if (type != m_reportCombo->currentData().toInt() || periodKey != selectedReportPeriod().key())
+        return;
+    m_reportStatus->clear();
+    m_pdfDocument->load(path);
 }
 
-void HistoryPage::updateDCSChart()
+void HistoryPage::onReportFailed(int type, const QString& periodKey, const QString& message)
 {
-    // Add new data point to existing series
-    for (QAbstractSeries *series : m_chart->series()) {
-        QLineSeries *lineSeries = qobject_cast<QLineSeries*>(series);
-        if (lineSeries) {
-            // Remove oldest point if we have too many
-            if (lineSeries->count() > 60) {
-                lineSeries->remove(0);
-            }
+    if (type != m_reportCombo->currentData().toInt() || periodKey != selectedReportPeriod().key())
+        return;
+    m_reportStatus->setText("Report failed: " + message);
+}
 
-            // Add new point
-            QDateTime currentTime = QDateTime::currentDateTime();
-            QString seriesName = lineSeries->name();
-            double baseTemp = seriesName.contains("ME-1") ? 460 :
-                             seriesName.contains("ME-2") ? 470 :
-                             seriesName.contains("ME-3") ? 480 : 380;
-            double newTemp = baseTemp + QRandomGenerator::global()->bounded(-20, 20);
+void HistoryPage::updateDCSChart()
+{
+    if (TelemetryDcs::instance().version() == m_dcsVersion)
+        return;
+    refreshDCSPeriods();
+    showDCSFigures();
+}
 
-            lineSeries->append(currentTime.toMSecsSinceEpoch(), newTemp);
-        }
+void HistoryPage::prefillLiveFuel()
+{
+    // Minute means from the rollups cover the day before the page existed
+    const qint64 toMs = QDateTime::currentMSecsSinceEpoch();
+    const qint64 fromMs = toMs - kLiveWindowMs;
+    for (int slot = 0; slot < 16; ++slot) {
+        const QVector<RollupBucket> buckets = TelemetryRollups::instance().query(
+            TelemetryChannel::FuelConsumptionRate, slot, fromMs, toMs, kMinuteMs);
+        if (buckets.isEmpty())
+            continue;
+        StreamingSeries *series = m_liveFuel->series(QString("ME-%1").arg(slot + 1));
+        for (const RollupBucket &bucket : buckets)
+            series->push(bucket.startMs, bucket.value.mean());
     }
 }
 
-// HeatMapCell implementation
-HeatMapCell::HeatMapCell(const QString &time, const QString &date,
-                        double emission, double power, double saving, QWidget *parent)
-    : QFrame(parent), m_time(time), m_date(date), m_emission(emission),
-      m_power(power), m_saving(saving)
+void HistoryPage::onFrameUpdated(const TelemetryFrame& frame)
 {
-    setFrameStyle(QFrame::Box);
-    setLineWidth(1);
-    setCursor(Qt::PointingHandCursor);
+    // Replayed history is not live; recovered frames are older than the
+    // series' newest sample and are dropped by it
+    if (!m_liveFuel || MockApiService::instance()->isReplaying())
+        return;
+
+    const TelemetryFrame::Propulsion &propulsion = frame.propulsion;
+    for (int slot = 0; slot < propulsion.size(); ++slot)
+        m_liveFuel->push(QString("ME-%1").arg(slot + 1), frame.timestampMs,
+                         propulsion.fuelConsumptionRate.at(slot));
+}
+
+// ------------------- EmissionHeatMap -------------------
+
+namespace {
+
+const int kLabelWidth = 80;
+const int kHeaderHeight = 25;
+const int kMinCellWidth = 35;
+const int kRowHeight = 25;          // up to a month
+const int kCompactRowHeight = 14;   // longer periods
 
-    QString tooltip = QString("Time: %1\nDate: %2\nEmission: %3 MWh\nPower: %4 MW\nSaving: %5%")
-                     .arg(m_time).arg(m_date).arg(m_emission, 0, 'f', 1)
-                     .arg(m_power, 0, 'f', 1).arg(m_saving, 0, 'f', 1);
-    setToolTip(tooltip);
+} // namespace
+
+EmissionHeatMap::EmissionHeatMap(QWidget *parent)
+    : QWidget(parent),
+    m_days(0),
+    m_hovered(-1),
+    m_mediumFrom(0.0),
+    m_highFrom(0.0),
+    m_criticalFrom(0.0)
+{
+    setMouseTracking(true);
+    setAttribute(Qt::WA_OpaquePaintEvent);
 }
 
-void HeatMapCell::paintEvent(QPaintEvent *event)
+void EmissionHeatMap::setDays(const QDate &firstDay, int days)
 {
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    m_firstDay = firstDay;
+    m_days = qMax(0, days);
+    m_hours = QVector<Hour>(m_days * 24);
+    m_hovered = -1;
+    updateGeometry();
+    render();
+    update();
+}
+
+void EmissionHeatMap::setHour(int day, int hour, double emission, double power, double saving)
+{
+    if (day < 0 || day >= m_days || hour < 0 || hour >= 24)
+        return;
+
+    const int index = day * 24 + hour;
+    Hour &cell = m_hours[index];
+    if (cell.present && cell.emission == emission && cell.power == power && cell.saving == saving)
+        return;
+    cell.emission = emission;
+    cell.power = power;
+    cell.saving = saving;
+    cell.present = true;
+
+    if (m_image.isNull())
+        return;
+    QPainter painter(&m_image);
+    renderCell(painter, index);
+    update(cellRect(day, hour));
+}
+
+void EmissionHeatMap::setThresholds(double medium, double high, double critical)
+{
+    if (medium == m_mediumFrom && high == m_highFrom && critical == m_criticalFrom)
+        return;
+    m_mediumFrom = medium;
+    m_highFrom = high;
+    m_criticalFrom = critical;
+    render();
+    update();
+}
 
-    QColor bgColor = getColorForEmission(m_emission);
-    painter.fillRect(rect(), bgColor);
+QSize EmissionHeatMap::sizeHint() const
+{
+    return minimumSizeHint();
+}
 
-    QFrame::paintEvent(event);
+QSize EmissionHeatMap::minimumSizeHint() const
+{
+    const int rowMin = m_days > 31 ? kCompactRowHeight : kRowHeight;
+    return QSize(kLabelWidth + 24 * kMinCellWidth, kHeaderHeight + m_days * rowMin);
 }
 
-void HeatMapCell::enterEvent(QEnterEvent *event)
+QColor EmissionHeatMap::colorForEmission(double emission) const
 {
-    setStyleSheet("border: 2px solid #34A853;");
-    QFrame::enterEvent(event);
+    if (emission < m_mediumFrom) return QColor(46, 125, 50);        // Green (Low)
+    else if (emission < m_highFrom) return QColor(251, 192, 45);    // Yellow (Medium)
+    else if (emission < m_criticalFrom) return QColor(245, 124, 0); // Orange (High)
+    else return QColor(211, 47, 47);                                // Red (Critical)
 }
 
-void HeatMapCell::leaveEvent(QEvent *event)
+int EmissionHeatMap::rowHeight() const
 {
-    setStyleSheet("border: 1px solid #555555;");
-    QFrame::leaveEvent(event);
+    // Short periods stretch to fill the view; long ones scroll
+    const int rowMin = m_days > 31 ? kCompactRowHeight : kRowHeight;
+    if (m_days == 0)
+        return rowMin;
+    return qMax(rowMin, (height() - kHeaderHeight) / m_days);
 }
 
-void HeatMapCell::mousePressEvent(QMouseEvent *event)
+QRect EmissionHeatMap::cellRect(int day, int hour) const
 {
-    if (event->button() == Qt::LeftButton) {
-        showDetails();
+    const double cellWidth = (width() - kLabelWidth) / 24.0;
+    const int left = kLabelWidth + qRound(hour * cellWidth);
+    const int right = kLabelWidth + qRound((hour + 1) * cellWidth);
+    const int top = kHeaderHeight + day * rowHeight();
+    return QRect(left, top, right - left, rowHeight());
+}
+
+int EmissionHeatMap::cellAt(const QPoint &pos) const
+{
+    if (pos.x() < kLabelWidth || pos.y() < kHeaderHeight || width() <= kLabelWidth)
+        return -1;
+    const int hour = int((pos.x() - kLabelWidth) * 24.0 / (width() - kLabelWidth));
+    const int day = (pos.y() - kHeaderHeight) / rowHeight();
+    if (hour < 0 || hour >= 24 || day < 0 || day >= m_days)
+        return -1;
+    return day * 24 + hour;
+}
+
+QString EmissionHeatMap::timeText(int hour) const
+{
+    return QString("%1:00").arg(hour, 2, 10, QChar('0'));
+}
+
+QString EmissionHeatMap::dateText(int day) const
+{
+    return m_firstDay.addDays(day).toString("d MMM yy");
+}
+
+void EmissionHeatMap::render()
+{
+    if (width() <= 0 || height() <= 0) {
+        m_image = QImage();
+        return;
+    }
+
+    const qreal dpr = devicePixelRatioF();
+    m_image = QImage(size() * dpr, QImage::Format_RGB32);
+    m_image.setDevicePixelRatio(dpr);
+    m_image.fill(QColor(43, 43, 43));
+
+    QPainter painter(&m_image);
+    QFont labelFont = font();
+    labelFont.setPointSizeF(m_days > 31 ? 8 : 10);
+    painter.setFont(labelFont);
+
+    // Hour header and date column
+    for (int hour = 0; hour < 24; ++hour) {
+        const QRect cell = cellRect(0, hour);
+        const QRect header(cell.left(), 0, cell.width(), kHeaderHeight);
+        painter.fillRect(header, QColor(51, 51, 51));
+        painter.setPen(QColor(85, 85, 85));
+        painter.drawRect(header.adjusted(0, 0, -1, -1));
+        painter.setPen(Qt::white);
+        painter.drawText(header, Qt::AlignCenter, timeText(hour));
+    }
+    for (int day = 0; day < m_days; ++day) {
+        const QRect label(0, cellRect(day, 0).top(), kLabelWidth - 2, rowHeight());
+        painter.fillRect(label, QColor(51, 51, 51));
+        painter.setPen(QColor(85, 85, 85));
+        painter.drawRect(label.adjusted(0, 0, -1, -1));
+        painter.setPen(Qt::white);
+        painter.drawText(label, Qt::AlignCenter, dateText(day));
+    }
+
+    for (int index = 0; index < m_hours.size(); ++index)
+        renderCell(painter, index);
+}
+
+void EmissionHeatMap::renderCell(QPainter &painter, int index)
+{
+    const Hour &cell = m_hours.at(index);
+    const QRect rect = cellRect(index / 24, index % 24);
+    painter.fillRect(rect, cell.present ? colorForEmission(cell.emission) : QColor(60, 60, 60));
+    painter.setPen(QColor(85, 85, 85));
+    painter.drawRect(rect.adjusted(0, 0, -1, -1));
+}
+
+bool EmissionHeatMap::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        QHelpEvent *help = static_cast<QHelpEvent*>(event);
+        const int index = cellAt(help->pos());
+        if (index < 0 || !m_hours.at(index).present) {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+        const Hour &cell = m_hours.at(index);
+        QToolTip::showText(help->globalPos(),
+                           QString("Time: %1\nDate: %2\nEmission: %3 t CO₂/h\nPower: %4 MW\nSaving: %5%")
+                           .arg(timeText(index % 24)).arg(dateText(index / 24))
+                           .arg(cell.emission, 0, 'f', 2).arg(cell.power, 0, 'f', 1).arg(cell.saving, 0, 'f', 1),
+                           this, cellRect(index / 24, index % 24));
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+void EmissionHeatMap::paintEvent(QPaintEvent *event)
+{
+    if (m_image.isNull())
+        render();
+
+    QPainter painter(this);
+    const QRect exposed = event->rect();
+    painter.drawImage(exposed, m_image, QRectF(QPointF(exposed.topLeft()) * m_image.devicePixelRatio(),
+                                               QSizeF(exposed.size()) * m_image.devicePixelRatio()));
+
+    if (m_hovered >= 0) {
+        const QRect rect = cellRect(m_hovered / 24, m_hovered % 24);
+        if (rect.intersects(exposed)) {
+            painter.setPen(QPen(QColor(52, 168, 83), 2));
+            painter.drawRect(rect.adjusted(1, 1, -1, -1));
+        }
+    }
+}
+
+void EmissionHeatMap::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    m_image = QImage();
+}
+
+void EmissionHeatMap::mouseMoveEvent(QMouseEvent *event)
+{
+    const int index = cellAt(event->position().toPoint());
+    if (index != m_hovered) {
+        if (m_hovered >= 0)
+            update(cellRect(m_hovered / 24, m_hovered % 24));
+        m_hovered = index;
+        if (m_hovered >= 0)
+            update(cellRect(m_hovered / 24, m_hovered % 24));
+        setCursor(index >= 0 ? Qt::PointingHandCursor : Qt::ArrowCursor);
     }
-    QFrame::mousePressEvent(event);
+    QWidget::mouseMoveEvent(event);
 }
 
-void HeatMapCell::showDetails()
+void EmissionHeatMap::leaveEvent(QEvent *event)
 {
-    EmissionDetailsDialog dialog(m_time, m_date, m_emission, m_power, m_saving, this);
-    dialog.exec();
+    if (m_hovered >= 0)
+        update(cellRect(m_hovered / 24, m_hovered % 24));
+    m_hovered = -1;
+    QWidget::leaveEvent(event);
 }
 
-QColor HeatMapCell::getColorForEmission(double emission)
+void EmissionHeatMap::mousePressEvent(QMouseEvent *event)
 {
-    if (emission < 60) return QColor(46, 125, 50);      // Green (Low)
-    else if (emission < 75) return QColor(251, 192, 45); // Yellow (Medium)
-    else if (emission < 90) return QColor(245, 124, 0);  // Orange (High)
-    else return QColor(211, 47, 47);                     // Red (Critical)
+    const int index = cellAt(event->position().toPoint());
+    if (event->button() == Qt::LeftButton && index >= 0 && m_hours.at(index).present) {
+        const Hour &cell = m_hours.at(index);
+        EmissionDetailsDialog dialog(timeText(index % 24), dateText(index / 24),
+                                     cell.emission, cell.power, cell.saving,
+                                     m_highFrom, m_criticalFrom, this);
+        dialog.exec();
+    }
+    QWidget::mousePressEvent(event);
 }
 
 // EmissionDetailsDialog implementation
 EmissionDetailsDialog::EmissionDetailsDialog(const QString &time, const QString &date,
                                            double emission, double power, double saving,
+                                           double highFrom, double criticalFrom,
                                            QWidget *parent)
     : QDialog(parent)
 {
@@ -610,22 +1255,26 @@ EmissionDetailsDialog::EmissionDetailsDialog(const QString &time, const QString
     detailsText->setReadOnly(true);
     detailsText->setStyleSheet("background-color: #4F4F4F; border: 1px solid #666666; padding: 10px;");
 
+    // No per-hour limit exists in the regulations; the hour is placed
+    // within the period shown on the heat map instead
     QString details = QString(
         "<b>Time:</b> %1<br>"
         "<b>Date:</b> %2<br><br>"
-        "<b>Carbon Emission:</b> %3 MWh<br>"
-        "<b>Power Consumption:</b> %4 MW<br>"
-        "<b>Saving Impact:</b> %5%<br><br>"
-        "<b>Planned Target:</b> 82.0 MWh<br>"
-        "<b>Emission Limit:</b> 95.0 MWh<br>"
-        "<b>Status:</b> %6"
+        "<b>Carbon Emission:</b> %3 t CO₂/h<br>"
+        "<b>Power Output:</b> %4 MW<br>"
+        "<b>Below Period Mean:</b> %5%<br><br>"
+        "<b>Period 75th Percentile:</b> %6 t CO₂/h<br>"
+        "<b>Period 95th Percentile:</b> %7 t CO₂/h<br>"
+        "<b>Status:</b> %8"
     ).arg(time).arg(date)
-     .arg(emission, 0, 'f', 1)
+     .arg(emission, 0, 'f', 2)
      .arg(power, 0, 'f', 1)
      .arg(saving, 0, 'f', 1)
-     .arg(emission > 95 ? "<span style='color: #D32F2F;'>Over Limit</span>" :
-          emission > 82 ? "<span style='color: #F57C00;'>Above Target</span>" :
-          "<span style='color: #2E7D32;'>Within Target</span>");
+     .arg(highFrom, 0, 'f', 2)
+     .arg(criticalFrom, 0, 'f', 2)
+     .arg(emission >= criticalFrom ? "<span style='color: #D32F2F;'>Among the period's highest</span>" :
+          emission >= highFrom ? "<span style='color: #F57C00;'>Above typical</span>" :
+          "<span style='color: #2E7D32;'>Typical or below</span>");
 
     detailsText->setHtml(details);
     layout->addWidget(detailsText);
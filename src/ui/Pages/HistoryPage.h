@@ -26,7 +26,13 @@
 #include <QPdfView>
 #include <QPdfDocument>
 #include <QDateTime>
+#include <QDateTimeEdit>
+#include <QSlider>
 #include <QRandomGenerator>
+#include "../../service/TelemetryReport.h"
+#include "../StreamingSeries.h"
+
+struct TelemetryFrame;
 
 QT_USE_NAMESPACE
 
@@ -34,31 +40,63 @@ namespace Ui {
 class HistoryPage;
 }
 
-// Custom widget for heat map cells
-class HeatMapCell : public QFrame
+// Hourly emission heat map, one row per day, painted as a single widget.
+// The grid is rendered once into a cached image; a changed hour repaints
+// its own cell only, and hover, tooltips and clicks are hit-tested from
+// the mouse position, so a year of hours costs no more than a week.
+class EmissionHeatMap : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit HeatMapCell(const QString &time, const QString &date,
-                        double emission, double power, double saving, QWidget *parent = nullptr);
+    explicit EmissionHeatMap(QWidget *parent = nullptr);
+
+    // Clears the map to days rows starting at firstDay
+    void setDays(const QDate &firstDay, int days);
+    // Repaints the cell if the values differ from what it shows
+    void setHour(int day, int hour, double emission, double power, double saving);
+    // Emission (t CO2/h) at which Medium, High and Critical start
+    void setThresholds(double medium, double high, double critical);
+
+    QDate firstDay() const { return m_firstDay; }
+    int dayCount() const { return m_days; }
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+    QColor colorForEmission(double emission) const;
 
 protected:
+    bool event(QEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
-    void enterEvent(QEnterEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
     void leaveEvent(QEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
 
-private slots:
-    void showDetails();
-
 private:
-    QString m_time;
-    QString m_date;
-    double m_emission;
-    double m_power;
-    double m_saving;
-    QColor getColorForEmission(double emission);
+    struct Hour {
+        double emission = 0.0;
+        double power = 0.0;
+        double saving = 0.0;
+        bool present = false;
+    };
+
+    int rowHeight() const;
+    QRect cellRect(int day, int hour) const;
+    int cellAt(const QPoint &pos) const;            // day * 24 + hour, or -1
+    QString timeText(int hour) const;
+    QString dateText(int day) const;
+    void render();
+    void renderCell(QPainter &painter, int index);
+
+    QDate m_firstDay;
+    int m_days;
+    QVector<Hour> m_hours;      // m_days * 24, row-major
+    QImage m_image;             // the whole grid, labels included
+    int m_hovered;
+    double m_mediumFrom;
+    double m_highFrom;
+    double m_criticalFrom;
 };
 
 // Details dialog for heat map cells
@@ -69,6 +107,7 @@ class EmissionDetailsDialog : public QDialog
 public:
     explicit EmissionDetailsDialog(const QString &time, const QString &date,
                                  double emission, double power, double saving,
+                                 double highFrom, double criticalFrom,
                                  QWidget *parent = nullptr);
 };
 
@@ -82,9 +121,20 @@ public:
 
 private slots:
     void onNavigationSelectionChanged();
-    void onDCSComponentChanged();
+    void onDCSPeriodChanged();
+    void onHeatMapRangeChanged();
     void onReportSelectionChanged();
+    void onReportReady(int type, const QString& periodKey, const QString& path);
+    void onReportFailed(int type, const QString& periodKey, const QString& message);
     void updateDCSChart();
+    void onFrameUpdated(const TelemetryFrame& frame);
+    void onReplayStartStop();
+    void onReplayPlayPause();
+    void onReplaySliderReleased();
+    void onReplaySpeedChanged(int index);
+    void onReplayingChanged(bool replaying);
+    void onReplayPositionChanged(qint64 positionMs);
+    void onReplayPlayingChanged(bool playing);
 
 private:
     void setupNavigationAndContent();
@@ -92,27 +142,57 @@ private:
     void setupHistoricalPage();
     void setupReportPage();
     void createHeatMapGrid();
+    void refreshHeatMap();
     QWidget* createDCSPage();
     QWidget* createHistoricalPage();
     QWidget* createReportPage();
-    void generateDummyChartData();
+    QWidget* createReplayControls();
+    TelemetryReport::Period selectedReportPeriod() const;
+    void fillPeriodCombo(QComboBox* combo, bool voyagesOnly);
+    void refreshDCSPeriods();
+    void showDCSFigures();
+    void prefillLiveFuel();
 
     Ui::HistoryPage *ui;
 
     // DCS related
-    QComboBox *m_dcsComponentCombo;
+    QComboBox *m_dcsPeriodCombo;
+    QLabel *m_dcsFigures;
     QChartView *m_chartView;
     QChart *m_chart;
+    QDateTimeAxis *m_dcsTimeAxis;
+    QValueAxis *m_dcsFuelAxis;
     QTimer *m_updateTimer;
+    quint64 m_dcsVersion;       // TelemetryDcs version last shown
+    QChartView *m_liveChartView;
+    QChart *m_liveChart;
+    StreamingChart *m_liveFuel; // ME fuel rate over the last 24 h
 
     // Report related
     QComboBox *m_reportCombo;
+    QComboBox *m_reportPeriodCombo;
+    QLabel *m_reportStatus;
+    TelemetryReport *m_reports;
     QPdfView *m_pdfView;
     QPdfDocument *m_pdfDocument;
 
     // Heat map related
-    QGridLayout *m_heatMapLayout;
+    QComboBox *m_heatMapRangeCombo;
+    EmissionHeatMap *m_heatMap;
     QScrollArea *m_heatMapScrollArea;
+    QList<QLabel*> m_heatMapLegend; // Low, Medium, High, Critical
+    double m_heatMapMeanEmission;   // saving is measured against this
+    bool m_heatMapSample;           // showing sample data, no history yet
+
+    // Replay of recorded history, driving every page while it runs
+    QDateTimeEdit *m_replayFrom;
+    QDateTimeEdit *m_replayTo;
+    QPushButton *m_replayStartButton;
+    QPushButton *m_replayPlayButton;
+    QPushButton *m_replayStepButton;
+    QComboBox *m_replaySpeedCombo;
+    QSlider *m_replaySlider;        // seconds from the replay's start
+    QLabel *m_replayPosition;
 };
 
 #endif // HISTORYPAGE_H
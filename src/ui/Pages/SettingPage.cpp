@@ -1,6 +1,8 @@
 #include "SettingPage.h"
 #include "ui_SettingPage.h"
 #include <QMessageBox>
+#include <QSettings>
+#include "../../service/MockApiService.h"
 
 SettingPage::SettingPage(QWidget *parent)
     : QWidget(parent)
@@ -46,6 +48,7 @@ void SettingPage::setupUI()
     contentLayout->addWidget(createIoTGroup());
     contentLayout->addWidget(createAIGroup());
     contentLayout->addWidget(createDisplayGroup());
+    contentLayout->addWidget(createDiagnosticsGroup());
 
     contentLayout->addStretch();
 
@@ -82,7 +85,7 @@ QGroupBox* SettingPage::createGeneralGroup()
     QLabel *shipNameLabel = new QLabel("Ship Name:", group);
     shipNameEdit = new QLineEdit(group);
     shipNameEdit->setPlaceholderText("Enter ship name");
-    shipNameEdit->setText("MV Example");
+    shipNameEdit->setText(QSettings().value("vessel/name", "MV Example").toString());
     shipNameEdit->setMinimumHeight(35);
     layout->addWidget(shipNameLabel);
     layout->addWidget(shipNameEdit);
@@ -91,7 +94,7 @@ QGroupBox* SettingPage::createGeneralGroup()
     QLabel *imoLabel = new QLabel("IMO Number:", group);
     imoNumberEdit = new QLineEdit(group);
     imoNumberEdit->setPlaceholderText("Enter IMO number");
-    imoNumberEdit->setText("IMO 1234567");
+    imoNumberEdit->setText(QSettings().value("vessel/imo", "IMO 1234567").toString());
     imoNumberEdit->setMinimumHeight(35);
     layout->addWidget(imoLabel);
     layout->addWidget(imoNumberEdit);
@@ -101,10 +104,21 @@ QGroupBox* SettingPage::createGeneralGroup()
     shipTypeCombo = new QComboBox(group);
     shipTypeCombo->addItems({"Container Ship", "Bulk Carrier", "Tanker",
                              "LNG Carrier", "General Cargo", "Ro-Ro"});
+    shipTypeCombo->setCurrentText(QSettings().value("vessel/type", "Container Ship").toString());
     shipTypeCombo->setMinimumHeight(35);
     layout->addWidget(typeLabel);
     layout->addWidget(shipTypeCombo);
 
+    // Deadweight: the capacity CII reports are computed with
+    QLabel *deadweightLabel = new QLabel("Deadweight (t):", group);
+    deadweightSpin = new QSpinBox(group);
+    deadweightSpin->setRange(100, 600000);
+    deadweightSpin->setSingleStep(1000);
+    deadweightSpin->setValue(QSettings().value("vessel/deadweight", 50000).toInt());
+    deadweightSpin->setMinimumHeight(35);
+    layout->addWidget(deadweightLabel);
+    layout->addWidget(deadweightSpin);
+
     return group;
 }
 
@@ -118,7 +132,7 @@ QGroupBox* SettingPage::createIoTGroup()
     QLabel *serverLabel = new QLabel("IoT Server Address:", group);
     iotServerEdit = new QLineEdit(group);
     iotServerEdit->setPlaceholderText("e.g., iot.eeship.com");
-    iotServerEdit->setText("iot.eeship.com");
+    iotServerEdit->setText(QSettings().value("iot/server", "iot.eeship.com").toString());
     iotServerEdit->setMinimumHeight(35);
     layout->addWidget(serverLabel);
     layout->addWidget(iotServerEdit);
@@ -127,7 +141,7 @@ QGroupBox* SettingPage::createIoTGroup()
     QLabel *portLabel = new QLabel("Server Port:", group);
     iotPortSpin = new QSpinBox(group);
     iotPortSpin->setRange(1, 65535);
-    iotPortSpin->setValue(8883);
+    iotPortSpin->setValue(QSettings().value("iot/port", 8883).toInt());
     iotPortSpin->setMinimumHeight(35);
     layout->addWidget(portLabel);
     layout->addWidget(iotPortSpin);
@@ -198,6 +212,53 @@ QGroupBox* SettingPage::createDisplayGroup()
     return group;
 }
 
+QGroupBox* SettingPage::createDiagnosticsGroup()
+{
+    QGroupBox *group = new QGroupBox("Link Diagnostics", this);
+    QVBoxLayout *layout = new QVBoxLayout(group);
+    layout->setSpacing(12);
+
+    // Latency histograms kept by the API service since start-up
+    rttLabel = new QLabel(group);
+    parseLabel = new QLabel(group);
+    queueDelayLabel = new QLabel(group);
+    pollPeriodLabel = new QLabel(group);
+    for (QLabel *label : { rttLabel, parseLabel, queueDelayLabel, pollPeriodLabel }) {
+        label->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        layout->addWidget(label);
+    }
+
+    diagnosticsTimer = new QTimer(this);
+    diagnosticsTimer->setInterval(2000);
+    connect(diagnosticsTimer, &QTimer::timeout, this, &SettingPage::refreshDiagnostics);
+
+    return group;
+}
+
+void SettingPage::refreshDiagnostics()
+{
+    MockApiService *api = MockApiService::instance();
+    rttLabel->setText("Request round trip: " + api->rttHistogram().summary());
+    parseLabel->setText("Decode on worker: " + api->parseHistogram().summary());
+    queueDelayLabel->setText("Decoder queue wait: " + api->queueDelayHistogram().summary());
+    pollPeriodLabel->setText(QString("Poll period: %1 ms (planned %2 ms)")
+                                 .arg(api->effectiveIntervalMs())
+                                 .arg(api->plannedIntervalMs()));
+}
+
+void SettingPage::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refreshDiagnostics();
+    diagnosticsTimer->start();
+}
+
+void SettingPage::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    diagnosticsTimer->stop();
+}
+
 void SettingPage::applyDarkTheme()
 {
     // Main widget background
@@ -432,7 +493,23 @@ void SettingPage::applyDarkTheme()
 
 void SettingPage::onSaveSettings()
 {
-    // Dummy implementation - in real app, save to QSettings or config file
+    // Vessel particulars and the IoT connection are persisted and applied
+    // immediately; the rest is still a preview
+    QSettings settings;
+    settings.setValue("vessel/name", shipNameEdit->text().trimmed());
+    settings.setValue("vessel/imo", imoNumberEdit->text().trimmed());
+    settings.setValue("vessel/type", shipTypeCombo->currentText());
+    settings.setValue("vessel/deadweight", deadweightSpin->value());
+    settings.setValue("iot/server", iotServerEdit->text().trimmed());
+    settings.setValue("iot/port", iotPortSpin->value());
+
+    if (!iotServerEdit->text().trimmed().isEmpty()) {
+        MockApiService::instance()->startStreaming(iotServerEdit->text().trimmed(),
+                                                   static_cast<quint16>(iotPortSpin->value()));
+    } else {
+        MockApiService::instance()->stopStreaming();
+    }
+
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("Settings Saved");
     msgBox.setText("Settings have been saved successfully!");
@@ -466,6 +543,7 @@ void SettingPage::onResetSettings()
     shipNameEdit->setText("MV Example");
     imoNumberEdit->setText("IMO 1234567");
     shipTypeCombo->setCurrentIndex(0);
+    deadweightSpin->setValue(50000);
     iotServerEdit->setText("iot.eeship.com");
     iotPortSpin->setValue(8883);
     updateIntervalSpin->setValue(30);
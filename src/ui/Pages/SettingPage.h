@@ -12,6 +12,7 @@
 #include <QCheckBox>
 #include <QPushButton>
 #include <QScrollArea>
+#include <QTimer>
 
 namespace Ui {
 class SettingPage;
@@ -25,9 +26,14 @@ public:
     explicit SettingPage(QWidget *parent = nullptr);
     ~SettingPage();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
 private slots:
     void onSaveSettings();
     void onResetSettings();
+    void refreshDiagnostics();
 
 private:
     Ui::SettingPage *ui;
@@ -41,6 +47,7 @@ private:
     QLineEdit *shipNameEdit;
     QLineEdit *imoNumberEdit;
     QComboBox *shipTypeCombo;
+    QSpinBox *deadweightSpin;
 
     // IoT Settings
     QLineEdit *iotServerEdit;
@@ -56,6 +63,13 @@ private:
     QComboBox *languageCombo;
     QComboBox *unitSystemCombo;
 
+    // Link diagnostics, refreshed while the page is visible
+    QLabel *rttLabel;
+    QLabel *parseLabel;
+    QLabel *queueDelayLabel;
+    QLabel *pollPeriodLabel;
+    QTimer *diagnosticsTimer;
+
     // Buttons
     QPushButton *saveButton;
     QPushButton *resetButton;
@@ -66,6 +80,7 @@ private:
     QGroupBox* createIoTGroup();
     QGroupBox* createAIGroup();
     QGroupBox* createDisplayGroup();
+    QGroupBox* createDiagnosticsGroup();
 };
 
 #endif // SETTINGPAGE_H
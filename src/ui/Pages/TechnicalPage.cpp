@@ -17,11 +17,16 @@
 #include <QBrush>
 #include <QRandomGenerator>
 #include <QMessageBox>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QtNumeric>
 #include <QScrollArea>
 #include "CircleProgressBar.h"
 #include "SpeedometerWidget.h"
 #include "EngineStatusWidget.h"
 #include "PropulsionPIDWidget.h"
+#include "TrendChartView.h"
+#include "../../service/TelemetryQuery.h"
 
 TechnicalPage::TechnicalPage(QWidget *parent)
     : QWidget(parent)
@@ -38,13 +43,22 @@ TechnicalPage::TechnicalPage(QWidget *parent)
     , m_me2(new EngineStatusWidget("ME 2"))
     , m_me3(new EngineStatusWidget("ME 3"))
     , m_pidWidget(new PropulsionPIDWidget())
+    , m_trendQuery(new TelemetryQuery(this))
+    , m_egtBuffer(new StripChartBuffer(3, 10 * 60 * 10))
+    , m_egtChart(nullptr)
 {
     ui->setupUi(this);
 
-    connect(MockApiService::instance(), &MockApiService::dataUpdated,
-            this, &TechnicalPage::onDataUpdated);
+    // Only propulsion values are shown here, so quiet subsystems cost nothing
+    connect(MockApiService::instance(), &MockApiService::propulsionUpdated,
+            this, &TechnicalPage::onPropulsionUpdated);
 
-    MockApiService::instance()->startPolling(1, 5000);
+    MockApiService::instance()->subscribe(this, MockApiService::Propulsion, 5000);
+
+    // Every frame, not just the newest state, so the strip chart gets the
+    // stream's full rate
+    connect(MockApiService::instance(), &MockApiService::frameUpdated,
+            this, &TechnicalPage::onFrameUpdated);
 
     setupWidget();
     createPageContent();
@@ -52,6 +66,10 @@ TechnicalPage::TechnicalPage(QWidget *parent)
 
     // Set initial page
     setCurrentPage(PropulsionSystemPage);
+
+    // Deltas only carry changes; start from what the service already has
+    if (MockApiService::instance()->hasState())
+        onPropulsionUpdated(MockApiService::instance()->currentState().propulsion_logs);
 }
 
 TechnicalPage::~TechnicalPage()
@@ -118,15 +136,31 @@ void TechnicalPage::toggleHideShow_topContent(bool checked)
     }
 }
 
-void TechnicalPage::onDataUpdated(const VoyageLogs &data)
+void TechnicalPage::onFrameUpdated(const TelemetryFrame& frame)
+{
+    // Replayed history would jump the live strip chart back in time
+    if (MockApiService::instance()->isReplaying())
+        return;
+
+    const TelemetryFrame::Propulsion &propulsion = frame.propulsion;
+    QVector<double> temperatures(m_egtBuffer->channelCount(), qQNaN());
+    for (int slot = 0; slot < propulsion.size() && slot < temperatures.size(); ++slot)
+        temperatures[slot] = propulsion.exhaustGasTemp.at(slot);
+    m_egtBuffer->append(frame.timestampMs, temperatures);
+}
+
+void TechnicalPage::onPropulsionUpdated(const QList<PropulsionLog> &logs)
 {
+    if (logs.size() < 3)
+        return;
+
     // ======================
     // Extract ME1 data
     // ======================
-    int ME1Load = data.propulsion_logs[0].engine_load;
-    int ME1Rpm = data.propulsion_logs[0].rpm;
-    int ME1SFOC = data.propulsion_logs[0].fuel_consumption_rate;
-    int ME1Power = data.propulsion_logs[0].power_output;
+    int ME1Load = logs[0].engine_load;
+    int ME1Rpm = logs[0].rpm;
+    int ME1SFOC = logs[0].fuel_consumption_rate;
+    int ME1Power = logs[0].power_output;
 
     m_me1->setEfficiency(ME1Load);
     m_me1->setRunningHours(ME1Rpm);
@@ -144,10 +178,10 @@ void TechnicalPage::onDataUpdated(const VoyageLogs &data)
     // ======================
     // Extract ME2 data
     // ======================
-    int ME2Load = data.propulsion_logs[1].engine_load;
-    int ME2Rpm = data.propulsion_logs[1].rpm;
-    int ME2SFOC = data.propulsion_logs[1].fuel_consumption_rate;
-    int ME2Power = data.propulsion_logs[1].power_output;
+    int ME2Load = logs[1].engine_load;
+    int ME2Rpm = logs[1].rpm;
+    int ME2SFOC = logs[1].fuel_consumption_rate;
+    int ME2Power = logs[1].power_output;
 
     m_me2->setEfficiency(ME2Load);
     m_me2->setRunningHours(ME2Rpm);
@@ -165,10 +199,10 @@ void TechnicalPage::onDataUpdated(const VoyageLogs &data)
     // ======================
     // Extract ME3 data
     // ======================
-    int ME3Load = data.propulsion_logs[2].engine_load;
-    int ME3Rpm = data.propulsion_logs[2].rpm;
-    int ME3SFOC = data.propulsion_logs[2].fuel_consumption_rate;
-    int ME3Power = data.propulsion_logs[2].power_output;
+    int ME3Load = logs[2].engine_load;
+    int ME3Rpm = logs[2].rpm;
+    int ME3SFOC = logs[2].fuel_consumption_rate;
+    int ME3Power = logs[2].power_output;
 
     m_me3->setEfficiency(ME3Load);
     m_me3->setRunningHours(ME3Rpm);
@@ -790,88 +824,128 @@ void TechnicalPage::createPropulsionSystemPageContent_topContent()
     chart->setMargins(QMargins(0, 0, 0, 0));
     chart->setTitle(""); // Remove title
 
-    // Create chart view
-    QChartView* chartView = new QChartView(chart);
+    // Create chart view; zooming or panning fetches a window decimated to
+    // the plot width
+    TrendChartView* chartView = new TrendChartView(chart);
     chartView->setRenderHint(QPainter::Antialiasing);
     chartView->setMinimumHeight(200);
     chartView->setStyleSheet("background-color: transparent; border: none;"); // Remove frame
 
-    // Function to create sample data for different chart types
-    auto createSampleData = [](const QString& type) -> QLineSeries* {
-        QLineSeries* series = new QLineSeries();
+    // Sample curves for when the history is still empty, offset per engine
+    auto createSampleData = [](const QString& type, int engine) -> QList<QPointF> {
+        static const double powerOffset[] = { 0.0, -0.5, 0.3 };
+        static const double rpmOffset[] = { 0.0, -2.0, 1.0 };
+        static const double efficiencyOffset[] = { 0.0, -3.0, 2.0 };
+
+        QList<QPointF> points;
 
         // Generate sample data for the last 7 days
         QDateTime currentDate = QDateTime::currentDateTime();
-
-        if (type == "Power (kW)") {
-            series->setName("Engine Power");
-            series->setColor(QColor(40, 167, 69)); // Green
-            for (int i = 6; i >= 0; --i) {
-                QDateTime date = currentDate.addDays(-i);
+        for (int i = 6; i >= 0; --i) {
+            const qreal x = currentDate.addDays(-i).toMSecsSinceEpoch();
+            if (type == "Power (kW)") {
                 double power = 12.0 + (QRandomGenerator::global()->bounded(2000) - 1000) / 1000.0; // 11-13 (in thousands kW)
-                series->append(date.toMSecsSinceEpoch(), power);
-            }
-        } else if (type == "RPM") {
-            series->setName("Engine RPM");
-            series->setColor(QColor(0, 120, 212)); // Blue
-            for (int i = 6; i >= 0; --i) {
-                QDateTime date = currentDate.addDays(-i);
+                points.append(QPointF(x, power + powerOffset[engine]));
+            } else if (type == "RPM") {
                 double rpm = 125 + QRandomGenerator::global()->bounded(10) - 5; // 120-130 RPM
-                series->append(date.toMSecsSinceEpoch(), rpm);
-            }
-        } else { // Efficiency (%)
-            series->setName("Thermal Efficiency");
-            series->setColor(QColor(255, 193, 7)); // Yellow
-            for (int i = 6; i >= 0; --i) {
-                QDateTime date = currentDate.addDays(-i);
+                points.append(QPointF(x, rpm + rpmOffset[engine]));
+            } else { // Efficiency (%)
                 double efficiency = 40 + QRandomGenerator::global()->bounded(8); // 40-48%
-                series->append(date.toMSecsSinceEpoch(), efficiency);
+                points.append(QPointF(x, efficiency + efficiencyOffset[engine]));
             }
         }
+        return points;
+    };
 
-        return series;
+    // Min/max envelope of the visible span, about two points per pixel
+    // column, so a spike in months of 1 Hz samples still shows
+    QSharedPointer<QString> currentType = QSharedPointer<QString>::create();
+    QPointer<TrendChartView> view = chartView;
+    auto fetchTrend = [=](qint64 fromMs, qint64 toMs, int columns) {
+        // A query for the previous range is no longer wanted
+        m_trendQuery->cancelAll();
+        const QString type = *currentType;
+
+        TelemetryWindow window;
+        if (type == "RPM")
+            window.channel = TelemetryChannel::Rpm;
+        else if (type == "Power (kW)")
+            window.channel = TelemetryChannel::PowerOutput;
+        else
+            window.measure = TelemetryWindow::Sfoc;
+        window.equipment = { 0, 1, 2 };
+        window.fromMs = fromMs;
+        window.toMs = toMs;
+        window.bucketMs = TelemetryQuery::bucketForColumns(fromMs, toMs, columns);
+
+        QList<QPointer<QLineSeries>> targets;
+        for (QAbstractSeries *series : chart->series())
+            targets.append(qobject_cast<QLineSeries*>(series));
+        // Hours need a time of day once zoomed in
+        for (QAbstractAxis *axis : chart->axes(Qt::Horizontal)) {
+            if (QDateTimeAxis *timeAxis = qobject_cast<QDateTimeAxis*>(axis))
+                timeAxis->setFormat(toMs - fromMs > 2 * 24 * 3600 * qint64(1000) ? "MM/dd" : "MM/dd HH:mm");
+        }
+        const QList<QAbstractAxis*> verticalAxes = chart->axes(Qt::Vertical);
+        QPointer<QValueAxis> yAxis = verticalAxes.isEmpty() ? nullptr : qobject_cast<QValueAxis*>(verticalAxes.first());
+        m_trendQuery->submit(window, [=](const TelemetryWindowResult &result) {
+            double low = 0.0, high = 0.0;
+            bool any = false;
+            for (int i = 0; i < result.series.size() && i < targets.size(); ++i) {
+                if (!targets.at(i))
+                    continue;
+                targets.at(i)->replace(result.series.at(i).envelope);
+                for (const QPointF &point : result.series.at(i).envelope) {
+                    low = any ? qMin(low, point.y()) : point.y();
+                    high = any ? qMax(high, point.y()) : point.y();
+                    any = true;
+                }
+            }
+
+            // No history yet: keep showing the sample curves
+            if (!any) {
+                if (view && view->isHomeRange()) {
+                    for (int i = 0; i < targets.size(); ++i) {
+                        if (targets.at(i))
+                            targets.at(i)->replace(createSampleData(type, i));
+                    }
+                }
+                return;
+            }
+
+            if (yAxis) {
+                const double pad = qMax((high - low) * 0.1, 1.0);
+                yAxis->setRange(low - pad, high + pad);
+                if (type == "Power (kW)")
+                    yAxis->setLabelFormat("%.0f kW");
+                else if (type != "RPM")
+                    yAxis->setLabelFormat("%.0f g/kWh");
+            }
+        });
     };
+    connect(chartView, &TrendChartView::rangeSettled, this, fetchTrend);
 
     // Function to update chart data
     auto updateChart = [=](const QString& type) {
+        *currentType = type;
         chart->removeAllSeries();
+        const QList<QAbstractAxis*> oldAxes = chart->axes();
+        for (QAbstractAxis *axis : oldAxes) {
+            chart->removeAxis(axis);
+            delete axis;
+        }
 
         // Add three series for ME1, ME2, ME3
-        QLineSeries* me1Series = createSampleData(type);
-        QLineSeries* me2Series = createSampleData(type);
-        QLineSeries* me3Series = createSampleData(type);
+        QLineSeries* me1Series = new QLineSeries();
+        QLineSeries* me2Series = new QLineSeries();
+        QLineSeries* me3Series = new QLineSeries();
 
-        // Adjust names and colors for different engines
         me1Series->setName("ME 1");
         me1Series->setColor(QColor(40, 167, 69)); // Green
-
         me2Series->setName("ME 2");
         me2Series->setColor(QColor(0, 120, 212)); // Blue
-        // Slightly offset ME2 data
-        for (int i = 0; i < me2Series->count(); ++i) {
-            QPointF point = me2Series->at(i);
-            if (type == "Power (kW)") {
-                me2Series->replace(i, point.x(), point.y() - 0.5);
-            } else if (type == "RPM") {
-                me2Series->replace(i, point.x(), point.y() - 2);
-            } else {
-                me2Series->replace(i, point.x(), point.y() - 3);
-            }
-        }
-
         me3Series->setName("ME 3");
         me3Series->setColor(QColor(255, 193, 7)); // Yellow
-        // Slightly offset ME3 data
-        for (int i = 0; i < me3Series->count(); ++i) {
-            QPointF point = me3Series->at(i);
-            if (type == "Power (kW)") {
-                me3Series->replace(i, point.x(), point.y() + 0.3);
-            } else if (type == "RPM") {
-                me3Series->replace(i, point.x(), point.y() + 1);
-            } else {
-                me3Series->replace(i, point.x(), point.y() + 2);
-            }
-        }
 
         chart->addSeries(me1Series);
         chart->addSeries(me2Series);
@@ -885,7 +959,6 @@ void TechnicalPage::createPropulsionSystemPageContent_topContent()
         axisX->setLabelsColor(QColor(200, 200, 200));
         axisX->setGridLineColor(QColor(100, 100, 100));
         axisX->setFormat("MM/dd");
-        axisX->setRange(QDateTime::currentDateTime().addDays(-6), QDateTime::currentDateTime());
 
         QValueAxis* axisY = new QValueAxis();
         axisY->setTitleText(""); // Remove Y axis title
@@ -916,6 +989,13 @@ void TechnicalPage::createPropulsionSystemPageContent_topContent()
         me2Series->attachAxis(axisY);
         me3Series->attachAxis(axisX);
         me3Series->attachAxis(axisY);
+
+        // The last seven days to start with, at the plot's resolution
+        const qint64 homeToMs = QDateTime::currentMSecsSinceEpoch();
+        const qint64 homeFromMs = QDateTime::currentDateTime().addDays(-6).toMSecsSinceEpoch();
+        axisX->setRange(QDateTime::fromMSecsSinceEpoch(homeFromMs), QDateTime::fromMSecsSinceEpoch(homeToMs));
+        chartView->setTimeAxis(axisX, homeFromMs, homeToMs);
+        fetchTrend(homeFromMs, homeToMs, chartView->columns());
     };
 
     // Initialize chart with Power data (fixed to Power only since combo box is removed)
@@ -923,6 +1003,16 @@ void TechnicalPage::createPropulsionSystemPageContent_topContent()
 
     rightLayout->addWidget(chartView);
 
+    // Exhaust gas temperature, painted directly rather than through QtCharts
+    m_egtChart = new StripChart(m_egtBuffer);
+    m_egtChart->setChannel(0, "ME 1", QColor(40, 167, 69));
+    m_egtChart->setChannel(1, "ME 2", QColor(0, 120, 212));
+    m_egtChart->setChannel(2, "ME 3", QColor(255, 193, 7));
+    m_egtChart->setRange(250.0, 450.0);
+    m_egtChart->setUnit("°C");
+    m_egtChart->setFrameRate(10);
+    rightLayout->addWidget(m_egtChart);
+
     // Add all sections to main layout
     mainLayout->addLayout(leftLayout);
     mainLayout->addLayout(middleLayout);
@@ -8,6 +8,9 @@
 #include "../../service/MockApiService.h"
 #include "../EngineStatusWidget.h"
 #include "../PropulsionPIDWidget.h"
+#include "../StripChart.h"
+
+class TelemetryQuery;
 
 namespace Ui {
 class TechnicalPage;
@@ -40,7 +43,8 @@ public slots:
     void toggleHideShow_topContent(bool checked);
 
 private slots:
-    void onDataUpdated(const VoyageLogs& data);
+    void onPropulsionUpdated(const QList<PropulsionLog>& logs);
+    void onFrameUpdated(const TelemetryFrame& frame);
 
 private:
     void setupWidget();
@@ -103,6 +107,13 @@ private:
 
     PropulsionPIDWidget* m_pidWidget;
 
+    // ME 1-3 trend chart queries; the previous one is cancelled on redraw
+    TelemetryQuery* m_trendQuery;
+
+    // ME 1-3 exhaust gas temperature, last ten minutes at up to 10 Hz
+    QSharedPointer<StripChartBuffer> m_egtBuffer;
+    StripChart* m_egtChart;
+
     int m_currentPage;
 };
 
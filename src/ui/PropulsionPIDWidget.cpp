@@ -9,6 +9,7 @@
 #include <QDebug>
 #include <cmath>
 #include <QPainterPath>
+#include <QPaintEvent>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -24,11 +25,12 @@ PropulsionPIDWidget::PropulsionPIDWidget(QWidget *parent)
 {
     setMinimumSize(800, 400);
     setMouseTracking(true);
+    setAttribute(Qt::WA_OpaquePaintEvent);
 
-    // Setup animation timer
+    // Setup animation timer; it only runs while the widget is shown
     m_animationTimer = new QTimer(this);
+    m_animationTimer->setInterval(100); // 100ms interval for smooth animation
     connect(m_animationTimer, &QTimer::timeout, this, &PropulsionPIDWidget::updateAnimation);
-    m_animationTimer->start(100); // 100ms interval for smooth animation
 
     setupComponents();
     setupFlowLines();
@@ -101,6 +103,7 @@ void PropulsionPIDWidget::setupComponents()
     propeller.isActive = true;
     propeller.isHovered = false;
     m_components.append(propeller);
+    m_propellerRect = propeller.rect;
 }
 
 void PropulsionPIDWidget::setupFlowLines()
@@ -162,24 +165,68 @@ void PropulsionPIDWidget::setupFlowLines()
         exhaustLine.animationOffset = i * 8;
         m_flowLines.append(exhaustLine);
     }
+
+    // What moves: each line with its arrow head, and the blades' sweep
+    m_animatedRegion = QRegion();
+    for (const FlowLine &line : m_flowLines)
+        m_animatedRegion += QRect(line.start, line.end).normalized().adjusted(-10, -6, 6, 6);
+    m_animatedRegion += QRect(m_propellerRect.center() - QPoint(40, 40), QSize(81, 81));
 }
 
 void PropulsionPIDWidget::paintEvent(QPaintEvent *event)
 {
-    Q_UNUSED(event);
+    if (m_staticLayer.isNull())
+        renderStaticLayer();
 
     QPainter painter(this);
+    painter.setClipRegion(event->region());
     painter.setRenderHint(QPainter::Antialiasing);
     painter.setRenderHint(QPainter::TextAntialiasing);
 
     // Draw background
-    painter.fillRect(rect(), QColor(30, 30, 30));
+    painter.fillRect(event->rect(), QColor(30, 30, 30));
 
     // Draw flow lines first (behind components)
     for (const FlowLine &line : m_flowLines) {
-        drawFlowLine(painter, line);
+        if (event->region().intersects(QRect(line.start, line.end).normalized().adjusted(-10, -6, 6, 6)))
+            drawFlowLine(painter, line);
     }
 
+    // Components and legend, cached
+    painter.drawPixmap(event->rect(), m_staticLayer,
+                       QRectF(QPointF(event->rect().topLeft()) * m_staticLayer.devicePixelRatio(),
+                              QSizeF(event->rect().size()) * m_staticLayer.devicePixelRatio()));
+
+    // Propeller blades turn over the cached hub
+    if (event->region().intersects(m_animatedRegion)) {
+        for (const ComponentRect &comp : m_components) {
+            if (comp.type != Propeller)
+                continue;
+            painter.save();
+            painter.setPen(componentPen(comp));
+            drawPropellerBlades(painter, comp.rect);
+            painter.restore();
+        }
+    }
+}
+
+void PropulsionPIDWidget::invalidateStaticLayer()
+{
+    m_staticLayer = QPixmap();
+    update();
+}
+
+void PropulsionPIDWidget::renderStaticLayer()
+{
+    const qreal dpr = devicePixelRatioF();
+    m_staticLayer = QPixmap(size() * dpr);
+    m_staticLayer.setDevicePixelRatio(dpr);
+    m_staticLayer.fill(Qt::transparent);
+
+    QPainter painter(&m_staticLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+
     // Draw components
     for (const ComponentRect &comp : m_components) {
         drawComponent(painter, comp);
@@ -189,22 +236,45 @@ void PropulsionPIDWidget::paintEvent(QPaintEvent *event)
     drawLegend(painter);
 }
 
+QPen PropulsionPIDWidget::componentPen(const ComponentRect &comp) const
+{
+    if (comp.type == m_hoveredComponent || comp.type == m_selectedComponent)
+        return QPen(QColor(0, 120, 212), 3); // Blue highlight
+    return QPen(comp.statusColor, 2);
+}
+
+void PropulsionPIDWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    // The legend is anchored to the right edge
+    m_staticLayer = QPixmap();
+}
+
+void PropulsionPIDWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    m_animationTimer->start();
+}
+
+void PropulsionPIDWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    // Also sent when a parent page or dock tab is hidden
+    m_animationTimer->stop();
+}
+
 void PropulsionPIDWidget::drawComponent(QPainter &painter, const ComponentRect &comp)
 {
     painter.save();
 
     // Apply hover/selection effects
-    if (comp.type == m_hoveredComponent || comp.type == m_selectedComponent) {
-        painter.setPen(QPen(QColor(0, 120, 212), 3)); // Blue highlight
-
-        // Add glow effect for hovered items
-        if (comp.type == m_hoveredComponent) {
-            QColor glowColor = QColor(0, 120, 212, 60);
-            painter.setBrush(glowColor);
-            painter.drawRoundedRect(comp.rect.adjusted(-5, -5, 5, 5), 8, 8);
-        }
-    } else {
-        painter.setPen(QPen(comp.statusColor, 2));
+    painter.setPen(componentPen(comp));
+
+    // Add glow effect for hovered items
+    if (comp.type == m_hoveredComponent) {
+        QColor glowColor = QColor(0, 120, 212, 60);
+        painter.setBrush(glowColor);
+        painter.drawRoundedRect(comp.rect.adjusted(-5, -5, 5, 5), 8, 8);
     }
 
     // Draw component based on type
@@ -342,10 +412,25 @@ void PropulsionPIDWidget::drawPropeller(QPainter &painter, const QRect &rect)
     // Move to propeller center
     painter.translate(rect.center());
 
-    // Hub
+    // Hub; the blades are drawn over it every frame
     painter.setBrush(QColor(100, 100, 100));
     painter.drawEllipse(-15, -15, 30, 30);
 
+    painter.restore();
+
+    // Label
+    painter.setPen(Qt::white);
+    painter.drawText(rect.adjusted(0, 90, 0, 0), Qt::AlignCenter, "Propeller");
+    painter.drawText(rect.adjusted(0, 105, 0, 0), Qt::AlignCenter, "75% Pitch");
+}
+
+void PropulsionPIDWidget::drawPropellerBlades(QPainter &painter, const QRect &rect)
+{
+    painter.save();
+
+    // Move to propeller center
+    painter.translate(rect.center());
+
     // Propeller blades
     painter.setBrush(QColor(80, 120, 160));
     for (int i = 0; i < 4; ++i) {
@@ -361,11 +446,6 @@ void PropulsionPIDWidget::drawPropeller(QPainter &painter, const QRect &rect)
     }
 
     painter.restore();
-
-    // Label
-    painter.setPen(Qt::white);
-    painter.drawText(rect.adjusted(0, 90, 0, 0), Qt::AlignCenter, "Propeller");
-    painter.drawText(rect.adjusted(0, 105, 0, 0), Qt::AlignCenter, "75% Pitch");
 }
 
 void PropulsionPIDWidget::drawFlowLine(QPainter &painter, const FlowLine &line)
@@ -476,13 +556,13 @@ void PropulsionPIDWidget::mousePressEvent(QMouseEvent *event)
     if (clickedComponent != None) {
         m_selectedComponent = clickedComponent;
         showComponentDetails(clickedComponent);
-        update();
+        invalidateStaticLayer();
     } else {
         m_selectedComponent = None;
         if (m_detailPopup) {
             m_detailPopup->hide();
         }
-        update();
+        invalidateStaticLayer();
     }
 }
 
@@ -496,14 +576,14 @@ void PropulsionPIDWidget::leaveEvent(QEvent *event)
     Q_UNUSED(event);
     if (m_hoveredComponent != None) {
         m_hoveredComponent = None;
-        update();
+        invalidateStaticLayer();
     }
 }
 
 void PropulsionPIDWidget::updateAnimation()
 {
     m_animationStep = (m_animationStep + 1) % 100;
-    update();
+    update(m_animatedRegion);
 }
 
 PropulsionPIDWidget::ComponentType PropulsionPIDWidget::getComponentAtPosition(const QPoint &pos)
@@ -530,7 +610,7 @@ void PropulsionPIDWidget::updateHoverState(const QPoint &pos)
             setCursor(Qt::ArrowCursor);
         }
 
-        update();
+        invalidateStaticLayer();
     }
 }
 
@@ -91,27 +91,30 @@ public:
     void setEngineData(int index, const EngineData& data) {
         if (index >= 0 && index < 3) {
             m_engineData[index] = data;
-            update();
+            invalidateStaticLayer();
         }
     }
 
     void setPropellerData(const PropellerData& data) {
         m_propellerData = data;
-        update();
+        invalidateStaticLayer();
     }
 
     void setGearboxData(const GearboxData& data) {
         m_gearboxData = data;
-        update();
+        invalidateStaticLayer();
     }
 
     void setFuelTankData(const FuelTankData& data) {
         m_fuelTankData = data;
-        update();
+        invalidateStaticLayer();
     }
 
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void leaveEvent(QEvent *event) override;
@@ -121,6 +124,11 @@ private slots:
     void showComponentDetails(ComponentType component);
 
 private:
+    // Components, labels and legend: everything that does not move
+    void invalidateStaticLayer();
+    void renderStaticLayer();
+    QPen componentPen(const ComponentRect &comp) const;
+
     void setupComponents();
     void setupFlowLines();
     void drawComponent(QPainter &painter, const ComponentRect &comp);
@@ -130,6 +138,7 @@ private:
     void drawGearbox(QPainter &painter, const QRect &rect, const QString &label);
     void drawShaftLine(QPainter &painter, const QRect &rect);
     void drawPropeller(QPainter &painter, const QRect &rect);
+    void drawPropellerBlades(QPainter &painter, const QRect &rect);
     void drawFlowIndicator(QPainter &painter, const QPoint &pos, FlowType type);
     void drawLegend(QPainter &painter);
 
@@ -144,6 +153,12 @@ private:
     ComponentType m_hoveredComponent;
     int m_animationStep;
 
+    // Layers: the static pixmap sits between the flow lines and the
+    // propeller blades; only m_animatedRegion is repainted per frame
+    QPixmap m_staticLayer;
+    QRegion m_animatedRegion;
+    QRect m_propellerRect;
+
     // Detail popup
     QWidget* m_detailPopup;
     QPropertyAnimation* m_popupAnimation;
@@ -0,0 +1,231 @@
+#include "StreamingSeries.h"
+#include <QLineSeries>
+#include <QDateTime>
+#include <QtNumeric>
+
+namespace {
+
+// Flushes at most this often; pushes in between only touch the ring
+const int kFlushIntervalMs = 33;
+
+} // namespace
+
+// ------------------- StreamingSeries -------------------
+
+StreamingSeries::StreamingSeries(QXYSeries* series, int capacity, qint64 windowMs)
+    : m_series(series),
+    m_ring(qMax(1, capacity)),
+    m_head(0),
+    m_count(0),
+    m_windowMs(windowMs),
+    m_pushed(0),
+    m_dirty(false),
+    m_columns(0)
+{
+    m_points.reserve(m_ring.size());
+}
+
+qint64 StreamingSeries::newestMs() const
+{
+    if (m_count == 0)
+        return 0;
+    return qint64(at(m_count - 1).x());
+}
+
+void StreamingSeries::dropOldest()
+{
+    const quint64 oldest = m_pushed - quint64(m_count);
+    if (!m_min.empty() && m_min.front().first == oldest)
+        m_min.pop_front();
+    if (!m_max.empty() && m_max.front().first == oldest)
+        m_max.pop_front();
+    m_head = (m_head + 1) % m_ring.size();
+    --m_count;
+}
+
+void StreamingSeries::push(qint64 timestampMs, double value)
+{
+    if (qIsNaN(value) || (m_count > 0 && timestampMs < newestMs()))
+        return;
+
+    if (m_count == m_ring.size())
+        dropOldest();
+    while (m_count > 0 && at(0).x() < timestampMs - m_windowMs)
+        dropOldest();
+
+    m_ring[(m_head + m_count) % m_ring.size()] = QPointF(timestampMs, value);
+    ++m_count;
+
+    while (!m_min.empty() && m_min.back().second >= value)
+        m_min.pop_back();
+    m_min.emplace_back(m_pushed, value);
+    while (!m_max.empty() && m_max.back().second <= value)
+        m_max.pop_back();
+    m_max.emplace_back(m_pushed, value);
+
+    ++m_pushed;
+    m_dirty = true;
+}
+
+void StreamingSeries::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_min.clear();
+    m_max.clear();
+    m_dirty = true;
+}
+
+void StreamingSeries::setColumns(int columns)
+{
+    if (columns == m_columns)
+        return;
+    m_columns = columns;
+    m_dirty = true;
+}
+
+bool StreamingSeries::flush()
+{
+    if (!m_dirty)
+        return false;
+    m_dirty = false;
+
+    if (m_columns > 0 && m_count > 2 * m_columns) {
+        decimate();
+        m_series->replace(m_points);
+        return true;
+    }
+
+    // The ring unrolled oldest first: at most two contiguous copies
+    m_points.resize(m_count);
+    const int first = qMin(m_count, m_ring.size() - m_head);
+    std::copy(m_ring.constBegin() + m_head, m_ring.constBegin() + m_head + first, m_points.begin());
+    std::copy(m_ring.constBegin(), m_ring.constBegin() + (m_count - first), m_points.begin() + first);
+    m_series->replace(m_points);
+    return true;
+}
+
+void StreamingSeries::decimate()
+{
+    // Columns span the window ending at the newest point, like the axis.
+    // Each column's min and max go out in time order; one point if equal.
+    m_points.clear();
+    const double toX = at(m_count - 1).x();
+    const double fromX = toX - m_windowMs;
+    const double columnWidth = qMax(1.0, double(m_windowMs) / m_columns);
+
+    int i = 0;
+    while (i < m_count) {
+        const int column = qMax(0, int((at(i).x() - fromX) / columnWidth));
+        int low = i, high = i;
+        for (++i; i < m_count && int((at(i).x() - fromX) / columnWidth) <= column; ++i) {
+            if (at(i).y() < at(low).y())
+                low = i;
+            if (at(i).y() > at(high).y())
+                high = i;
+        }
+        m_points.append(at(qMin(low, high)));
+        if (low != high)
+            m_points.append(at(qMax(low, high)));
+    }
+}
+
+// ------------------- StreamingChart -------------------
+
+StreamingChart::StreamingChart(QChart* chart, qint64 windowMs, int capacity, QObject* parent)
+    : QObject(parent),
+    m_chart(chart),
+    m_windowMs(windowMs),
+    m_capacity(capacity),
+    m_columns(0),
+    m_timeAxis(new QDateTimeAxis),
+    m_valueAxis(new QValueAxis),
+    m_flushTimer(new QTimer(this))
+{
+    m_chart->addAxis(m_timeAxis, Qt::AlignBottom);
+    m_chart->addAxis(m_valueAxis, Qt::AlignLeft);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_timeAxis->setRange(QDateTime::fromMSecsSinceEpoch(now - m_windowMs), QDateTime::fromMSecsSinceEpoch(now));
+    m_valueAxis->setRange(0.0, 1.0);
+
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushIntervalMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &StreamingChart::flush);
+    connect(m_chart, &QChart::plotAreaChanged, this, &StreamingChart::onPlotAreaChanged);
+}
+
+StreamingChart::~StreamingChart()
+{
+    for (const auto &entry : m_series)
+        delete entry.second;
+}
+
+StreamingSeries* StreamingChart::series(const QString& name)
+{
+    for (const auto &entry : m_series) {
+        if (entry.first == name)
+            return entry.second;
+    }
+
+    QLineSeries *line = new QLineSeries;
+    line->setName(name);
+    // Points are replaced wholesale; OpenGL keeps large windows cheap to draw
+    line->setUseOpenGL(true);
+    m_chart->addSeries(line);
+    line->attachAxis(m_timeAxis);
+    line->attachAxis(m_valueAxis);
+
+    StreamingSeries *series = new StreamingSeries(line, m_capacity, m_windowMs);
+    series->setColumns(m_columns);
+    m_series.append(qMakePair(name, series));
+    return series;
+}
+
+void StreamingChart::push(const QString& name, qint64 timestampMs, double value)
+{
+    series(name)->push(timestampMs, value);
+    if (!m_flushTimer->isActive())
+        m_flushTimer->start();
+}
+
+void StreamingChart::onPlotAreaChanged(const QRectF& plotArea)
+{
+    const int columns = qRound(plotArea.width());
+    if (columns < 1 || columns == m_columns)
+        return;
+    m_columns = columns;
+    for (const auto &entry : m_series)
+        entry.second->setColumns(columns);
+    if (!m_flushTimer->isActive())
+        m_flushTimer->start();
+}
+
+void StreamingChart::flush()
+{
+    qint64 newest = 0;
+    double low = 0.0, high = 0.0;
+    bool any = false;
+    for (const auto &entry : m_series) {
+        StreamingSeries *series = entry.second;
+        series->flush();
+        if (series->isEmpty())
+            continue;
+        newest = qMax(newest, series->newestMs());
+        low = any ? qMin(low, series->minimum()) : series->minimum();
+        high = any ? qMax(high, series->maximum()) : series->maximum();
+        any = true;
+    }
+    if (!any)
+        return;
+
+    m_timeAxis->setRange(QDateTime::fromMSecsSinceEpoch(newest - m_windowMs),
+                         QDateTime::fromMSecsSinceEpoch(newest));
+
+    const double axisLow = m_valueAxis->min();
+    const double axisHigh = m_valueAxis->max();
+    const double span = qMax(high - low, qMax(qAbs(high), 1.0) * 0.01);
+    const bool outside = low < axisLow || high > axisHigh;
+    const bool loose = span < (axisHigh - axisLow) * 0.5;
+    if (outside || loose)
+        m_valueAxis->setRange(low - span * 0.1, high + span * 0.1);
+}
@@ -0,0 +1,98 @@
+#ifndef STREAMINGSERIES_H
+#define STREAMINGSERIES_H
+
+#include <QObject>
+#include <QVector>
+#include <QList>
+#include <QPointF>
+#include <QTimer>
+#include <QXYSeries>
+#include <QChart>
+#include <QDateTimeAxis>
+#include <QValueAxis>
+#include <deque>
+
+// Last samples of a live signal in a fixed-capacity ring. push() is O(1)
+// (amortised for the running min/max); the QXYSeries only sees the ring
+// when flush() hands it over in a single replace(), so QtCharts lays the
+// series out once per flush instead of once per point. With more points
+// than the plot has pixel columns, flush() hands over each column's min
+// and max instead: at most two points a column, spikes included.
+class StreamingSeries
+{
+public:
+    StreamingSeries(QXYSeries* series, int capacity, qint64 windowMs);
+    Q_DISABLE_COPY(StreamingSeries)
+
+    // NaN samples and samples older than the newest one are dropped
+    void push(qint64 timestampMs, double value);
+    void clear();
+
+    // Replaces the series' points if anything changed since the last flush
+    bool flush();
+
+    // Plot width in pixels; 0 hands over every point
+    void setColumns(int columns);
+
+    QXYSeries* series() const { return m_series; }
+    int count() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+    qint64 newestMs() const;
+    double minimum() const { return m_min.empty() ? 0.0 : m_min.front().second; }
+    double maximum() const { return m_max.empty() ? 0.0 : m_max.front().second; }
+
+private:
+    void dropOldest();
+    const QPointF& at(int index) const { return m_ring.at((m_head + index) % m_ring.size()); }
+    void decimate();
+
+    QXYSeries *m_series;
+    QVector<QPointF> m_ring;
+    int m_head;                 // index of the oldest point
+    int m_count;
+    qint64 m_windowMs;
+    quint64 m_pushed;           // sequence number of the next point
+    bool m_dirty;
+    int m_columns;
+    QList<QPointF> m_points;    // flush buffer, reused
+
+    // Monotonic queues of (sequence, value) for the window's extremes
+    std::deque<std::pair<quint64, double>> m_min;
+    std::deque<std::pair<quint64, double>> m_max;
+};
+
+// Several StreamingSeries on one chart over a sliding time window. Pushes
+// are coalesced into at most one flush per frame; the axes follow the data
+// incrementally: x slides with the newest sample, y widens as soon as a
+// value falls outside it and only narrows once the data uses less than
+// half of it, so most flushes leave the y axis alone.
+class StreamingChart : public QObject
+{
+    Q_OBJECT
+public:
+    StreamingChart(QChart* chart, qint64 windowMs, int capacity, QObject* parent = nullptr);
+    ~StreamingChart();
+
+    // Adds a line series with this name on first use
+    StreamingSeries* series(const QString& name);
+    void push(const QString& name, qint64 timestampMs, double value);
+
+    QDateTimeAxis* timeAxis() const { return m_timeAxis; }
+    QValueAxis* valueAxis() const { return m_valueAxis; }
+
+private slots:
+    void flush();
+    void onPlotAreaChanged(const QRectF& plotArea);
+
+private:
+    QChart *m_chart;
+    qint64 m_windowMs;
+    int m_capacity;
+    int m_columns;
+    QList<QPair<QString, StreamingSeries*>> m_series;
+    QDateTimeAxis *m_timeAxis;
+    QValueAxis *m_valueAxis;
+    QTimer *m_flushTimer;
+};
+
+#endif // STREAMINGSERIES_H
@@ -0,0 +1,429 @@
+#include "StripChart.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QPaintEvent>
+#include <QDateTime>
+#include <QtNumeric>
+#include <QtMath>
+#include <QLoggingCategory>
+
+// Painting cost; enable with QT_LOGGING_RULES="score.stripchart.info=true"
+Q_LOGGING_CATEGORY(lcStripChart, "score.stripchart", QtWarningMsg)
+
+namespace {
+
+const int kLeftMargin = 48;             // y labels
+const int kTopMargin = 18;              // legend with the latest values
+const int kRightMargin = 4;
+const int kBottomMargin = 4;
+const qint64 kMaxGapMs = 30 * 1000;     // samples further apart are not joined
+const qint64 kStatsIntervalMs = 60 * 1000;
+const qint64 kNarrowIntervalMs = 1000;  // how often the range is checked for slack
+const QColor kBackground(45, 45, 45);
+const QColor kGrid(70, 70, 70);
+const QColor kLabel(200, 200, 200);
+
+// Vertical grid spacing: about six lines across the window
+qint64 gridStepMs(qint64 windowMs)
+{
+    static const qint64 steps[] = { 1000, 5000, 10000, 30000, 60000, 300000, 600000, 1800000, 3600000 };
+    for (qint64 step : steps) {
+        if (windowMs / step <= 6)
+            return step;
+    }
+    return 3600000;
+}
+
+} // namespace
+
+// ------------------- StripChartBuffer -------------------
+
+StripChartBuffer::StripChartBuffer(int channels, int capacity)
+    : m_channels(qMax(1, channels)),
+    m_timestamps(qMax(1, capacity)),
+    m_values(qMax(1, capacity) * qMax(1, channels)),
+    m_head(0),
+    m_count(0)
+{
+}
+
+void StripChartBuffer::append(qint64 timestampMs, const QVector<double>& values)
+{
+    if (m_count > 0 && timestampMs < timestampAt(m_count - 1))
+        return;
+
+    int target;
+    if (m_count == m_timestamps.size()) {
+        target = m_head;
+        m_head = (m_head + 1) % m_timestamps.size();
+    } else {
+        target = slot(m_count);
+        ++m_count;
+    }
+    m_timestamps[target] = timestampMs;
+    for (int c = 0; c < m_channels; ++c)
+        m_values[target * m_channels + c] = c < values.size() ? values.at(c) : qQNaN();
+}
+
+int StripChartBuffer::lowerBound(qint64 timestampMs) const
+{
+    int low = 0, high = m_count;
+    while (low < high) {
+        const int mid = (low + high) / 2;
+        if (timestampAt(mid) < timestampMs)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+// ------------------- StripChart -------------------
+
+StripChart::StripChart(const QSharedPointer<StripChartBuffer>& buffer, QWidget *parent)
+    : QWidget(parent),
+    m_buffer(buffer),
+    m_channels(buffer->channelCount()),
+    m_windowMs(10 * 60 * 1000),
+    m_minimum(0.0),
+    m_maximum(1.0),
+    m_endMs(0.0),
+    m_drawnMs(0),
+    m_timer(new QTimer(this)),
+    m_paintNs(0),
+    m_frames(0)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumHeight(120);
+
+    m_timer->setInterval(100);
+    connect(m_timer, &QTimer::timeout, this, &StripChart::advance);
+}
+
+void StripChart::setChannel(int channel, const QString& name, const QColor& color)
+{
+    if (channel < 0 || channel >= m_channels.size())
+        return;
+    m_channels[channel].name = name;
+    m_channels[channel].color = color;
+    m_canvas = QPixmap();
+    update();
+}
+
+void StripChart::setWindow(qint64 windowMs)
+{
+    m_windowMs = qMax<qint64>(windowMs, 1000);
+    m_canvas = QPixmap();
+    update();
+}
+
+void StripChart::setRange(double minimum, double maximum)
+{
+    if (maximum <= minimum)
+        return;
+    m_minimum = minimum;
+    m_maximum = maximum;
+    m_canvas = QPixmap();
+    update();
+}
+
+void StripChart::setUnit(const QString& unit)
+{
+    m_unit = unit;
+    update();
+}
+
+void StripChart::setFrameRate(int hz)
+{
+    m_timer->setInterval(1000 / qBound(1, hz, 60));
+}
+
+QRect StripChart::plotRect() const
+{
+    return rect().adjusted(kLeftMargin, kTopMargin, -kRightMargin, -kBottomMargin);
+}
+
+double StripChart::msPerPixel() const
+{
+    return double(m_windowMs) / qMax(1, m_canvas.width());
+}
+
+double StripChart::xFor(qint64 timestampMs) const
+{
+    return m_canvas.width() - (m_endMs - timestampMs) / msPerPixel();
+}
+
+double StripChart::yFor(double value) const
+{
+    const double h = m_canvas.height() - 1;
+    return h - (value - m_minimum) / (m_maximum - m_minimum) * h;
+}
+
+void StripChart::redraw()
+{
+    const QRect plot = plotRect();
+    if (plot.width() < 1 || plot.height() < 1) {
+        m_canvas = QPixmap();
+        return;
+    }
+
+    fitRange(0);
+    m_canvas = QPixmap(plot.size());
+    m_endMs = QDateTime::currentMSecsSinceEpoch();
+    m_drawnMs = 0;
+    drawFrom(-1.0);
+}
+
+void StripChart::drawFrom(double fromX)
+{
+    // Everything right of fromX is background until repainted here; the
+    // column the last drawn segment ends in is kept
+    const int left = qMax(0, int(qFloor(fromX)) + 1);
+    const QRect dirty(left, 0, m_canvas.width() - left, m_canvas.height());
+    if (dirty.width() <= 0)
+        return;
+
+    QPainter painter(&m_canvas);
+    painter.setClipRect(dirty);
+    painter.fillRect(dirty, kBackground);
+
+    // Grid, at fixed values and on round times so it scrolls with the data
+    painter.setPen(kGrid);
+    for (int i = 1; i < 4; ++i) {
+        const int y = qRound(yFor(m_minimum + (m_maximum - m_minimum) * i / 4.0));
+        painter.drawLine(dirty.left(), y, dirty.right(), y);
+    }
+    const qint64 stepMs = gridStepMs(m_windowMs);
+    const qint64 fromMs = qint64(m_endMs - (m_canvas.width() - left) * msPerPixel());
+    for (qint64 t = (fromMs / stepMs + 1) * stepMs; t <= qint64(m_endMs); t += stepMs) {
+        const int x = qRound(xFor(t));
+        painter.drawLine(x, 0, x, m_canvas.height());
+    }
+
+    // From the last sample already drawn, so the first segment joins up
+    const StripChartBuffer &buffer = *m_buffer;
+    const int first = qMax(0, buffer.lowerBound(fromMs) - 1);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (int c = 0; c < m_channels.size(); ++c) {
+        QPainterPath path;
+        qint64 previousMs = 0;
+        bool joined = false;
+        for (int i = first; i < buffer.size(); ++i) {
+            const double value = buffer.valueAt(i, c);
+            if (qIsNaN(value)) {
+                joined = false;
+                continue;
+            }
+            const qint64 t = buffer.timestampAt(i);
+            const QPointF point(xFor(t), yFor(value));
+            if (joined && t - previousMs <= kMaxGapMs)
+                path.lineTo(point);
+            else
+                path.moveTo(point);
+            previousMs = t;
+            joined = true;
+        }
+        painter.setPen(QPen(m_channels.at(c).color, 1.5));
+        painter.drawPath(path);
+    }
+
+    // Samples past the right edge (clock skew) are drawn again next time
+    const int past = buffer.lowerBound(qint64(m_endMs) + 1);
+    if (past > 0)
+        m_drawnMs = buffer.timestampAt(past - 1);
+}
+
+bool StripChart::fitRange(int fromIndex)
+{
+    const StripChartBuffer &buffer = *m_buffer;
+    auto extent = [&buffer](int from, double *low, double *high) {
+        for (int i = from; i < buffer.size(); ++i) {
+            for (int c = 0; c < buffer.channelCount(); ++c) {
+                const double value = buffer.valueAt(i, c);
+                if (qIsNaN(value))
+                    continue;
+                *low = qMin(*low, value);
+                *high = qMax(*high, value);
+            }
+        }
+    };
+
+    // New samples outside the range widen it straight away
+    double low = m_minimum, high = m_maximum;
+    extent(fromIndex, &low, &high);
+    if (low < m_minimum || high > m_maximum) {
+        const double margin = (high - low) * 0.1;
+        m_minimum = low < m_minimum ? low - margin : m_minimum;
+        m_maximum = high > m_maximum ? high + margin : m_maximum;
+        return true;
+    }
+
+    // Narrowed, like StreamingChart, when the data in the window spans
+    // less than half of it; checked at most once a second since it reads
+    // the whole window
+    if (m_rangeClock.isValid() && m_rangeClock.elapsed() < kNarrowIntervalMs)
+        return false;
+    m_rangeClock.start();
+
+    low = qInf();
+    high = -qInf();
+    extent(buffer.lowerBound(QDateTime::currentMSecsSinceEpoch() - m_windowMs), &low, &high);
+    if (low > high)
+        return false;
+    const double span = qMax(high - low, qMax(qAbs(high), 1.0) * 0.01);
+    if (span >= (m_maximum - m_minimum) * 0.5)
+        return false;
+    m_minimum = low - span * 0.1;
+    m_maximum = high + span * 0.1;
+    return true;
+}
+
+void StripChart::advance()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_canvas.isNull()) {
+        update();
+        return;
+    }
+
+    const int width = m_canvas.width();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int columns = int((now - m_endMs) / msPerPixel());
+    const int fresh = m_buffer->lowerBound(m_drawnMs + 1);
+    const bool hasNew = fresh < m_buffer->size();
+    if (columns <= 0 && !hasNew)
+        return;
+
+    if (columns >= width || (hasNew && fitRange(fresh))) {
+        redraw();
+        update();
+        account(timer.nsecsElapsed(), false);
+        return;
+    }
+
+    if (columns > 0) {
+        m_canvas.scroll(-columns, 0, m_canvas.rect());
+        m_endMs += columns * msPerPixel();
+    }
+
+    // New columns, plus the stretch from the sample the new ones join to
+    double fromX = width - columns - 1;
+    if (hasNew) {
+        const qint64 firstNewMs = m_buffer->timestampAt(fresh);
+        const qint64 joinMs = m_drawnMs > 0 && firstNewMs - m_drawnMs <= kMaxGapMs ? m_drawnMs : firstNewMs;
+        fromX = qMax(-1.0, qMin(fromX, xFor(joinMs) - 1.0));
+    }
+    drawFrom(fromX);
+
+    const QRect plot = plotRect();
+    if (columns > 0) {
+        update(plot);       // scrolled: the whole plot is one blit
+    } else {
+        QRect dirty = plot;
+        dirty.setLeft(plot.left() + qMax(0, int(qFloor(fromX))));
+        update(dirty);
+    }
+    if (hasNew)
+        update(QRect(0, 0, width + kLeftMargin + kRightMargin, kTopMargin));
+    account(timer.nsecsElapsed(), false);
+}
+
+void StripChart::paintEvent(QPaintEvent *event)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_canvas.isNull())
+        redraw();
+
+    QPainter painter(this);
+    const QRect plot = plotRect();
+    const QRect exposed = event->rect();
+
+    if (!m_canvas.isNull() && exposed.intersects(plot)) {
+        const QRect target = exposed & plot;
+        painter.drawPixmap(target, m_canvas, target.translated(-plot.topLeft()));
+    }
+
+    // Margins: y labels and the legend
+    if (!plot.contains(exposed)) {
+        QRegion margins(rect());
+        margins -= plot;
+        painter.setClipRegion(margins & exposed);
+        painter.fillRect(rect(), kBackground.darker(110));
+
+        painter.setPen(kLabel);
+        QFont small = font();
+        small.setPointSizeF(8);
+        painter.setFont(small);
+        for (int i = 0; i <= 4; ++i) {
+            const double value = m_minimum + (m_maximum - m_minimum) * i / 4.0;
+            const int y = plot.top() + qRound(yFor(value));
+            painter.drawText(QRect(0, y - 8, kLeftMargin - 4, 16), Qt::AlignRight | Qt::AlignVCenter,
+                             QString::number(value, 'f', 0));
+        }
+
+        int x = kLeftMargin;
+        const StripChartBuffer &buffer = *m_buffer;
+        for (int c = 0; c < m_channels.size(); ++c) {
+            QString text = m_channels.at(c).name;
+            for (int i = buffer.size() - 1; i >= 0; --i) {
+                if (!qIsNaN(buffer.valueAt(i, c))) {
+                    text += QString(" %1 %2").arg(buffer.valueAt(i, c), 0, 'f', 0).arg(m_unit);
+                    break;
+                }
+            }
+            painter.fillRect(x, 5, 8, 8, m_channels.at(c).color);
+            painter.drawText(x + 12, 0, 160, kTopMargin, Qt::AlignLeft | Qt::AlignVCenter, text);
+            x += 12 + painter.fontMetrics().horizontalAdvance(text) + 16;
+        }
+    }
+
+    account(timer.nsecsElapsed(), true);
+}
+
+void StripChart::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    m_canvas = QPixmap();
+}
+
+void StripChart::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    // Nothing was painted while hidden; start over from the buffer
+    m_canvas = QPixmap();
+    m_statsClock.start();
+    m_paintNs = 0;
+    m_frames = 0;
+    m_timer->start();
+}
+
+void StripChart::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_timer->stop();
+}
+
+void StripChart::account(qint64 ns, bool frame)
+{
+    if (!lcStripChart().isInfoEnabled())
+        return;
+
+    m_paintNs += ns;
+    if (frame)
+        ++m_frames;
+    const qint64 elapsedMs = m_statsClock.elapsed();
+    if (elapsedMs < kStatsIntervalMs)
+        return;
+
+    qCInfo(lcStripChart).noquote() << QString("StripChart: %1 ms CPU per second, %2 frames (%3 us each)")
+                         .arg(m_paintNs / 1e6 / (elapsedMs / 1000.0), 0, 'f', 2)
+                         .arg(m_frames)
+                         .arg(m_paintNs / 1e3 / qMax(1, m_frames), 0, 'f', 0);
+    m_statsClock.restart();
+    m_paintNs = 0;
+    m_frames = 0;
+}
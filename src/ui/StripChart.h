@@ -0,0 +1,109 @@
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+#include <QWidget>
+#include <QVector>
+#include <QPixmap>
+#include <QColor>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
+// Recent samples of a few channels sharing one clock, in a fixed-capacity
+// ring. Written by whoever receives the telemetry and read by any number
+// of StripCharts on the GUI thread.
+class StripChartBuffer
+{
+public:
+    StripChartBuffer(int channels, int capacity);
+
+    // values holds one entry per channel, NaN where a channel has no
+    // sample; samples older than the newest one are dropped
+    void append(qint64 timestampMs, const QVector<double>& values);
+
+    int channelCount() const { return m_channels; }
+    int size() const { return m_count; }
+    // Oldest first
+    qint64 timestampAt(int index) const { return m_timestamps.at(slot(index)); }
+    double valueAt(int index, int channel) const { return m_values.at(slot(index) * m_channels + channel); }
+    // Index of the first sample at or after timestampMs
+    int lowerBound(qint64 timestampMs) const;
+
+private:
+    int slot(int index) const { return (m_head + index) % m_timestamps.size(); }
+
+    int m_channels;
+    QVector<qint64> m_timestamps;
+    QVector<double> m_values;   // row-major, m_channels per sample
+    int m_head;                 // slot of the oldest sample
+    int m_count;
+};
+
+// Scrolling strip chart painted straight from a StripChartBuffer. The plot
+// lives in a pixmap that moves left as time passes: each tick scrolls it
+// by the whole pixel columns elapsed and paints only what is new, from the
+// newest sample already drawn up to now, so a tick costs a few columns
+// whatever the window length. The whole plot is redrawn only on resize,
+// on a range change or after the widget has been hidden.
+//
+// Time spent painting can be logged once a minute as CPU milliseconds per
+// second, the figure to compare against a QChartView showing the same
+// data; the score.stripchart logging category is off by default.
+class StripChart : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit StripChart(const QSharedPointer<StripChartBuffer>& buffer, QWidget *parent = nullptr);
+
+    void setChannel(int channel, const QString& name, const QColor& color);
+    void setWindow(qint64 windowMs);
+    // Widened automatically, with a full redraw, when a sample falls
+    // outside, and narrowed when the window's data spans under half of it
+    void setRange(double minimum, double maximum);
+    void setUnit(const QString& unit);
+    void setFrameRate(int hz);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void advance();
+
+private:
+    struct Channel {
+        QString name;
+        QColor color;
+    };
+
+    QRect plotRect() const;
+    double msPerPixel() const;
+    double xFor(qint64 timestampMs) const;
+    double yFor(double value) const;
+    void redraw();
+    void drawFrom(double fromX);
+    bool fitRange(int fromIndex);
+    void account(qint64 ns, bool frame);
+
+    QSharedPointer<StripChartBuffer> m_buffer;
+    QVector<Channel> m_channels;
+    qint64 m_windowMs;
+    double m_minimum;
+    double m_maximum;
+    QString m_unit;
+
+    QPixmap m_canvas;           // the plot area only
+    double m_endMs;             // time at the canvas' right edge
+    qint64 m_drawnMs;           // newest sample painted on the canvas
+    QTimer *m_timer;
+    QElapsedTimer m_rangeClock; // last check for a range to narrow
+
+    // Painting cost, logged once a minute when enabled
+    QElapsedTimer m_statsClock;
+    qint64 m_paintNs;
+    int m_frames;
+};
+
+#endif // STRIPCHART_H
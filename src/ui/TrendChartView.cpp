@@ -0,0 +1,122 @@
+#include "TrendChartView.h"
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QtMath>
+
+namespace {
+
+// Quiet time before a new window is fetched; a wheel spin is one request
+const int kSettleMs = 150;
+// Narrowest span worth zooming into
+const qint64 kMinSpanMs = 60 * 1000;
+
+} // namespace
+
+TrendChartView::TrendChartView(QChart *chart, QWidget *parent)
+    : QChartView(chart, parent),
+    m_homeFromMs(0),
+    m_homeToMs(0),
+    m_settleTimer(new QTimer(this))
+{
+    setRubberBand(QChartView::HorizontalRubberBand);
+
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(kSettleMs);
+    connect(m_settleTimer, &QTimer::timeout, this, &TrendChartView::settle);
+
+    // A wider or narrower plot needs a different bucket size
+    connect(chart, &QChart::plotAreaChanged, this, [this](const QRectF &plotArea) {
+        if (plotArea.width() >= 1.0)
+            m_settleTimer->start();
+    });
+}
+
+void TrendChartView::setTimeAxis(QDateTimeAxis* axis, qint64 homeFromMs, qint64 homeToMs)
+{
+    m_timeAxis = axis;
+    m_homeFromMs = homeFromMs;
+    m_homeToMs = homeToMs;
+    if (axis)
+        connect(axis, &QDateTimeAxis::rangeChanged, m_settleTimer, QOverload<>::of(&QTimer::start));
+}
+
+void TrendChartView::resetRange()
+{
+    setRange(m_homeFromMs, m_homeToMs);
+}
+
+bool TrendChartView::isHomeRange() const
+{
+    return m_timeAxis && m_timeAxis->min().toMSecsSinceEpoch() == m_homeFromMs
+           && m_timeAxis->max().toMSecsSinceEpoch() == m_homeToMs;
+}
+
+int TrendChartView::columns() const
+{
+    // Before the first layout the plot has no size yet; plotAreaChanged
+    // settles again with the real one
+    const double width = chart()->plotArea().width();
+    return width >= 1.0 ? qRound(width) : 800;
+}
+
+void TrendChartView::setRange(qint64 fromMs, qint64 toMs)
+{
+    if (!m_timeAxis || toMs <= fromMs)
+        return;
+    m_timeAxis->setRange(QDateTime::fromMSecsSinceEpoch(fromMs), QDateTime::fromMSecsSinceEpoch(toMs));
+}
+
+void TrendChartView::settle()
+{
+    if (!m_timeAxis)
+        return;
+    emit rangeSettled(m_timeAxis->min().toMSecsSinceEpoch(), m_timeAxis->max().toMSecsSinceEpoch(), columns());
+}
+
+void TrendChartView::wheelEvent(QWheelEvent *event)
+{
+    if (!m_timeAxis || event->angleDelta().y() == 0) {
+        QChartView::wheelEvent(event);
+        return;
+    }
+
+    const qint64 fromMs = m_timeAxis->min().toMSecsSinceEpoch();
+    const qint64 toMs = m_timeAxis->max().toMSecsSinceEpoch();
+    const qint64 spanMs = toMs - fromMs;
+    const double steps = event->angleDelta().y() / 120.0;
+
+    if (event->modifiers() & Qt::ControlModifier) {
+        // Zoom about the time under the cursor
+        const QRectF plotArea = chart()->plotArea();
+        const double ratio = qBound(0.0, (event->position().x() - plotArea.left()) / plotArea.width(), 1.0);
+        const qint64 pivotMs = fromMs + qint64(spanMs * ratio);
+        const qint64 newSpanMs = qMax(kMinSpanMs, qint64(spanMs * qPow(0.8, steps)));
+        setRange(pivotMs - qint64(newSpanMs * ratio), pivotMs + qint64(newSpanMs * (1.0 - ratio)));
+    } else {
+        // Each notch pans a tenth of the visible span, back in time upwards
+        const qint64 shiftMs = qint64(spanMs * 0.1 * steps);
+        setRange(fromMs - shiftMs, toMs - shiftMs);
+    }
+    event->accept();
+}
+
+void TrendChartView::mouseReleaseEvent(QMouseEvent *event)
+{
+    // The rubber band's zoom-out would step back by a factor; go home instead
+    if (event->button() == Qt::RightButton) {
+        resetRange();
+        event->accept();
+        return;
+    }
+    QChartView::mouseReleaseEvent(event);
+}
+
+void TrendChartView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        resetRange();
+        event->accept();
+        return;
+    }
+    QChartView::mouseDoubleClickEvent(event);
+}
@@ -0,0 +1,50 @@
+#ifndef TRENDCHARTVIEW_H
+#define TRENDCHARTVIEW_H
+
+#include <QChartView>
+#include <QDateTimeAxis>
+#include <QPointer>
+#include <QTimer>
+
+// Chart view for history trends that can be zoomed and panned along time:
+// drag to zoom into a span, wheel to pan, Ctrl+wheel to zoom about the
+// cursor, right click or double click to go back to the full range.
+//
+// The view never touches the data. Once the time range or the plot width
+// has stopped changing it emits rangeSettled with the visible span and the
+// plot's width in pixels, and the owner fetches a window decimated to that
+// width in the background (see TelemetryQuery::bucketForColumns).
+class TrendChartView : public QChartView
+{
+    Q_OBJECT
+public:
+    explicit TrendChartView(QChart *chart, QWidget *parent = nullptr);
+
+    // Axes are rebuilt with the chart's contents, so the view is told again
+    void setTimeAxis(QDateTimeAxis* axis, qint64 homeFromMs, qint64 homeToMs);
+    void resetRange();
+    bool isHomeRange() const;
+
+    int columns() const;
+
+signals:
+    void rangeSettled(qint64 fromMs, qint64 toMs, int columns);
+
+protected:
+    void wheelEvent(QWheelEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private slots:
+    void settle();
+
+private:
+    void setRange(qint64 fromMs, qint64 toMs);
+
+    QPointer<QDateTimeAxis> m_timeAxis;
+    qint64 m_homeFromMs;
+    qint64 m_homeToMs;
+    QTimer *m_settleTimer;
+};
+
+#endif // TRENDCHARTVIEW_H
@@ -0,0 +1,176 @@
+#include "LocalTelemetryBroker.h"
+#include "MqttPacket.h"
+#include <QHostAddress>
+
+namespace {
+
+// Broker-side packets; the client side lives in MqttPacket
+QByteArray frame(quint8 header, const QByteArray& body)
+{
+    QByteArray out;
+    out.append(static_cast<char>(header));
+
+    // Remaining length: 7 bits per byte, high bit means "more bytes follow"
+    int length = body.size();
+    do {
+        quint8 digit = length % 128;
+        length /= 128;
+        if (length > 0)
+            digit |= 0x80;
+        out.append(static_cast<char>(digit));
+    } while (length > 0);
+
+    out.append(body);
+    return out;
+}
+
+QByteArray connAckPacket()
+{
+    QByteArray body;
+    body.append(static_cast<char>(0));      // no session present
+    body.append(static_cast<char>(0));      // accepted
+    return frame(Mqtt::ConnAck, body);
+}
+
+QByteArray subAckPacket(quint16 packetId, quint8 returnCode)
+{
+    QByteArray body;
+    body.append(static_cast<char>((packetId >> 8) & 0xFF));
+    body.append(static_cast<char>(packetId & 0xFF));
+    body.append(static_cast<char>(returnCode));
+    return frame(Mqtt::SubAck, body);
+}
+
+QByteArray publishPacket(const QString& topic, const QByteArray& payload)
+{
+    const QByteArray utf8 = topic.toUtf8();
+    QByteArray body;
+    body.append(static_cast<char>((utf8.size() >> 8) & 0xFF));
+    body.append(static_cast<char>(utf8.size() & 0xFF));
+    body.append(utf8);
+    body.append(payload);
+    return frame(Mqtt::Publish, body);
+}
+
+} // namespace
+
+LocalTelemetryBroker::LocalTelemetryBroker(QObject *parent)
+    : QObject(parent),
+    m_server(new QTcpServer(this)),
+    m_subAckCode(0),
+    m_silent(false),
+    m_connections(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &LocalTelemetryBroker::onNewConnection);
+}
+
+bool LocalTelemetryBroker::listen(quint16 port)
+{
+    return m_server->listen(QHostAddress::LocalHost, port);
+}
+
+void LocalTelemetryBroker::publish(const QString& topic, const QByteArray& payload)
+{
+    const QByteArray packet = publishPacket(topic, payload);
+
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        for (const QString &filter : it.value().filters) {
+            if (topicMatches(filter, topic)) {
+                it.key()->write(packet);
+                break;
+            }
+        }
+    }
+}
+
+bool LocalTelemetryBroker::topicMatches(const QString& filter, const QString& topic)
+{
+    const QStringList filterLevels = filter.split('/');
+    const QStringList topicLevels = topic.split('/');
+
+    for (int i = 0; i < filterLevels.size(); ++i) {
+        if (filterLevels.at(i) == QLatin1String("#"))
+            return true;
+        if (i >= topicLevels.size())
+            return false;
+        if (filterLevels.at(i) != QLatin1String("+") && filterLevels.at(i) != topicLevels.at(i))
+            return false;
+    }
+    return filterLevels.size() == topicLevels.size();
+}
+
+void LocalTelemetryBroker::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        m_clients.insert(socket, Client());
+        ++m_connections;
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            onClientReadyRead(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_clients.remove(socket);
+            socket->deleteLater();
+            emit clientDisconnected();
+        });
+    }
+}
+
+void LocalTelemetryBroker::onClientReadyRead(QTcpSocket* socket)
+{
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end())
+        return;
+
+    // Work on a copy: handling DISCONNECT may remove the client from the hash
+    QByteArray buffer = it->buffer + socket->readAll();
+
+    quint8 header = 0;
+    QByteArray body;
+    while (Mqtt::takePacket(buffer, &header, &body)) {
+        if (!m_silent)
+            handlePacket(socket, header, body);
+    }
+
+    it = m_clients.find(socket);
+    if (it != m_clients.end())
+        it->buffer = buffer;
+}
+
+void LocalTelemetryBroker::handlePacket(QTcpSocket* socket, quint8 header, const QByteArray& body)
+{
+    switch (header & 0xF0) {
+    case Mqtt::Connect:
+        socket->write(connAckPacket());
+        break;
+
+    case Mqtt::Subscribe: {
+        int offset = 0;
+        quint16 packetId = Mqtt::readUInt16(body, &offset);
+        while (offset < body.size()) {
+            QString filter = Mqtt::readString(body, &offset);
+            offset += 1;                        // requested QoS
+            if (filter.isEmpty())
+                break;
+            auto client = m_clients.find(socket);
+            if (client != m_clients.end() && m_subAckCode != 0x80)
+                client->filters.append(filter);
+            emit clientSubscribed(filter);
+        }
+        socket->write(subAckPacket(packetId, m_subAckCode));
+        break;
+    }
+
+    case Mqtt::PingReq:
+        socket->write(frame(Mqtt::PingResp, QByteArray()));
+        break;
+
+    case Mqtt::Disconnect:
+        socket->disconnectFromHost();
+        break;
+
+    default:
+        break;
+    }
+}
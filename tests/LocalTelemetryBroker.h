@@ -0,0 +1,61 @@
+#ifndef LOCALTELEMETRYBROKER_H
+#define LOCALTELEMETRYBROKER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QStringList>
+
+// In-process stand-in for the vessel's MQTT broker (plain TCP, QoS 0).
+// Lets the tests drive TelemetryStreamClient without shipboard hardware:
+// publish recorded frames, refuse subscriptions, or go silent to look
+// like a half-open link.
+class LocalTelemetryBroker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LocalTelemetryBroker(QObject *parent = nullptr);
+
+    bool listen(quint16 port = 0);
+    quint16 serverPort() const { return m_server->serverPort(); }
+
+    // Sends payload to every client subscribed to a matching topic filter
+    void publish(const QString& topic, const QByteArray& payload);
+
+    // Return code for later SUBSCRIBEs; 0x80 refuses them
+    void setSubAckCode(quint8 code) { m_subAckCode = code; }
+
+    // While silent, packets from clients are read and dropped unanswered
+    void setSilent(bool silent) { m_silent = silent; }
+
+    int clientCount() const { return m_clients.size(); }
+    int connectionCount() const { return m_connections; }
+
+    // Topic filter matching with '+' and '#' wildcards
+    static bool topicMatches(const QString& filter, const QString& topic);
+
+signals:
+    void clientSubscribed(const QString& topicFilter);
+    void clientDisconnected();
+
+private slots:
+    void onNewConnection();
+
+private:
+    struct Client {
+        QByteArray buffer;
+        QStringList filters;
+    };
+
+    void onClientReadyRead(QTcpSocket* socket);
+    void handlePacket(QTcpSocket* socket, quint8 header, const QByteArray& body);
+
+    QTcpServer* m_server;
+    QHash<QTcpSocket*, Client> m_clients;
+    quint8 m_subAckCode;
+    bool m_silent;
+    int m_connections;
+};
+
+#endif // LOCALTELEMETRYBROKER_H
@@ -0,0 +1,175 @@
+#include "TelemetryStreamClient.h"
+#include "MockApiService.h"
+#include "LocalTelemetryBroker.h"
+#include <QtTest>
+#include <QDateTime>
+#include <QStandardPaths>
+
+// TelemetryStreamClient against LocalTelemetryBroker on localhost: CONNECT
+// and SUBSCRIBE, a refused subscription, PUBLISH payloads, the keep-alive
+// read timeout and the reconnect after it, and pushed frames reaching
+// MockApiService::dataUpdated within the 200 ms latency budget.
+class TestTelemetryStreamClient : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void connectsAndSubscribes();
+    void refusedSubscriptionDisconnects();
+    void publishReachesClient();
+    void keepAliveTimeoutReconnects();
+    void publishReachesDataUpdated();
+
+private:
+    LocalTelemetryBroker m_broker;
+};
+
+namespace {
+
+const char* const kTopic = "score/voyage/1/telemetry";
+const int kConnectTimeoutMs = 5000;
+const int kLatencyBudgetMs = 200;
+
+// A bare logs-data record stamped now, as the vessel publishes it
+QByteArray liveRecord(double shipSpeed)
+{
+    const QString timestamp = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    return QString("{\"log_id\": 1, \"voyage_id\": \"VOY-1\", \"timestamp\": \"%1\","
+                   " \"ship_speed\": %2, \"course\": 180}")
+        .arg(timestamp)
+        .arg(shipSpeed, 0, 'f', 1)
+        .toUtf8();
+}
+
+} // namespace
+
+void TestTelemetryStreamClient::initTestCase()
+{
+    // MockApiService opens its history under the standard paths
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_broker.listen());
+}
+
+void TestTelemetryStreamClient::cleanup()
+{
+    m_broker.setSubAckCode(0);
+    m_broker.setSilent(false);
+    QTRY_COMPARE_WITH_TIMEOUT(m_broker.clientCount(), 0, kConnectTimeoutMs);
+}
+
+void TestTelemetryStreamClient::connectsAndSubscribes()
+{
+    TelemetryStreamClient client;
+    QSignalSpy connected(&client, &TelemetryStreamClient::connected);
+    QSignalSpy subscribed(&m_broker, &LocalTelemetryBroker::clientSubscribed);
+
+    client.connectToBroker("127.0.0.1", m_broker.serverPort(), kTopic);
+    QVERIFY(connected.wait(kConnectTimeoutMs));
+    QVERIFY(client.isConnected());
+    QCOMPARE(subscribed.count(), 1);
+    QCOMPARE(subscribed.first().first().toString(), QString(kTopic));
+
+    client.disconnectFromBroker();
+}
+
+void TestTelemetryStreamClient::refusedSubscriptionDisconnects()
+{
+    m_broker.setSubAckCode(0x80);
+
+    TelemetryStreamClient client;
+    QSignalSpy connected(&client, &TelemetryStreamClient::connected);
+    QSignalSpy subscribed(&m_broker, &LocalTelemetryBroker::clientSubscribed);
+    QSignalSpy dropped(&m_broker, &LocalTelemetryBroker::clientDisconnected);
+
+    client.connectToBroker("127.0.0.1", m_broker.serverPort(), kTopic);
+    QVERIFY(subscribed.wait(kConnectTimeoutMs));
+    QVERIFY(dropped.wait(kConnectTimeoutMs));
+    QCOMPARE(connected.count(), 0);
+    QVERIFY(!client.isConnected());
+
+    // Otherwise the client keeps retrying in the background
+    client.disconnectFromBroker();
+}
+
+void TestTelemetryStreamClient::publishReachesClient()
+{
+    TelemetryStreamClient client;
+    QSignalSpy connected(&client, &TelemetryStreamClient::connected);
+    QSignalSpy frames(&client, &TelemetryStreamClient::frameReceived);
+
+    client.connectToBroker("127.0.0.1", m_broker.serverPort(), kTopic);
+    QVERIFY(connected.wait(kConnectTimeoutMs));
+
+    const QByteArray payload = liveRecord(12.5);
+    m_broker.publish("score/voyage/2/telemetry", "other vessel");
+    m_broker.publish(kTopic, payload);
+    QVERIFY(frames.wait(kConnectTimeoutMs));
+    QCOMPARE(frames.count(), 1);
+    QCOMPARE(frames.first().first().toByteArray(), payload);
+
+    client.disconnectFromBroker();
+}
+
+void TestTelemetryStreamClient::keepAliveTimeoutReconnects()
+{
+    TelemetryStreamClient client;
+    client.setKeepAliveSecs(1);
+    QSignalSpy connected(&client, &TelemetryStreamClient::connected);
+    QSignalSpy disconnected(&client, &TelemetryStreamClient::disconnected);
+
+    client.connectToBroker("127.0.0.1", m_broker.serverPort(), kTopic);
+    QVERIFY(connected.wait(kConnectTimeoutMs));
+    const int connections = m_broker.connectionCount();
+
+    // No PINGRESP for 1.5 keep-alive intervals: the link is treated as half-open
+    m_broker.setSilent(true);
+    QVERIFY(disconnected.wait(kConnectTimeoutMs));
+    QVERIFY(!client.isConnected());
+
+    m_broker.setSilent(false);
+    QVERIFY(connected.wait(kConnectTimeoutMs));
+    QVERIFY(client.isConnected());
+    QCOMPARE(m_broker.connectionCount(), connections + 1);
+
+    client.disconnectFromBroker();
+}
+
+void TestTelemetryStreamClient::publishReachesDataUpdated()
+{
+    MockApiService *service = MockApiService::instance();
+    QSignalSpy streaming(service, &MockApiService::streamingStateChanged);
+    QSignalSpy updates(service, &MockApiService::dataUpdated);
+
+    // Streaming starts with the first subscriber; a long interval keeps
+    // the HTTPS fallback out of the way
+    service->subscribe(this, MockApiService::Navigation, 600000);
+    service->startStreaming("127.0.0.1", m_broker.serverPort());
+    QVERIFY(streaming.wait(kConnectTimeoutMs));
+    QVERIFY(service->isStreaming());
+
+    qint64 worstMs = 0;
+    for (int i = 0; i < 20; ++i) {
+        updates.clear();
+        QElapsedTimer timer;
+        timer.start();
+        m_broker.publish(kTopic, liveRecord(10.0 + i));
+        QVERIFY(updates.wait(kConnectTimeoutMs));
+        worstMs = qMax(worstMs, timer.elapsed());
+
+        const VoyageLogs data = updates.last().first().value<VoyageLogs>();
+        QCOMPARE(data.ship_speed, 10.0 + i);
+        QVERIFY(service->lastLatencyMs() >= 0);
+        QVERIFY2(service->lastLatencyMs() < kLatencyBudgetMs,
+                 qPrintable(QString("sensor to dataUpdated %1 ms").arg(service->lastLatencyMs())));
+        QTest::qWait(100);
+    }
+    QVERIFY2(worstMs < kLatencyBudgetMs, qPrintable(QString("publish to dataUpdated %1 ms").arg(worstMs)));
+
+    service->unsubscribe(this);
+    service->stopStreaming();
+}
+
+QTEST_GUILESS_MAIN(TestTelemetryStreamClient)
+#include "tst_TelemetryStreamClient.moc"
@@ -0,0 +1,163 @@
+#include "VoyageLogsDecoder.h"
+#include "VoyageLogsCbor.h"
+#include "VoyageLogsJsonReader.h"
+#include <QtTest>
+#include <QCborStreamWriter>
+#include <QJsonDocument>
+
+// Decoding of logs-data payloads, as JSON and as CBOR: envelopes, bare
+// streamed records whatever their key order, and the QJsonDocument fallback.
+class TestVoyageLogsDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void bareRecordKeyOrder_data();
+    void bareRecordKeyOrder();
+    void envelopeAfterOtherKeys_data();
+    void envelopeAfterOtherKeys();
+    void nullMustSpellNull();
+};
+
+namespace {
+
+// A bare record whose log_id is the first, a middle or the last key
+const char* const kBareFirst =
+    "{\"log_id\": 42, \"voyage_id\": \"VOY-1\", \"ship_speed\": 12.5,"
+    " \"propulsion_logs\": [{\"engine_id\": \"ME-1\", \"rpm\": 96}]}";
+const char* const kBareMiddle =
+    "{\"voyage_id\": \"VOY-1\", \"ship_speed\": 12.5, \"log_id\": 42,"
+    " \"propulsion_logs\": [{\"engine_id\": \"ME-1\", \"rpm\": 96}]}";
+const char* const kBareLast =
+    "{\"voyage_id\": \"VOY-1\", \"ship_speed\": 12.5,"
+    " \"propulsion_logs\": [{\"engine_id\": \"ME-1\", \"rpm\": 96}], \"log_id\": 42}";
+
+// Written by hand: a QJsonObject round trip would sort the keys
+QByteArray bareCbor(bool logIdLast)
+{
+    QByteArray out;
+    QCborStreamWriter w(&out);
+    w.startMap();
+    if (!logIdLast) {
+        w.append(QLatin1String("log_id")); w.append(qint64(42));
+    }
+    w.append(QLatin1String("voyage_id"));  w.append(QLatin1String("VOY-1"));
+    w.append(QLatin1String("ship_speed")); w.append(12.5);
+    w.append(QLatin1String("propulsion_logs"));
+    w.startArray(1);
+    w.startMap();
+    w.append(QLatin1String("engine_id")); w.append(QLatin1String("ME-1"));
+    w.append(QLatin1String("rpm"));       w.append(qint64(96));
+    w.endMap();
+    w.endArray();
+    if (logIdLast) {
+        w.append(QLatin1String("log_id")); w.append(qint64(42));
+    }
+    w.endMap();
+    return out;
+}
+
+QByteArray envelopeCbor()
+{
+    QByteArray out;
+    QCborStreamWriter w(&out);
+    w.startMap();
+    w.append(QLatin1String("status")); w.append(QLatin1String("ok"));
+    w.append(QLatin1String("log_id")); w.append(qint64(7));
+    w.append(QLatin1String("data"));
+    w.startArray(2);
+    for (qint64 logId : { 8, 9 }) {
+        w.startMap();
+        w.append(QLatin1String("log_id")); w.append(logId);
+        w.endMap();
+    }
+    w.endArray();
+    w.endMap();
+    return out;
+}
+
+} // namespace
+
+void TestVoyageLogsDecoder::bareRecordKeyOrder_data()
+{
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<int>("format");
+
+    QTest::newRow("json log_id first") << QByteArray(kBareFirst) << int(WireFormat::Json);
+    QTest::newRow("json log_id middle") << QByteArray(kBareMiddle) << int(WireFormat::Json);
+    QTest::newRow("json log_id last") << QByteArray(kBareLast) << int(WireFormat::Json);
+    QTest::newRow("cbor log_id first") << bareCbor(false) << int(WireFormat::Cbor);
+    QTest::newRow("cbor log_id last") << bareCbor(true) << int(WireFormat::Cbor);
+}
+
+void TestVoyageLogsDecoder::bareRecordKeyOrder()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(int, format);
+
+    DecodedVoyageLogs decoded = VoyageLogsDecoder::decode(payload, static_cast<WireFormat>(format));
+    QVERIFY(decoded.ok);
+    QCOMPARE(decoded.records.size(), 1);
+
+    const VoyageLogs &logs = decoded.records.first();
+    QCOMPARE(logs.log_id, 42);
+    QCOMPARE(logs.voyage_id, QStringLiteral("VOY-1"));
+    QCOMPARE(logs.ship_speed, 12.5);
+    QCOMPARE(logs.propulsion_logs.size(), 1);
+    QCOMPARE(logs.propulsion_logs.first().engine_id, QStringLiteral("ME-1"));
+    QCOMPARE(logs.propulsion_logs.first().rpm, 96);
+
+    const MockApiService::Subsystems present = decoded.present.first();
+    QVERIFY(present.testFlag(MockApiService::Navigation));
+    QVERIFY(present.testFlag(MockApiService::Propulsion));
+    QVERIFY(!present.testFlag(MockApiService::Weather));
+
+    // The single-pass reader must agree with the QJsonDocument path
+    if (format == int(WireFormat::Json)) {
+        VoyageLogs reference = VoyageLogsDecoder::parseVoyageLogs(QJsonDocument::fromJson(payload).object());
+        QCOMPARE(logs.log_id, reference.log_id);
+        QCOMPARE(logs.voyage_id, reference.voyage_id);
+        QCOMPARE(logs.propulsion_logs.size(), reference.propulsion_logs.size());
+    }
+}
+
+void TestVoyageLogsDecoder::envelopeAfterOtherKeys_data()
+{
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<int>("format");
+
+    // Envelope members ahead of "data" must not be taken for a bare record
+    const char *json = "{\"status\": \"ok\", \"log_id\": 7,"
+                       " \"data\": [{\"log_id\": 8}, {\"log_id\": 9}]}";
+    QTest::newRow("json") << QByteArray(json) << int(WireFormat::Json);
+    QTest::newRow("cbor") << envelopeCbor() << int(WireFormat::Cbor);
+}
+
+void TestVoyageLogsDecoder::envelopeAfterOtherKeys()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(int, format);
+
+    DecodedVoyageLogs decoded = VoyageLogsDecoder::decode(payload, static_cast<WireFormat>(format));
+    QVERIFY(decoded.ok);
+    QCOMPARE(decoded.records.size(), 2);
+    QCOMPARE(decoded.records.at(0).log_id, 8);
+    QCOMPARE(decoded.records.at(1).log_id, 9);
+}
+
+void TestVoyageLogsDecoder::nullMustSpellNull()
+{
+    const QByteArray valid("{\"log_id\": 1, \"voyage_id\": null}");
+    DecodedVoyageLogs decoded;
+    QVERIFY(VoyageLogsJsonReader(valid).read(&decoded));
+    QCOMPARE(decoded.records.size(), 1);
+    QVERIFY(decoded.records.first().voyage_id.isEmpty());
+
+    // Four bytes starting with 'n' are not a null
+    const QByteArray invalid("{\"log_id\": 1, \"voyage_id\": nope}");
+    DecodedVoyageLogs rejected;
+    QVERIFY(!VoyageLogsJsonReader(invalid).read(&rejected));
+}
+
+QTEST_GUILESS_MAIN(TestVoyageLogsDecoder)
+#include "tst_VoyageLogsDecoder.moc"